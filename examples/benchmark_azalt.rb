@@ -0,0 +1,41 @@
+require 'swe4r'
+require 'benchmark'
+
+#############################
+# CONFIGURATION
+#############################
+
+# Horizontal coordinates of 5000 star positions for one planetarium frame,
+# and of one position at 5000 dates, one by one and in a single call
+N = 5000
+TJD = 2460000.5
+LONGITUDE, LATITUDE, ALTITUDE = 8.55, 47.37, 400
+PRESSURE, TEMPERATURE = 1013.25, 15
+ROUNDS = 10
+
+#############################
+# MAIN
+#############################
+
+rng = Random.new(42)
+xin = Array.new(N) { [rng.rand(360.0), rng.rand(-90.0..90.0), 1.0] }
+packed = xin.flatten.pack('d*')
+tjds = Array.new(N) { |i| TJD + i / 1440.0 }
+packed_tjds = tjds.pack('d*')
+
+[['ecl2hor', Swe4r::SE_ECL2HOR], ['equ2hor', Swe4r::SE_EQU2HOR]].each do |name, flag|
+  single = Benchmark.realtime do
+    ROUNDS.times { xin.each { |x| Swe4r::swe_azalt(TJD, flag, LONGITUDE, LATITUDE, ALTITUDE, PRESSURE, TEMPERATURE, *x) } }
+  end
+  arr = Benchmark.realtime do
+    ROUNDS.times { Swe4r::swe_azalt_arr(TJD, flag, LONGITUDE, LATITUDE, ALTITUDE, PRESSURE, TEMPERATURE, packed) }
+  end
+  single_t = Benchmark.realtime do
+    ROUNDS.times { tjds.each_with_index { |t, i| Swe4r::swe_azalt(t, flag, LONGITUDE, LATITUDE, ALTITUDE, PRESSURE, TEMPERATURE, *xin[i]) } }
+  end
+  times = Benchmark.realtime do
+    ROUNDS.times { Swe4r::swe_azalt_times(packed_tjds, flag, LONGITUDE, LATITUDE, ALTITUDE, PRESSURE, TEMPERATURE, packed) }
+  end
+  puts format('%s: objects %.2f ms -> %.2f ms per frame, times %.2f ms -> %.2f ms per %d dates',
+              name, single * 1000 / ROUNDS, arr * 1000 / ROUNDS, single_t * 1000 / ROUNDS, times * 1000 / ROUNDS, N)
+end
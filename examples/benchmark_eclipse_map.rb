@@ -0,0 +1,38 @@
+require 'swe4r'
+require 'benchmark'
+
+#############################
+# CONFIGURATION
+#############################
+
+# Local circumstances of the total solar eclipse of 2024-04-08 on a grid
+# of OBSERVERS points over North America, in one call and one by one
+FLAGS = Swe4r::SEFLG_MOSEPH
+OBSERVERS = (ARGV[0] || 1_000_000).to_i
+SINGLE = 1000
+STEP = 1.0 / 1440
+
+#############################
+# MAIN
+#############################
+
+event = Swe4r::swe_ecl_when_range(2460401.5, 2460420.5, Swe4r::SE_SUN, FLAGS, 0, 1).first
+side = Math.sqrt(OBSERVERS).ceil
+grid = Array.new(OBSERVERS) { |i| [-130.0 + 70.0 * (i % side) / side, 10.0 + 50.0 * (i / side) / side, 0.0] }
+geopos = grid.flatten.pack('d*')
+
+dret = nil
+time = Benchmark.realtime do
+  dret = Swe4r::swe_sol_eclipse_loc_arr(event[3], event[4], STEP, FLAGS, geopos).unpack('d*')
+end
+eclipsed = (0...OBSERVERS).count { |i| dret[i * 10] > 0 }
+puts format('batch:  %d observers in %.2f s, %.2f us per observer, %d see the eclipse',
+            OBSERVERS, time, time / OBSERVERS * 1e6, eclipsed)
+
+time1 = Benchmark.realtime do
+  grid.first(SINGLE).each do |pos|
+    Swe4r::swe_sol_eclipse_loc_arr(event[3], event[4], STEP, FLAGS, pos.pack('d*'))
+  end
+end
+puts format('single: %d observers in %.2f s, %.2f us per observer, speedup %.1f',
+            SINGLE, time1, time1 / SINGLE * 1e6, (time1 / SINGLE) / (time / OBSERVERS))
@@ -0,0 +1,32 @@
+require 'swe4r'
+require 'benchmark'
+require 'etc'
+
+#############################
+# CONFIGURATION
+#############################
+
+# All solar and lunar eclipses from 1000 BCE to 2000 CE (3000 years),
+# searched with 1, 2, 4, ... threads up to THREADS
+TJD_START = Swe4r::swe_julday(-999, 1, 1, 0.0)
+TJD_END = Swe4r::swe_julday(2001, 1, 1, 0.0)
+FLAGS = Swe4r::SEFLG_MOSEPH
+THREADS = (ARGV[0] || 16).to_i
+
+#############################
+# MAIN
+#############################
+
+puts format('%d processors', Etc.nprocessors)
+base = nil
+n = 1
+while n <= THREADS
+  events = nil
+  time = Benchmark.realtime do
+    events = Swe4r::swe_ecl_when_range(TJD_START, TJD_END, Swe4r::SE_SUN, FLAGS, 0, n) +
+             Swe4r::swe_ecl_when_range(TJD_START, TJD_END, Swe4r::SE_MOON, FLAGS, 0, n)
+  end
+  base ||= time
+  puts format('%2d threads: %d eclipses in %.2f s, speedup %.2f', n, events.size, time, base / time)
+  n *= 2
+end
@@ -0,0 +1,51 @@
+require 'swe4r'
+require 'benchmark'
+require 'etc'
+
+#############################
+# CONFIGURATION
+#############################
+
+# Gauquelin sectors from rising and setting (disc center, with refraction)
+# of the sun, moon and planets for a set of birth records, body by body
+# and in one call
+FLAGS = Swe4r::SEFLG_MOSEPH
+METHOD = 3
+BODIES = (Swe4r::SE_SUN..Swe4r::SE_PLUTO).to_a
+START = 2420000.5
+RECORDS = 200
+THREADS = Etc.nprocessors
+
+#############################
+# MAIN
+#############################
+
+dates = (0...RECORDS).map { |i| START + i * 97.123 }
+# latitudes from 60 S to 66 N, so that some records need the slow method
+places = (0...RECORDS).map { |i| [-120 + i * 7.3 % 240, -60 + i * 13.7 % 126, (i % 5) * 100.0] }
+
+single = Benchmark.realtime do
+  dates.each_with_index do |tjd, i|
+    BODIES.each do |ipl|
+      begin
+        Swe4r::swe_gauquelin_sector(tjd, ipl, FLAGS, METHOD, *places[i], 0, 10)
+      rescue RuntimeError
+        # circumpolar
+      end
+    end
+  end
+end
+
+packed_dates = dates.pack('d*')
+packed_places = places.flatten.pack('d*')
+batch = Benchmark.realtime do
+  Swe4r::swe_gauquelin_sector_arr(packed_dates, packed_places, BODIES, FLAGS, METHOD, 0, 10, 1)
+end
+threaded = Benchmark.realtime do
+  Swe4r::swe_gauquelin_sector_arr(packed_dates, packed_places, BODIES, FLAGS, METHOD, 0, 10, THREADS)
+end
+
+puts format('%d records x %d bodies', RECORDS, BODIES.size)
+puts format('swe_gauquelin_sector                   %8.1f ms', single * 1000)
+puts format('swe_gauquelin_sector_arr, 1 thread     %8.1f ms', batch * 1000)
+puts format('swe_gauquelin_sector_arr, %2d threads   %8.1f ms', THREADS, threaded * 1000)
@@ -0,0 +1,43 @@
+require 'swe4r'
+require 'benchmark'
+
+#############################
+# CONFIGURATION
+#############################
+
+# Heliacal events of the planets and the moon at Zurich from 2024 on,
+# with the time breakdown and memo statistics of each search
+FLAGS = Swe4r::SEFLG_MOSEPH
+START = 2460310.5
+LONGITUDE, LATITUDE, ALTITUDE = 8.55, 47.37, 400
+DATM = [1013.25, 15, 40, 0]
+DOBS = [36, 1]
+EVENTS = {
+  'venus' => [1, 2], 'mercury' => [1, 2], 'mars' => [1, 2],
+  'jupiter' => [1, 2], 'saturn' => [1, 2], 'moon' => [3, 4]
+}
+
+#############################
+# MAIN
+#############################
+
+puts format('%-8s %2s %14s %7s %7s %7s %7s %11s %11s %11s %11s',
+            'object', 'ev', 'tjd', 'ms', 'conj', 'day', 'details',
+            'vislim', 'loc', 'mag', 'sky')
+total = Benchmark.realtime do
+  EVENTS.each do |name, types|
+    types.each do |type|
+      dret = Swe4r::swe_heliacal_ut(START, LONGITUDE, LATITUDE, ALTITUDE, name, type, FLAGS, DATM, DOBS)
+      s = Swe4r::swe_heliacal_stats.map { |x| x.round(4) }
+      puts format('%-8s %2d %14.6f %7.1f %7.1f %7.1f %7.1f %5d/%5d %5d/%5d %5d/%5d %5d/%5d',
+                  name, type, dret[0],
+                  s[Swe4r::SE_HELSTAT_TIME] * 1000, s[Swe4r::SE_HELSTAT_TIME_CONJ] * 1000,
+                  s[Swe4r::SE_HELSTAT_TIME_DAY] * 1000, s[Swe4r::SE_HELSTAT_TIME_DETAILS] * 1000,
+                  s[Swe4r::SE_HELSTAT_NVISLIM_MEMO], s[Swe4r::SE_HELSTAT_NVISLIM],
+                  s[Swe4r::SE_HELSTAT_NLOC_MEMO], s[Swe4r::SE_HELSTAT_NLOC],
+                  s[Swe4r::SE_HELSTAT_NMAG_MEMO], s[Swe4r::SE_HELSTAT_NMAG],
+                  s[Swe4r::SE_HELSTAT_NSKY_MEMO], s[Swe4r::SE_HELSTAT_NSKY])
+    end
+  end
+end
+puts format('%d events in %.3f s', EVENTS.values.sum(&:size), total)
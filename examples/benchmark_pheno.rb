@@ -0,0 +1,33 @@
+require 'swe4r'
+require 'benchmark'
+
+#############################
+# CONFIGURATION
+#############################
+
+# Phase angle, phase, elongation, diameter, magnitude and parallax of the
+# sun, moon and planets for a series of charts, body by body and in one call
+FLAGS = Swe4r::SEFLG_MOSEPH
+BODIES = (Swe4r::SE_SUN..Swe4r::SE_PLUTO).to_a
+START = 2460310.5
+CHARTS = 1000
+
+#############################
+# MAIN
+#############################
+
+dates = (0...CHARTS).map { |i| START + i * 0.37 }
+
+single = Benchmark.realtime do
+  dates.each do |tjd|
+    BODIES.each { |ipl| Swe4r::swe_pheno_ut(tjd, ipl, FLAGS) }
+  end
+end
+
+batch = Benchmark.realtime do
+  dates.each { |tjd| Swe4r::swe_pheno_ut_arr(tjd, BODIES, FLAGS) }
+end
+
+puts format('%d charts x %d bodies', CHARTS, BODIES.size)
+puts format('swe_pheno_ut      %8.1f ms', single * 1000)
+puts format('swe_pheno_ut_arr  %8.1f ms', batch * 1000)
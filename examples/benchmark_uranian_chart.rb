@@ -0,0 +1,49 @@
+require 'swe4r'
+require 'benchmark'
+require 'tmpdir'
+
+#############################
+# CONFIGURATION
+#############################
+
+# A Uranian chart: Sun, Moon, lunar node, the eight Uranian planets
+# and Isis-Transpluto, i.e. 12 bodies, with speeds
+BODIES = [Swe4r::SE_SUN, Swe4r::SE_MOON, Swe4r::SE_MEAN_NODE] + (Swe4r::SE_CUPIDO..Swe4r::SE_POSEIDON).to_a + [Swe4r::SE_POSEIDON + 1]
+FLAGS = Swe4r::SEFLG_MOSEPH | Swe4r::SEFLG_SPEED
+CHARTS = 20_000
+
+# Elements of the fictitious bodies (Neely's Uranian planets), in the
+# format of seorbel.txt. Vulcan has T terms in the mean anomaly.
+SEORBEL = <<~ELEMENTS
+  # epoch, equinox, mean anomaly, semi-axis, eccentricity, perihelion, node, inclination, name
+  J1900, J1900, 163.7409, 40.99837, 0.00460, 171.4333, 129.8325, 1.0833, Cupido
+  J1900, J1900,  27.6496, 50.66744, 0.00245, 148.1796, 161.3339, 1.0500, Hades
+  J1900, J1900, 165.1232, 59.21436, 0.00120, 299.0440,   0.0000, 0.0000, Zeus
+  J1900, J1900, 169.0193, 64.81960, 0.00305, 208.8801,   0.0000, 0.0000, Kronos
+  J1900, J1900, 138.0533, 70.29949, 0.00000,   0.0000,   0.0000, 0.0000, Apollon
+  J1900, J1900, 351.3350, 73.62765, 0.00000,   0.0000,   0.0000, 0.0000, Admetos
+  J1900, J1900,  55.8983, 77.25568, 0.00000,   0.0000,   0.0000, 0.0000, Vulkanus
+  J1900, J1900, 165.5163, 83.66907, 0.00000,   0.0000,   0.0000, 0.0000, Poseidon
+  2368547.66, 2431456.5, 0.0, 77.775, 0.3, 0.7, 0, 0, Isis-Transpluto
+  J1900, JDATE, 252.8987988 + 707550.7341 * T, 0.13744, 0.019, 322.212069+1670.056*T, 47.787931-1670.056*T, 7.5, Vulcan
+ELEMENTS
+
+#############################
+# MAIN
+#############################
+
+Dir.mktmpdir do |dir|
+  File.write(File.join(dir, 'seorbel.txt'), SEORBEL)
+  Swe4r::swe_set_ephe_path(dir)
+
+  pos = Swe4r::Position.new
+  jd = Swe4r::swe_julday(2012, 5, 14, 10.15)
+  time = Benchmark.realtime do
+    CHARTS.times do |i|
+      BODIES.each { |body| Swe4r::swe_calc_ut_into(jd + i * 0.01, body, FLAGS, pos) }
+    end
+  end
+
+  puts format('%d charts of %d bodies: %.3f s, %.2f us per chart, %.3f us per body',
+              CHARTS, BODIES.size, time, time / CHARTS * 1e6, time / CHARTS / BODIES.size * 1e6)
+end
@@ -1,3 +1,11 @@
 require 'mkmf'
+require_relative 'gen_tables'
+
+# leap seconds and delta t are compiled in, see gen_tables.rb
+Swe4rTables.generate(File.dirname(File.expand_path(__FILE__)), Dir.pwd)
+$defs.push("-DSE_BUILTIN_TABLES")
+
+# the file path cache in sweph.c is shared between threads
+have_library("pthread")
 
 create_makefile("swe4r/swe4r")
@@ -0,0 +1,89 @@
+# Swe4r :: Swiss Ephemeris for Ruby
+#
+# Compiles the leap second and Delta T tables into C headers, so that the
+# library does not have to read them from the ephemeris path at runtime:
+#
+#   seleapsec.txt                  -> seleapsec.h
+#   swe_deltat.txt or sedeltat.txt -> sedeltat.h
+#
+# The input files have the same format as the files read by init_leapsec()
+# in swedate.c and init_dt() in swephlib.c. Missing input files give empty
+# tables, and leap seconds that the leap_seconds[] table of swedate.c
+# already has are left out. The Delta T values are not compared with the
+# dt[] table of swephlib.c; they replace its entries for the same years.
+# With SE_BUILTIN_TABLES, which extconf.rb always defines, the library
+# uses its own tables plus these and reads the files only after
+# swe_set_read_table_files(TRUE). generate() returns the number of
+# entries written. Called by extconf.rb; can also be run by hand:
+#
+#   ruby gen_tables.rb [source_dir [output_dir]]
+
+module Swe4rTables
+  module_function
+
+  # lines of a table file, without comments and empty lines
+  def records(path)
+    return [] unless path && File.exist?(path)
+    File.readlines(path).map(&:strip).reject { |l| l.empty? || l.start_with?('#') }
+  end
+
+  def leap_seconds(path)
+    records(path).map { |l| l.to_i }.select { |d| d > 0 }.sort.uniq
+  end
+
+  # dates of the leap_seconds[] table in swedate.c
+  def compiled_leap_seconds(swedate_c)
+    return [] unless File.exist?(swedate_c)
+    table = File.read(swedate_c)[/leap_seconds\[NLEAP_SECONDS_SPACE\] = \{(.*?)\}/m, 1]
+    table ? table.scan(/\b\d{8}\b/).map(&:to_i) : []
+  end
+
+  def delta_t(path)
+    records(path).map { |l| y, dt = l.split; [y.to_i, Float(dt)] }
+  end
+
+  def header(name, src)
+    "/* #{name}: generated by gen_tables.rb from #{src ? File.basename(src) : '(no file)'}, do not edit */\n"
+  end
+
+  def write_leap_seconds(src, out, compiled = [])
+    last = compiled.max || 0
+    dates = leap_seconds(src).select { |d| d > last }
+    File.open(out, 'w') do |f|
+      f << header(File.basename(out), src)
+      f << "#define SWI_BUILTIN_NLEAPSEC #{dates.size}\n"
+      f << "static const int swi_builtin_leapsec[#{[dates.size, 1].max}] = {\n"
+      dates.each_slice(6) { |s| f << "  " << s.join(', ') << ",\n" }
+      f << "  0\n" if dates.empty?
+      f << "};\n"
+    end
+    dates.size
+  end
+
+  def write_delta_t(src, out)
+    values = delta_t(src)
+    File.open(out, 'w') do |f|
+      f << header(File.basename(out), src)
+      f << "#define SWI_BUILTIN_NDELTAT #{values.size}\n"
+      f << "/* year, delta t in seconds */\n"
+      f << "static const double swi_builtin_deltat[#{[values.size, 1].max}][2] = {\n"
+      values.each { |y, dt| f << "  {#{y}, #{dt}},\n" }
+      f << "  {0, 0}\n" if values.empty?
+      f << "};\n"
+    end
+    values.size
+  end
+
+  def generate(src_dir, out_dir)
+    dt_src = %w[swe_deltat.txt sedeltat.txt].map { |n| File.join(src_dir, n) }.find { |p| File.exist?(p) }
+    ls_src = File.join(src_dir, 'seleapsec.txt')
+    compiled = compiled_leap_seconds(File.join(File.dirname(File.expand_path(__FILE__)), 'swedate.c'))
+    n = write_leap_seconds(File.exist?(ls_src) ? ls_src : nil, File.join(out_dir, 'seleapsec.h'), compiled)
+    n + write_delta_t(dt_src, File.join(out_dir, 'sedeltat.h'))
+  end
+end
+
+if __FILE__ == $0
+  src_dir = ARGV[0] || File.dirname(File.expand_path(__FILE__))
+  Swe4rTables.generate(src_dir, ARGV[1] || src_dir)
+end
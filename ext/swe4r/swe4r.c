@@ -22,11 +22,171 @@ along with Swe4r.  If not, see <http://www.gnu.org/licenses/>.
 
 // https://docs.ruby-lang.org/en/3.0/extension_rdoc.html
 #include <ruby.h> 
+#include <ruby/thread.h>
 #include "swephexp.h"
+#include "sweephe4.h"
 
 // Module Name
 VALUE rb_mSwe4r = Qnil;
 
+// Classes for the allocation-free *_into functions
+VALUE rb_cPosition = Qnil;
+VALUE rb_cHouses = Qnil;
+
+/*
+ * Swe4r::Position holds the 6 doubles written by swe_calc_ut_into and swe_azalt_into.
+ * It is allocated once and refilled by every call, so that a hot loop allocates no Ruby objects.
+ */
+struct swe4r_position {
+	double x[6];
+};
+
+static size_t position_memsize(const void *ptr)
+{
+	return sizeof(struct swe4r_position);
+}
+
+static const rb_data_type_t position_type = {
+	"Swe4r::Position",
+	{NULL, RUBY_TYPED_DEFAULT_FREE, position_memsize,},
+	0, 0,
+	RUBY_TYPED_FREE_IMMEDIATELY,
+};
+
+static VALUE position_alloc(VALUE klass)
+{
+	struct swe4r_position *pos;
+	return TypedData_Make_Struct(klass, struct swe4r_position, &position_type, pos);
+}
+
+static double *position_ptr(VALUE self)
+{
+	struct swe4r_position *pos;
+	TypedData_Get_Struct(self, struct swe4r_position, &position_type, pos);
+	return pos->x;
+}
+
+#define POSITION_ACCESSOR(name, i) \
+	static VALUE position_##name(VALUE self) { return DBL2NUM(position_ptr(self)[i]); } \
+	static VALUE position_set_##name(VALUE self, VALUE v) { position_ptr(self)[i] = NUM2DBL(v); return v; }
+
+POSITION_ACCESSOR(lon, 0)
+POSITION_ACCESSOR(lat, 1)
+POSITION_ACCESSOR(dist, 2)
+POSITION_ACCESSOR(lon_speed, 3)
+POSITION_ACCESSOR(lat_speed, 4)
+POSITION_ACCESSOR(dist_speed, 5)
+
+static VALUE position_aref(VALUE self, VALUE index)
+{
+	int i = NUM2INT(index);
+	if (i < 0 || i >= 6)
+		rb_raise(rb_eIndexError, "index %d outside of position", i);
+	return DBL2NUM(position_ptr(self)[i]);
+}
+
+static VALUE position_to_a(VALUE self)
+{
+	double *x = position_ptr(self);
+	VALUE output = rb_ary_new_capa(6);
+	for (int i = 0; i < 6; i++)
+		rb_ary_push(output, DBL2NUM(x[i]));
+	return output;
+}
+
+/*
+ * Swe4r::Houses holds the cusps and ascmc arrays (and their speeds) written by swe_houses_into and swe_houses_ex2_into.
+ * There is room for the 36 Gauquelin sectors of house system 'G'.
+ */
+struct swe4r_houses {
+	double cusps[37];
+	double ascmc[10];
+	double cusps_speed[37];
+	double ascmc_speed[10];
+	int ncusps;
+};
+
+static size_t houses_memsize(const void *ptr)
+{
+	return sizeof(struct swe4r_houses);
+}
+
+static const rb_data_type_t houses_type = {
+	"Swe4r::Houses",
+	{NULL, RUBY_TYPED_DEFAULT_FREE, houses_memsize,},
+	0, 0,
+	RUBY_TYPED_FREE_IMMEDIATELY,
+};
+
+static VALUE houses_alloc(VALUE klass)
+{
+	struct swe4r_houses *h;
+	VALUE obj = TypedData_Make_Struct(klass, struct swe4r_houses, &houses_type, h);
+	h->ncusps = 12;
+	return obj;
+}
+
+static struct swe4r_houses *houses_ptr(VALUE self)
+{
+	struct swe4r_houses *h;
+	TypedData_Get_Struct(self, struct swe4r_houses, &houses_type, h);
+	return h;
+}
+
+static int houses_index(struct swe4r_houses *h, VALUE index, int n)
+{
+	int i = NUM2INT(index);
+	if (i < 0 || i > n)
+		rb_raise(rb_eIndexError, "index %d outside of 0..%d", i, n);
+	return i;
+}
+
+// cusp(1) .. cusp(12), or cusp(36) for house system 'G'
+static VALUE houses_cusp(VALUE self, VALUE index)
+{
+	struct swe4r_houses *h = houses_ptr(self);
+	return DBL2NUM(h->cusps[houses_index(h, index, h->ncusps)]);
+}
+
+static VALUE houses_cusp_speed(VALUE self, VALUE index)
+{
+	struct swe4r_houses *h = houses_ptr(self);
+	return DBL2NUM(h->cusps_speed[houses_index(h, index, h->ncusps)]);
+}
+
+// ascmc(0) .. ascmc(9), see SE_ASC, SE_MC, ...
+static VALUE houses_ascmc(VALUE self, VALUE index)
+{
+	struct swe4r_houses *h = houses_ptr(self);
+	return DBL2NUM(h->ascmc[houses_index(h, index, 9)]);
+}
+
+static VALUE houses_ascmc_speed(VALUE self, VALUE index)
+{
+	struct swe4r_houses *h = houses_ptr(self);
+	return DBL2NUM(h->ascmc_speed[houses_index(h, index, 9)]);
+}
+
+static VALUE houses_asc(VALUE self)
+{
+	return DBL2NUM(houses_ptr(self)->ascmc[SE_ASC]);
+}
+
+static VALUE houses_mc(VALUE self)
+{
+	return DBL2NUM(houses_ptr(self)->ascmc[SE_MC]);
+}
+
+// cusps as an Array like swe_houses returns, i.e. with cusps[0] = 0
+static VALUE houses_cusps(VALUE self)
+{
+	struct swe4r_houses *h = houses_ptr(self);
+	VALUE output = rb_ary_new_capa(h->ncusps + 1);
+	for (int i = 0; i <= h->ncusps; i++)
+		rb_ary_push(output, DBL2NUM(h->cusps[i]));
+	return output;
+}
+
 /*
  * Set directory path of ephemeris files
  * http://www.astro.com/swisseph/swephprg.htm#_Toc283735481
@@ -49,6 +209,46 @@ static VALUE t_swe_set_jpl_file(VALUE self, VALUE path)
 	return Qnil;
 }
 
+/*
+ * Get the name of a planet, asteroid or fictitious body
+ * http://www.astro.com/swisseph/swephprg.htm#_Toc283735447
+	char* swe_get_planet_name(
+		int ipl,	// planet number
+		char* spname	// return area for name, at least AS_MAXCH chars
+	);
+ */
+static VALUE t_swe_get_planet_name(VALUE self, VALUE body)
+{
+	char name[AS_MAXCH];
+	swe_get_planet_name(NUM2INT(body), name);
+	return rb_str_new_cstr(name);
+}
+
+/*
+ * Get the names of an array of bodies
+	void swe_get_planet_name_arr(
+		int *ipl,	// planet numbers
+		int32 n,	// number of bodies
+		char *spname	// return area for names, n * AS_MAXCH chars
+	);
+ */
+static VALUE t_swe_get_planet_name_arr(VALUE self, VALUE bodies)
+{
+	VALUE list = rb_Array(bodies), buf_ipl, buf_names;
+	long n = RARRAY_LEN(list);
+	int *ipl = ALLOCV_N(int, buf_ipl, n);
+	char *names = ALLOCV_N(char, buf_names, n * AS_MAXCH);
+	VALUE output = rb_ary_new_capa(n);
+	for (long i = 0; i < n; i++)
+		ipl[i] = NUM2INT(rb_ary_entry(list, i));
+	swe_get_planet_name_arr(ipl, (int32) n, names);
+	for (long i = 0; i < n; i++)
+		rb_ary_push(output, rb_str_new_cstr(names + i * AS_MAXCH));
+	ALLOCV_END(buf_ipl);
+	ALLOCV_END(buf_names);
+	return output;
+}
+
 /*
  * Get the Julian day number from year, month, day, hour
  * http://www.astro.com/swisseph/swephprg.htm#_Toc283735468
@@ -104,6 +304,81 @@ static VALUE t_swe_revjul(int argc, VALUE *argv, VALUE self) {
 	return output;
 }
 
+/*
+ * Array versions of the date conversion functions
+ * Dates and Julian day numbers are passed in and out as packed Strings of native doubles,
+ * see Array#pack('d*') and String#unpack('d*'). Records are:
+ *   date: year, month, day, hour
+ *   utc:  year, month, day, hour, minute, second
+ */
+static long packed_count(VALUE packed, long stride)
+{
+	long len = RSTRING_LEN(packed);
+	if (len % (stride * (long) sizeof(double)) != 0)
+		rb_raise(rb_eArgError, "packed string length must be a multiple of %ld doubles", stride);
+	return len / (stride * (long) sizeof(double));
+}
+
+static int optional_greg_flag(int argc, VALUE *argv)
+{
+	if (argc > 2 || argc < 1)
+	{ // there should only be 1 or 2 arguments
+		rb_raise(rb_eArgError, "wrong number of arguments");
+	}
+	StringValue(argv[0]);
+	return (argc == 2) ? NUM2INT(argv[1]) : SE_GREG_CAL;
+}
+
+/*
+ * void swe_julday_arr(double *date, int32 n, int gregflag, double *tjd);
+ */
+static VALUE t_swe_julday_arr(int argc, VALUE *argv, VALUE self)
+{
+	int greg_flag = optional_greg_flag(argc, argv);
+	long n = packed_count(argv[0], 4);
+	VALUE output = rb_str_new(NULL, n * sizeof(double));
+	swe_julday_arr((double *) RSTRING_PTR(argv[0]), (int32) n, greg_flag, (double *) RSTRING_PTR(output));
+	return output;
+}
+
+/*
+ * void swe_revjul_arr(double *tjd, int32 n, int gregflag, double *date);
+ */
+static VALUE t_swe_revjul_arr(int argc, VALUE *argv, VALUE self)
+{
+	int greg_flag = optional_greg_flag(argc, argv);
+	long n = packed_count(argv[0], 1);
+	VALUE output = rb_str_new(NULL, n * 4 * sizeof(double));
+	swe_revjul_arr((double *) RSTRING_PTR(argv[0]), (int32) n, greg_flag, (double *) RSTRING_PTR(output));
+	return output;
+}
+
+/*
+ * int32 swe_utc_to_jd_arr(double *utc, int32 n, int32 gregflag, double *dret, char *serr);
+ * Returns pairs of Julian day numbers ET and UT1; both are 0.0 for invalid dates.
+ */
+static VALUE t_swe_utc_to_jd_arr(int argc, VALUE *argv, VALUE self)
+{
+	int greg_flag = optional_greg_flag(argc, argv);
+	long n = packed_count(argv[0], 6);
+	VALUE output = rb_str_new(NULL, n * 2 * sizeof(double));
+	char serr[AS_MAXCH];
+	swe_utc_to_jd_arr((double *) RSTRING_PTR(argv[0]), (int32) n, greg_flag, (double *) RSTRING_PTR(output), serr);
+	return output;
+}
+
+/*
+ * void swe_jdet_to_utc_arr(double *tjd_et, int32 n, int32 gregflag, double *utc);
+ */
+static VALUE t_swe_jdet_to_utc_arr(int argc, VALUE *argv, VALUE self)
+{
+	int greg_flag = optional_greg_flag(argc, argv);
+	long n = packed_count(argv[0], 1);
+	VALUE output = rb_str_new(NULL, n * 6 * sizeof(double));
+	swe_jdet_to_utc_arr((double *) RSTRING_PTR(argv[0]), (int32) n, greg_flag, (double *) RSTRING_PTR(output));
+	return output;
+}
+
 /*
  * Set the geographic location for topocentric planet computation
  * The longitude and latitude must be in degrees, the altitude in meters.
@@ -120,6 +395,82 @@ static VALUE t_swe_set_topo(VALUE self, VALUE lon, VALUE lat, VALUE alt)
 	return Qnil;
 }
 
+/*
+ * Interpolate Delta T from a precomputed spline table instead of evaluating the Delta T model on every call
+ * The table is made once per thread for the current Delta T model and tidal acceleration.
+	void swe_set_interpolate_deltat(
+		AS_BOOL do_interpolate	// TRUE: use spline table, FALSE: use model (default)
+	);
+ */
+static VALUE t_swe_set_interpolate_deltat(VALUE self, VALUE do_interpolate)
+{
+	swe_set_interpolate_deltat(RTEST(do_interpolate) ? TRUE : FALSE);
+	return Qnil;
+}
+
+/*
+ * Set the number of swe_calc() results kept per thread, in a set-associative cache with LRU replacement
+	void swe_set_calc_cache(
+		int32 nentries	// 0: no cache, < 0: default
+	);
+ */
+static VALUE t_swe_set_calc_cache(VALUE self, VALUE nentries)
+{
+	swe_set_calc_cache(NUM2INT(nentries));
+	return Qnil;
+}
+
+/*
+ * Interpolate the sun and the moon in the refinement loops of the eclipse and occultation searches
+	void swe_set_interpolate_ecl(
+		AS_BOOL do_interpolate	// TRUE: fit Chebyshev series over a few hours, FALSE: call swe_calc() each time (default)
+	);
+ */
+static VALUE t_swe_set_interpolate_ecl(VALUE self, VALUE do_interpolate)
+{
+	swe_set_interpolate_ecl(RTEST(do_interpolate) ? TRUE : FALSE);
+	return Qnil;
+}
+
+/*
+ * Read seleapsec.txt and swe_deltat.txt from the ephemeris path instead of using only the built-in tables
+	void swe_set_read_table_files(
+		AS_BOOL do_read		// TRUE: read files on next use, FALSE: built-in tables only (default)
+	);
+ */
+static VALUE t_swe_set_read_table_files(VALUE self, VALUE do_read)
+{
+	swe_set_read_table_files(RTEST(do_read) ? TRUE : FALSE);
+	return Qnil;
+}
+
+/*
+ * Counters of the internal caches, indexed by SE_STAT_*
+	int32 swe_get_cache_stats(
+		int64 *stats,	// counters, SE_NSTATS values
+		int32 nstats	// size of stats
+	);
+ */
+static VALUE t_swe_get_cache_stats(VALUE self)
+{
+	int64 stats[SE_NSTATS];
+	VALUE output = rb_ary_new_capa(SE_NSTATS);
+	swe_get_cache_stats(stats, SE_NSTATS);
+	for (int i = 0; i < SE_NSTATS; i++)
+		rb_ary_push(output, LL2NUM(stats[i]));
+	return output;
+}
+
+/*
+ * Reset the counters of the internal caches to zero
+	void swe_reset_cache_stats(void);
+ */
+static VALUE t_swe_reset_cache_stats(VALUE self)
+{
+	swe_reset_cache_stats();
+	return Qnil;
+}
+
 /*
  * Calculation of planets, moon, asteroids, lunar nodes, apogees, fictitious bodies
  * http://www.astro.com/swisseph/swephprg.htm#_Toc283735419
@@ -146,6 +497,493 @@ static VALUE t_swe_calc_ut(VALUE self, VALUE julian_ut, VALUE body, VALUE iflag)
 	return output;
 }
 
+/*
+ * Like swe_calc_ut, but writes into the Swe4r::Position pos and returns it, without allocating Ruby objects
+ */
+static VALUE t_swe_calc_ut_into(VALUE self, VALUE julian_ut, VALUE body, VALUE iflag, VALUE pos)
+{
+	char serr[AS_MAXCH];
+
+	if (swe_calc_ut(NUM2DBL(julian_ut), NUM2INT(body), NUM2LONG(iflag), position_ptr(pos), serr) < 0)
+		rb_raise(rb_eRuntimeError, "%s", serr);
+
+	return pos;
+}
+
+/*
+ * Fast longitude mode: longitude and speed from the compressed ep4 ephemeris
+ * The longitudes agree with swe_calc() to about 0.01" for the Sun and the planets,
+ * 0.1" for Mercury, 0.5" for the Moon and 1" for the true node. Within 2 degrees
+ * of the Sun the planets can be off by several arcseconds, because the light
+ * deflection is not interpolated.
+ * Falls back to swe_calc() if the ep4 file for the date is not in the ephemeris path.
+	int ep4_calc(
+		double tjd_et,	// Julian day number, Ephemeris Time
+		int ipl,		// planet number, SE_SUN .. SE_TRUE_NODE, SE_CHIRON
+		double *xx,		// target address for 2 values: longitude, longitude speed
+		char *serr		// 256 bytes for error string
+	);
+ */
+static VALUE t_ep4_calc(VALUE self, VALUE julian_et, VALUE body)
+{
+	double results[2];
+	char serr[AS_MAXCH];
+
+	if (ep4_calc(NUM2DBL(julian_et), NUM2INT(body), results, serr) < 0)
+		rb_raise(rb_eRuntimeError, "%s", serr);
+
+	return rb_ary_new3(2, rb_float_new(results[0]), rb_float_new(results[1]));
+}
+
+/*
+ * ep4_calc() for a packed string of Julian days (ET), returns packed longitude, speed pairs
+	int ep4_calc_arr(double *tjd_et, int32 n, int ipl, double *xx, char *serr);
+ */
+static VALUE t_ep4_calc_arr(VALUE self, VALUE julian_et, VALUE body)
+{
+	char serr[AS_MAXCH];
+	StringValue(julian_et);
+	long n = packed_count(julian_et, 1);
+	VALUE output = rb_str_new(NULL, n * 2 * sizeof(double));
+
+	if (ep4_calc_arr((double *) RSTRING_PTR(julian_et), (int32) n, NUM2INT(body), (double *) RSTRING_PTR(output), serr) < 0)
+		rb_raise(rb_eRuntimeError, "%s", serr);
+
+	return output;
+}
+
+/*
+ * Generate the ep4 file number filenr (days filenr * 10000 .. filenr * 10000 + 9999) with swe_calc()
+	int ep4_make_file(
+		int filenr,		// file number
+		int32 iflag,	// ephemeris flag
+		char *dir,		// target directory, NULL: first directory of the ephemeris path
+		char *errtext	// 256 bytes for error string
+	);
+ */
+static VALUE t_ep4_make_file(int argc, VALUE *argv, VALUE self)
+{
+	char serr[AS_MAXCH];
+	char *dir = NULL;
+
+	if (argc > 3 || argc < 2)
+	{ // there should only be 2 or 3 arguments
+		rb_raise(rb_eArgError, "wrong number of arguments");
+	}
+	if (argc == 3 && !NIL_P(argv[2]))
+		dir = StringValueCStr(argv[2]);
+
+	if (ep4_make_file(NUM2INT(argv[0]), NUM2INT(argv[1]), dir, serr) < 0)
+		rb_raise(rb_eRuntimeError, "%s", serr);
+
+	return Qnil;
+}
+
+/*
+ * Release the mapped ep4 file of the calling thread
+	void ep4_close(void);
+ */
+static VALUE t_ep4_close(VALUE self)
+{
+	ep4_close();
+	return Qnil;
+}
+
+/*
+ * Precompute the catalog of solar eclipses (SE_SUN), lunar eclipses (SE_MOON) and lunar occultations of other bodies
+	int32 swe_ecl_catalog_make(
+		double tjd_start,	// first date, UT
+		double tjd_end,		// last date, UT
+		int32 *ipl,		// bodies
+		int32 nipl,		// number of bodies
+		int32 ifl,		// ephemeris flag
+		char *dir,		// target directory, NULL: first directory of the ephemeris path
+		char *serr		// error string
+	);
+ */
+static VALUE t_swe_ecl_catalog_make(int argc, VALUE *argv, VALUE self)
+{
+	char serr[AS_MAXCH];
+	char *dir = NULL;
+	VALUE list, buf;
+	int32 *ipl;
+	long n;
+
+	if (argc > 5 || argc < 4)
+	{ // there should only be 4 or 5 arguments
+		rb_raise(rb_eArgError, "wrong number of arguments");
+	}
+	if (argc == 5 && !NIL_P(argv[4]))
+		dir = StringValueCStr(argv[4]);
+	list = rb_Array(argv[2]);
+	n = RARRAY_LEN(list);
+	ipl = ALLOCV_N(int32, buf, n);
+	for (long i = 0; i < n; i++)
+		ipl[i] = NUM2INT(rb_ary_entry(list, i));
+
+	if (swe_ecl_catalog_make(NUM2DBL(argv[0]), NUM2DBL(argv[1]), ipl, (int32) n, NUM2INT(argv[3]), dir, serr) < 0)
+		rb_raise(rb_eRuntimeError, "%s", serr);
+	ALLOCV_END(buf);
+
+	return Qnil;
+}
+
+/*
+ * Next or previous eclipse or occultation from the catalog, searched live outside its range
+	int32 swe_ecl_catalog_when(
+		double tjd_start,	// start date, UT
+		int32 ipl,		// SE_SUN: solar eclipse, SE_MOON: lunar eclipse, other: occultation
+		int32 ifl,		// ephemeris flag
+		int32 ifltype,		// eclipse type wanted, 0: any
+		double *tret,		// return array, tret[0] time of maximum
+		double *attr,		// return array, attr[0] magnitude, attr[9], attr[10] saros
+		int32 backward,		// TRUE: search backward, may contain SE_ECL_ONE_TRY
+		char *serr		// error string
+	);
+ * Returns [eclipse type, time of maximum, magnitude, saros series, saros member], or nil if nothing found
+ */
+static VALUE t_swe_ecl_catalog_when(VALUE self, VALUE tjd_start, VALUE body, VALUE iflag, VALUE ifltype, VALUE backward)
+{
+	double tret[10], attr[20];
+	char serr[AS_MAXCH];
+	int32 retflag = swe_ecl_catalog_when(NUM2DBL(tjd_start), NUM2INT(body), NUM2INT(iflag), NUM2INT(ifltype), tret, attr, FIXNUM_P(backward) ? FIX2INT(backward) : (RTEST(backward) ? 1 : 0), serr);
+
+	if (retflag < 0)
+		rb_raise(rb_eRuntimeError, "%s", serr);
+	if (retflag == 0)
+		return Qnil;
+
+	return rb_ary_new_from_args(5, INT2NUM(retflag), DBL2NUM(tret[0]), DBL2NUM(attr[0]),
+		INT2NUM((int) attr[9]), INT2NUM((int) attr[10]));
+}
+
+/*
+ * All eclipses or occultations in a range of dates, searched by a pool of threads
+	int32 swe_ecl_when_range(
+		double tjd_start,	// first date, UT
+		double tjd_end,		// last date, UT
+		int32 ipl,		// SE_SUN: solar eclipses, SE_MOON: lunar eclipses, other: occultations
+		int32 ifl,		// ephemeris flag
+		int32 ifltype,		// eclipse type wanted, 0: any
+		int32 nthreads,		// number of threads
+		int32 *retflag,		// return array, eclipse type of each event
+		double *tret,		// return array, 10 times of each event
+		int32 nmax,		// size of retflag
+		char *serr		// error string
+	);
+ * Returns an array of [eclipse type, tret[0], ..., tret[9]], in order of time.
+ * The search runs without the GVL, so that other Ruby threads can go on meanwhile.
+ */
+struct ecl_when_range_args {
+	double tjd_start, tjd_end;
+	int32 ipl, ifl, ifltype, nthreads, nmax, n;
+	int32 *retflag;
+	double *tret;
+	char serr[AS_MAXCH];
+};
+
+static void *ecl_when_range_nogvl(void *p)
+{
+	struct ecl_when_range_args *a = (struct ecl_when_range_args *) p;
+	a->n = swe_ecl_when_range(a->tjd_start, a->tjd_end, a->ipl, a->ifl, a->ifltype, a->nthreads, a->retflag, a->tret, a->nmax, a->serr);
+	return NULL;
+}
+
+static VALUE t_swe_ecl_when_range(VALUE self, VALUE tjd_start, VALUE tjd_end, VALUE body, VALUE iflag, VALUE ifltype, VALUE nthreads)
+{
+	struct ecl_when_range_args a;
+	VALUE buf_retflag, buf_tret, output;
+
+	a.tjd_start = NUM2DBL(tjd_start);
+	a.tjd_end = NUM2DBL(tjd_end);
+	a.ipl = NUM2INT(body);
+	a.ifl = NUM2INT(iflag);
+	a.ifltype = NUM2INT(ifltype);
+	a.nthreads = NUM2INT(nthreads);
+	// occultations can recur after about 24.7 days; if there are more
+	// events than estimated, the search is repeated for the number found
+	a.nmax = a.tjd_end > a.tjd_start ? (int32) ((a.tjd_end - a.tjd_start) / 24) + 2 : 1;
+	for (;;)
+	{
+		a.retflag = ALLOCV_N(int32, buf_retflag, a.nmax);
+		a.tret = ALLOCV_N(double, buf_tret, a.nmax * 10);
+		rb_thread_call_without_gvl(ecl_when_range_nogvl, &a, NULL, NULL);
+		if (a.n < 0)
+			rb_raise(rb_eRuntimeError, "%s", a.serr);
+		if (a.n <= a.nmax)
+			break;
+		ALLOCV_END(buf_retflag);
+		ALLOCV_END(buf_tret);
+		a.nmax = a.n;
+	}
+
+	output = rb_ary_new_capa(a.n);
+	for (int i = 0; i < a.n; i++)
+	{
+		VALUE event = rb_ary_new_capa(11);
+		rb_ary_push(event, INT2NUM(a.retflag[i]));
+		for (int j = 0; j < 10; j++)
+			rb_ary_push(event, DBL2NUM(a.tret[i * 10 + j]));
+		rb_ary_push(output, event);
+	}
+	ALLOCV_END(buf_retflag);
+	ALLOCV_END(buf_tret);
+
+	return output;
+}
+
+/*
+ * Next solar eclipse at a geographic position
+	int32 swe_sol_eclipse_when_loc(
+		double tjd_start,	// start date for search, UT
+		int32 ifl,		// ephemeris flag
+		double *geopos,		// 3 doubles for geographic longitude, latitude, height above sea
+		double *tret,		// return array, 10 doubles: maximum, contacts 1 to 4, sunrise, sunset
+		double *attr,		// return array, 20 doubles: magnitude, diameter ratio, obscuration etc.
+		int32 backward,		// TRUE, if backward search
+		char *serr		// error string
+	);
+ * Returns [eclipse type, [tret[0], ..., tret[6]], [attr[0], ..., attr[10]]].
+ */
+static VALUE t_swe_sol_eclipse_when_loc(VALUE self, VALUE tjd_start, VALUE iflag, VALUE longitude, VALUE latitude, VALUE altitude, VALUE backward)
+{
+	double geopos[3], tret[10], attr[20];
+	char serr[AS_MAXCH];
+
+	geopos[0] = NUM2DBL(longitude);
+	geopos[1] = NUM2DBL(latitude);
+	geopos[2] = NUM2DBL(altitude);
+	int32 retflag = swe_sol_eclipse_when_loc(NUM2DBL(tjd_start), NUM2INT(iflag), geopos, tret, attr, RTEST(backward) ? TRUE : FALSE, serr);
+	if (retflag < 0)
+		rb_raise(rb_eRuntimeError, "%s", serr);
+
+	VALUE _tret = rb_ary_new();
+	for (int i = 0; i < 7; i++)
+		rb_ary_push(_tret, rb_float_new(tret[i]));
+
+	VALUE _attr = rb_ary_new();
+	for (int i = 0; i < 11; i++)
+		rb_ary_push(_attr, rb_float_new(attr[i]));
+
+	return rb_ary_new_from_args(3, INT2NUM(retflag), _tret, _attr);
+}
+
+/*
+ * Local circumstances of a solar eclipse for many observers
+	int32 swe_sol_eclipse_loc_arr(
+		double tjd_start,	// begin of eclipse, UT
+		double tjd_end,		// end of eclipse, UT
+		double dt,		// time step in days, <= 0: 1 minute
+		int32 ifl,		// ephemeris flag
+		double *geopos,		// longitude, latitude, height of each observer
+		int32 n,		// number of observers
+		double *dret,		// return array, 10 doubles per observer
+		char *serr		// error string
+	);
+ * Observers are passed in as a packed String of longitude, latitude, height triples,
+ * see Array#pack('d*'). Returns a packed String of 10 doubles per observer: time of
+ * maximum, contacts 1 to 4, magnitude, obscuration, diameter ratio, altitude of the
+ * sun and eclipse type; the time of maximum is 0.0 where there is no eclipse.
+ * The computation runs without the GVL.
+ */
+struct sol_eclipse_loc_arr_args {
+	double tjd_start, tjd_end, dt;
+	int32 ifl, n, retc;
+	double *geopos, *dret;
+	char serr[AS_MAXCH];
+};
+
+static void *sol_eclipse_loc_arr_nogvl(void *p)
+{
+	struct sol_eclipse_loc_arr_args *a = (struct sol_eclipse_loc_arr_args *) p;
+	a->retc = swe_sol_eclipse_loc_arr(a->tjd_start, a->tjd_end, a->dt, a->ifl, a->geopos, a->n, a->dret, a->serr);
+	return NULL;
+}
+
+static VALUE t_swe_sol_eclipse_loc_arr(VALUE self, VALUE tjd_start, VALUE tjd_end, VALUE dt, VALUE iflag, VALUE geopos)
+{
+	struct sol_eclipse_loc_arr_args a;
+	VALUE output;
+
+	StringValue(geopos);
+	a.tjd_start = NUM2DBL(tjd_start);
+	a.tjd_end = NUM2DBL(tjd_end);
+	a.dt = NUM2DBL(dt);
+	a.ifl = NUM2INT(iflag);
+	a.n = (int32) packed_count(geopos, 3);
+	output = rb_str_new(NULL, (long) a.n * 10 * sizeof(double));
+	a.geopos = (double *) RSTRING_PTR(geopos);
+	a.dret = (double *) RSTRING_PTR(output);
+
+	rb_str_locktmp(geopos);
+	rb_thread_call_without_gvl(sol_eclipse_loc_arr_nogvl, &a, NULL, NULL);
+	rb_str_unlocktmp(geopos);
+	if (a.retc == ERR)
+		rb_raise(rb_eRuntimeError, "%s", a.serr);
+
+	return output;
+}
+
+/*
+ * Heliacal rising or setting of a planet or star
+	int32 swe_heliacal_ut(
+		double tjdstart_ut,	// start date for search, UT
+		double *geopos,		// 3 doubles for geographic longitude, latitude, height above sea
+		double *datm,		// 4 doubles for pressure, temperature, humidity, extinction
+		double *dobs,		// 6 doubles for age, Snellen ratio and optical instrument
+		char *ObjectName,	// name of planet or star
+		int32 TypeEvent,	// SE_HELIACAL_RISING etc.
+		int32 iflag,		// ephemeris flag and SE_HELFLAG_* bits
+		double *dret,		// return array, 50 doubles: beginning, optimum and end of visibility
+		char *serr		// error string
+	);
+ * datm and dobs are optional Arrays; missing values are replaced by defaults.
+ * Returns [dret[0], dret[1], dret[2]].
+ */
+static VALUE t_swe_heliacal_ut(int argc, VALUE *argv, VALUE self)
+{
+	VALUE tjd_start, longitude, latitude, altitude, object_name, type_event, iflag, _datm, _dobs;
+	double geopos[3], datm[4] = {0}, dobs[6] = {0}, dret[50];
+	char name[AS_MAXCH], serr[AS_MAXCH];
+
+	rb_scan_args(argc, argv, "72", &tjd_start, &longitude, &latitude, &altitude, &object_name, &type_event, &iflag, &_datm, &_dobs);
+	geopos[0] = NUM2DBL(longitude);
+	geopos[1] = NUM2DBL(latitude);
+	geopos[2] = NUM2DBL(altitude);
+	for (int i = 0; !NIL_P(_datm) && i < 4 && i < RARRAY_LEN(_datm); i++)
+		datm[i] = NUM2DBL(rb_ary_entry(_datm, i));
+	for (int i = 0; !NIL_P(_dobs) && i < 6 && i < RARRAY_LEN(_dobs); i++)
+		dobs[i] = NUM2DBL(rb_ary_entry(_dobs, i));
+	snprintf(name, sizeof(name), "%s", StringValueCStr(object_name));
+	int32 retflag = swe_heliacal_ut(NUM2DBL(tjd_start), geopos, datm, dobs, name, NUM2INT(type_event), NUM2INT(iflag), dret, serr);
+	if (retflag < 0)
+		rb_raise(rb_eRuntimeError, "%s", serr);
+
+	return rb_ary_new_from_args(3, rb_float_new(dret[0]), rb_float_new(dret[1]), rb_float_new(dret[2]));
+}
+
+/*
+ * Heliacal events of several objects in a period of time
+	int32 swe_heliacal_range(
+		double tjd_start,	// start of period, UT
+		double tjd_end,		// end of period, UT
+		double *geopos,		// 3 doubles for geographic longitude, latitude, height above sea
+		double *datm,		// 4 doubles for pressure, temperature, humidity, extinction
+		double *dobs,		// 6 doubles for age, Snellen ratio and optical instrument
+		char *ObjectNames,	// nobj names of AS_MAXCH chars
+		int32 nobj,		// number of objects
+		int32 *TypeEvents,	// event types wanted for every object
+		int32 ntypes,		// number of event types
+		int32 helflag,		// ephemeris flag and SE_HELFLAG_* bits
+		double *dret,		// return array, 5 doubles per event
+		int32 nret,		// number of events dret can hold
+		char *serr		// error string
+	);
+ * Returns an Array of [object name, event type, dret[0], dret[1], dret[2]], sorted by time.
+ * The computation runs without the GVL.
+ */
+struct heliacal_range_args {
+	double tjd_start, tjd_end, geopos[3], datm[4], dobs[6];
+	char *names;
+	int32 nobj, *types, ntypes, helflag, nret, retc;
+	double *dret;
+	char serr[AS_MAXCH];
+};
+
+static void *heliacal_range_nogvl(void *p)
+{
+	struct heliacal_range_args *a = (struct heliacal_range_args *) p;
+	a->retc = swe_heliacal_range(a->tjd_start, a->tjd_end, a->geopos, a->datm, a->dobs, a->names, a->nobj, a->types, a->ntypes, a->helflag, a->dret, a->nret, a->serr);
+	return NULL;
+}
+
+static VALUE t_swe_heliacal_range(int argc, VALUE *argv, VALUE self)
+{
+	VALUE tjd_start, tjd_end, longitude, latitude, altitude, names, types, iflag, _datm, _dobs, output;
+	struct heliacal_range_args a = {0};
+	VALUE buf_names, buf_types, buf_dret;
+
+	rb_scan_args(argc, argv, "82", &tjd_start, &tjd_end, &longitude, &latitude, &altitude, &names, &types, &iflag, &_datm, &_dobs);
+	Check_Type(names, T_ARRAY);
+	Check_Type(types, T_ARRAY);
+	a.tjd_start = NUM2DBL(tjd_start);
+	a.tjd_end = NUM2DBL(tjd_end);
+	if (!(a.tjd_end >= a.tjd_start))
+		rb_raise(rb_eArgError, "tjd_end must not be before tjd_start");
+	a.geopos[0] = NUM2DBL(longitude);
+	a.geopos[1] = NUM2DBL(latitude);
+	a.geopos[2] = NUM2DBL(altitude);
+	for (int i = 0; !NIL_P(_datm) && i < 4 && i < RARRAY_LEN(_datm); i++)
+		a.datm[i] = NUM2DBL(rb_ary_entry(_datm, i));
+	for (int i = 0; !NIL_P(_dobs) && i < 6 && i < RARRAY_LEN(_dobs); i++)
+		a.dobs[i] = NUM2DBL(rb_ary_entry(_dobs, i));
+	a.helflag = NUM2INT(iflag);
+	a.nobj = (int32) RARRAY_LEN(names);
+	a.ntypes = (int32) RARRAY_LEN(types);
+	a.names = ALLOCV_N(char, buf_names, (size_t) a.nobj * AS_MAXCH + 1);
+	a.types = ALLOCV_N(int32, buf_types, a.ntypes + 1);
+	for (int i = 0; i < a.nobj; i++) {
+		VALUE name = rb_ary_entry(names, i);
+		snprintf(a.names + (size_t) i * AS_MAXCH, AS_MAXCH, "%s", StringValueCStr(name));
+	}
+	for (int i = 0; i < a.ntypes; i++)
+		a.types[i] = NUM2INT(rb_ary_entry(types, i));
+	/* at most 13 events of one type per year for the moon; if there are
+	 * more events than estimated, the search is repeated for the number found */
+	double nret = ((a.tjd_end - a.tjd_start) / 365.25 * 14 + 14) * (a.nobj * a.ntypes > 0 ? a.nobj * a.ntypes : 1);
+	if (nret > INT32_MAX / 5) {
+		ALLOCV_END(buf_names);
+		ALLOCV_END(buf_types);
+		rb_raise(rb_eArgError, "too many objects and event types for the time range");
+	}
+	a.nret = (int32) nret;
+	for (;;) {
+		a.dret = ALLOCV_N(double, buf_dret, (size_t) a.nret * 5);
+		rb_thread_call_without_gvl(heliacal_range_nogvl, &a, NULL, NULL);
+		if (a.retc == ERR) {
+			ALLOCV_END(buf_names);
+			ALLOCV_END(buf_types);
+			ALLOCV_END(buf_dret);
+			rb_raise(rb_eRuntimeError, "%s", a.serr);
+		}
+		if (a.retc <= a.nret)
+			break;
+		ALLOCV_END(buf_dret);
+		a.nret = a.retc;
+	}
+
+	int32 n = a.retc;
+	output = rb_ary_new_capa(n);
+	for (int i = 0; i < n; i++) {
+		double *d = a.dret + (size_t) i * 5;
+		rb_ary_push(output, rb_ary_new_from_args(5, rb_ary_entry(names, (long) d[0]), INT2NUM((int) d[1]),
+			DBL2NUM(d[2]), DBL2NUM(d[3]), DBL2NUM(d[4])));
+	}
+	ALLOCV_END(buf_names);
+	ALLOCV_END(buf_types);
+	ALLOCV_END(buf_dret);
+
+	return output;
+}
+
+/*
+ * Processor time and counts of the sub-computations of the last swe_heliacal_ut() in this thread,
+ * indexed by SE_HELSTAT_*
+	int32 swe_heliacal_stats(
+		double *dstat,	// statistics, SE_NHELSTATS values
+		int32 nstat	// size of dstat
+	);
+ */
+static VALUE t_swe_heliacal_stats(VALUE self)
+{
+	double dstat[SE_NHELSTATS];
+	VALUE output = rb_ary_new_capa(SE_NHELSTATS);
+	swe_heliacal_stats(dstat, SE_NHELSTATS);
+	for (int i = 0; i < SE_NHELSTATS; i++)
+		rb_ary_push(output, DBL2NUM(dstat[i]));
+	return output;
+}
+
 /*
  * This function can be used to specify the mode for sidereal computations
  * http://www.astro.com/swisseph/swephprg.htm#_Toc283735478
@@ -256,6 +1094,21 @@ static VALUE t_swe_houses(VALUE self, VALUE julian_day, VALUE latitude, VALUE lo
 	return output;
 }
 
+/*
+ * Like swe_houses, but writes into the Swe4r::Houses houses and returns it, without allocating Ruby objects
+ */
+static VALUE t_swe_houses_into(VALUE self, VALUE julian_day, VALUE latitude, VALUE longitude, VALUE house_system, VALUE houses)
+{
+	struct swe4r_houses *h = houses_ptr(houses);
+	int hsys = NUM2CHR(house_system);
+
+	if (swe_houses(NUM2DBL(julian_day), NUM2DBL(latitude), NUM2DBL(longitude), hsys, h->cusps, h->ascmc) < 0)
+		rb_raise(rb_eRuntimeError, "error in swe_houses");
+	h->ncusps = (hsys == 'G') ? 36 : 12;
+
+	return houses;
+}
+
 // This function is better than swe_houses and returns speeds as well
 // https://www.astro.com/swisseph/swephprg.htm#_Toc112949026
 // int swe_houses_ex2(
@@ -311,6 +1164,22 @@ static VALUE t_swe_houses_ex2(VALUE self, VALUE julian_day, VALUE flag, VALUE la
 	return output;
 }
 
+/*
+ * Like swe_houses_ex2, but writes into the Swe4r::Houses houses and returns it, without allocating Ruby objects
+ */
+static VALUE t_swe_houses_ex2_into(VALUE self, VALUE julian_day, VALUE flag, VALUE latitude, VALUE longitude, VALUE house_system, VALUE houses)
+{
+	struct swe4r_houses *h = houses_ptr(houses);
+	int hsys = NUM2CHR(house_system);
+	char serr[AS_MAXCH];
+
+	if (swe_houses_ex2(NUM2DBL(julian_day), NUM2INT(flag), NUM2DBL(latitude), NUM2DBL(longitude), hsys, h->cusps, h->ascmc, h->cusps_speed, h->ascmc_speed, serr) < 0)
+		rb_raise(rb_eRuntimeError, "%s", serr);
+	h->ncusps = (hsys == 'G') ? 36 : 12;
+
+	return houses;
+}
+
 // int32 swe_rise_trans(
 // double tjd_ut,      /* search after this time (UT) */
 // int32 ipl,               /* planet number, if planet or moon */
@@ -384,6 +1253,30 @@ static VALUE t_swe_rise_trans_true_hor(VALUE self, VALUE julian_day, VALUE body,
 	return rb_float_new(retval);
 }
 
+/*
+ * Transforms true altitude into apparent altitude and vice-versa
+	double swe_refrac_extended(
+		double inalt,		// altitude of object above geometric horizon in degrees
+		double geoalt,		// altitude of observer above sea level in meters
+		double atpress,		// atmospheric pressure in mbar (hPa)
+		double attemp,		// atmospheric temperature in degrees Celsius
+		double lapse_rate,	// dT/dh in deg K/m
+		int32 calc_flag,	// SE_TRUE_TO_APP or SE_APP_TO_TRUE, optionally | SE_REFRAC_TABLE
+		double *dret		// return array: true altitude, apparent altitude, refraction, dip
+	);
+ * Returns [dret[0], dret[1], dret[2], dret[3]].
+ */
+static VALUE t_swe_refrac_extended(VALUE self, VALUE inalt, VALUE geoalt, VALUE atpress, VALUE attemp, VALUE lapse_rate, VALUE calc_flag)
+{
+	double dret[20];
+	swe_refrac_extended(NUM2DBL(inalt), NUM2DBL(geoalt), NUM2DBL(atpress), NUM2DBL(attemp), NUM2DBL(lapse_rate), NUM2INT(calc_flag), dret);
+
+	VALUE output = rb_ary_new();
+	for (int i = 0; i < 4; i++)
+		rb_ary_push(output, rb_float_new(dret[i]));
+	return output;
+}
+
 // https://www.astro.com/swisseph/swephprg.htm#_Toc112948998
 // swe_azalt() computes the horizontal coordinates (azimuth and altitude) of a planet or a star from either ecliptical or equatorial coordinates.
 // void swe_azalt(
@@ -426,6 +1319,397 @@ static VALUE t_swe_azalt( VALUE self, VALUE julian_day, VALUE flag, VALUE lon, V
 	rb_ary_push(output, rb_float_new(xaz[2]));
 	return output;
 }
+/*
+ * Like swe_azalt, but writes azimuth, true altitude and apparent altitude into
+ * pos.lon, pos.lat and pos.dist of the Swe4r::Position pos and returns it;
+ * the speeds of pos are set to 0
+ */
+static VALUE t_swe_azalt_into(VALUE self, VALUE julian_day, VALUE flag, VALUE lon, VALUE lat, VALUE height, VALUE pressure, VALUE temp, VALUE in0, VALUE in1, VALUE in2, VALUE pos)
+{
+	double geopos[3];
+	geopos[0] = NUM2DBL(lon);
+	geopos[1] = NUM2DBL(lat);
+	geopos[2] = NUM2DBL(height);
+
+	double xin[3];
+	xin[0] = NUM2DBL(in0);
+	xin[1] = NUM2DBL(in1);
+	xin[2] = NUM2DBL(in2);
+
+	double *xaz = position_ptr(pos);
+	swe_azalt(NUM2DBL(julian_day), NUM2INT(flag), geopos, NUM2DBL(pressure), NUM2DBL(temp), xin, xaz);
+	xaz[3] = xaz[4] = xaz[5] = 0;
+
+	return pos;
+}
+
+/*
+ * Horizontal coordinates of many positions at one date
+	void swe_azalt_arr(
+		double tjd_ut,		// UT
+		int32 calc_flag,	// SE_ECL2HOR or SE_EQU2HOR
+		double *geopos,		// array of 3 doubles: geograph. long., lat., height
+		double atpress,		// atmospheric pressure in mbar (hPa)
+		double attemp,		// atmospheric temperature in degrees Celsius
+		double *xin,		// 3 doubles per position, as in swe_azalt()
+		int32 n,		// number of positions
+		double *xaz		// return array, 3 doubles per position
+	);
+ * Positions are passed in as a packed String of 3 doubles each (longitude or
+ * right ascension, latitude or declination, distance), see Array#pack('d*').
+ * Returns a packed String of azimuth, true altitude and apparent altitude triples.
+ */
+static VALUE t_swe_azalt_arr(VALUE self, VALUE julian_day, VALUE flag, VALUE lon, VALUE lat, VALUE height, VALUE pressure, VALUE temp, VALUE xin)
+{
+	double geopos[3];
+	geopos[0] = NUM2DBL(lon);
+	geopos[1] = NUM2DBL(lat);
+	geopos[2] = NUM2DBL(height);
+
+	StringValue(xin);
+	long n = packed_count(xin, 3);
+	VALUE output = rb_str_new(NULL, n * 3 * sizeof(double));
+	swe_azalt_arr(NUM2DBL(julian_day), NUM2INT(flag), geopos, NUM2DBL(pressure), NUM2DBL(temp), (double *) RSTRING_PTR(xin), (int32) n, (double *) RSTRING_PTR(output));
+	return output;
+}
+
+/*
+ * Horizontal coordinates of one position per date
+	void swe_azalt_times(
+		double *tjd_ut,		// n dates, UT
+		int32 n,		// number of dates
+		int32 calc_flag,	// SE_ECL2HOR or SE_EQU2HOR
+		double *geopos,		// array of 3 doubles: geograph. long., lat., height
+		double atpress,		// atmospheric pressure in mbar (hPa)
+		double attemp,		// atmospheric temperature in degrees Celsius
+		double *xin,		// 3 doubles per date, as in swe_azalt()
+		double *xaz		// return array, 3 doubles per date
+	);
+ * Dates and positions are passed in as packed Strings of 1 and 3 doubles per date.
+ * Returns a packed String of azimuth, true altitude and apparent altitude triples.
+ */
+static VALUE t_swe_azalt_times(VALUE self, VALUE julian_days, VALUE flag, VALUE lon, VALUE lat, VALUE height, VALUE pressure, VALUE temp, VALUE xin)
+{
+	double geopos[3];
+	geopos[0] = NUM2DBL(lon);
+	geopos[1] = NUM2DBL(lat);
+	geopos[2] = NUM2DBL(height);
+
+	StringValue(julian_days);
+	StringValue(xin);
+	long n = packed_count(julian_days, 1);
+	if (packed_count(xin, 3) != n)
+		rb_raise(rb_eArgError, "expected 3 doubles of position per date");
+	VALUE output = rb_str_new(NULL, n * 3 * sizeof(double));
+	swe_azalt_times((double *) RSTRING_PTR(julian_days), (int32) n, NUM2INT(flag), geopos, NUM2DBL(pressure), NUM2DBL(temp), (double *) RSTRING_PTR(xin), (double *) RSTRING_PTR(output));
+	return output;
+}
+
+/*
+ * Nodes and apsides of a planet
+	int32 swe_nod_aps(
+		double tjd_et,		// Julian day number, Ephemeris Time
+		int32 ipl,		// planet number
+		int32 iflag,		// flag bits
+		int32 method,		// SE_NODBIT_MEAN, SE_NODBIT_OSCU, ...
+		double *xnasc,		// ascending node, 6 doubles
+		double *xndsc,		// descending node, 6 doubles
+		double *xperi,		// perihelion, 6 doubles
+		double *xaphe,		// aphelion, 6 doubles
+		char *serr		// error string
+	);
+ * Returns an Array of 24 doubles in the order of swe_nod_aps_arr
+ */
+static VALUE t_swe_nod_aps(VALUE self, VALUE julian_et, VALUE body, VALUE iflag, VALUE method)
+{
+	double x[24];
+	char serr[AS_MAXCH];
+
+	if (swe_nod_aps(NUM2DBL(julian_et), NUM2INT(body), NUM2INT(iflag), NUM2INT(method), x, x + 6, x + 12, x + 18, serr) < 0)
+		rb_raise(rb_eRuntimeError, "%s", serr);
+
+	VALUE output = rb_ary_new_capa(24);
+	for (int i = 0; i < 24; i++)
+		rb_ary_push(output, rb_float_new(x[i]));
+
+	return output;
+}
+
+/*
+ * Nodes and apsides of several planets at one date
+	int32 swe_nod_aps_arr(
+		double tjd_et,		// Julian day number, Ephemeris Time
+		int32 *ipl,		// planet numbers
+		int32 nipl,		// number of planets
+		int32 iflag,		// flag bits
+		int32 method,		// SE_NODBIT_MEAN, SE_NODBIT_OSCU, ...
+		double *xret,		// return array, 24 doubles per planet
+		char *serr		// error string
+	);
+ * Returns a packed String of 24 doubles per planet: ascending node, descending node,
+ * perihelion and aphelion, 6 doubles each as with swe_calc(). Planets that cannot be
+ * computed get 24 zeros.
+ */
+static VALUE t_swe_nod_aps_arr(VALUE self, VALUE julian_et, VALUE bodies, VALUE iflag, VALUE method)
+{
+	VALUE list = rb_Array(bodies), buf;
+	long n = RARRAY_LEN(list);
+	int32 *ipl = ALLOCV_N(int32, buf, n);
+	VALUE output = rb_str_new(NULL, n * 24 * sizeof(double));
+	char serr[AS_MAXCH];
+	for (long i = 0; i < n; i++)
+		ipl[i] = NUM2INT(rb_ary_entry(list, i));
+	swe_nod_aps_arr(NUM2DBL(julian_et), ipl, (int32) n, NUM2INT(iflag), NUM2INT(method), (double *) RSTRING_PTR(output), serr);
+	ALLOCV_END(buf);
+	return output;
+}
+
+/*
+ * Nodes and apsides of one planet at many dates
+	int32 swe_nod_aps_times(
+		double *tjd_et,		// n dates, Ephemeris Time
+		int32 n,		// number of dates
+		int32 ipl,		// planet number
+		int32 iflag,		// flag bits
+		int32 method,		// SE_NODBIT_MEAN, SE_NODBIT_OSCU, ...
+		double *xret,		// return array, 24 doubles per date
+		char *serr		// error string
+	);
+ * Dates are passed in as a packed String of doubles. Returns a packed String
+ * of 24 doubles per date as swe_nod_aps_arr.
+ */
+static VALUE t_swe_nod_aps_times(VALUE self, VALUE julian_ets, VALUE body, VALUE iflag, VALUE method)
+{
+	StringValue(julian_ets);
+	long n = packed_count(julian_ets, 1);
+	VALUE output = rb_str_new(NULL, n * 24 * sizeof(double));
+	char serr[AS_MAXCH];
+	swe_nod_aps_times((double *) RSTRING_PTR(julian_ets), (int32) n, NUM2INT(body), NUM2INT(iflag), NUM2INT(method), (double *) RSTRING_PTR(output), serr);
+	return output;
+}
+
+/*
+ * Osculating orbital elements of several bodies at one date
+	int32 swe_get_orbital_elements_arr(
+		double tjd_et,		// Julian day number, Ephemeris Time
+		int32 *ipl,		// body numbers
+		int32 nipl,		// number of bodies
+		int32 iflag,		// ephemeris flag, SEFLG_HELCTR or SEFLG_BARYCTR, SEFLG_ORBEL_AA
+		double *dret,		// return array, 17 doubles per body
+		char *serr		// error string
+	);
+ * Returns a packed String of 17 doubles per body: semimajor axis, eccentricity,
+ * inclination, node, argument and longitude of perihelion, mean, true and eccentric
+ * anomaly, mean longitude, sidereal period, daily motion, tropical period, synodic
+ * period, time of perihelion passage, perihelion and aphelion distance.
+ * Bodies that cannot be computed get 17 zeros.
+ */
+static VALUE t_swe_get_orbital_elements_arr(VALUE self, VALUE julian_et, VALUE bodies, VALUE iflag)
+{
+	VALUE list = rb_Array(bodies), buf;
+	long n = RARRAY_LEN(list);
+	int32 *ipl = ALLOCV_N(int32, buf, n);
+	VALUE output = rb_str_new(NULL, n * 17 * sizeof(double));
+	char serr[AS_MAXCH];
+	for (long i = 0; i < n; i++)
+		ipl[i] = NUM2INT(rb_ary_entry(list, i));
+	swe_get_orbital_elements_arr(NUM2DBL(julian_et), ipl, (int32) n, NUM2INT(iflag), (double *) RSTRING_PTR(output), serr);
+	ALLOCV_END(buf);
+	return output;
+}
+
+/*
+ * Maximum, minimum and true distance of several bodies at one date
+	int32 swe_orbit_max_min_true_distance_arr(
+		double tjd_et,		// Julian day number, Ephemeris Time
+		int32 *ipl,		// body numbers
+		int32 nipl,		// number of bodies
+		int32 iflag,		// ephemeris flag, optionally SEFLG_HELCTR
+		double *dret,		// return array, 3 doubles per body
+		char *serr		// error string
+	);
+ * Returns a packed String of maximum, minimum and true distance triples.
+ * Bodies that cannot be computed get 3 zeros.
+ */
+static VALUE t_swe_orbit_max_min_true_distance_arr(VALUE self, VALUE julian_et, VALUE bodies, VALUE iflag)
+{
+	VALUE list = rb_Array(bodies), buf;
+	long n = RARRAY_LEN(list);
+	int32 *ipl = ALLOCV_N(int32, buf, n);
+	VALUE output = rb_str_new(NULL, n * 3 * sizeof(double));
+	char serr[AS_MAXCH];
+	for (long i = 0; i < n; i++)
+		ipl[i] = NUM2INT(rb_ary_entry(list, i));
+	swe_orbit_max_min_true_distance_arr(NUM2DBL(julian_et), ipl, (int32) n, NUM2INT(iflag), (double *) RSTRING_PTR(output), serr);
+	ALLOCV_END(buf);
+	return output;
+}
+
+/*
+ * Planetary phenomena
+	int32 swe_pheno_ut(
+		double tjd_ut,		// Julian day number, Universal Time
+		int32 ipl,		// planet number
+		int32 iflag,		// ephemeris flag, SEFLG_TRUEPOS, SEFLG_TOPOCTR etc.
+		double *attr,		// return array, 20 doubles
+		char *serr		// error string
+	);
+ * Returns [phase angle, phase, elongation, apparent diameter, apparent magnitude, horizontal parallax]
+ */
+static VALUE t_swe_pheno_ut(VALUE self, VALUE julian_ut, VALUE body, VALUE iflag)
+{
+	double attr[20];
+	char serr[AS_MAXCH];
+
+	if (swe_pheno_ut(NUM2DBL(julian_ut), NUM2INT(body), NUM2INT(iflag), attr, serr) < 0)
+		rb_raise(rb_eRuntimeError, "%s", serr);
+
+	VALUE output = rb_ary_new_capa(6);
+	for (int i = 0; i < 6; i++)
+		rb_ary_push(output, rb_float_new(attr[i]));
+
+	return output;
+}
+
+/*
+ * Planetary phenomena of several bodies at one date
+	int32 swe_pheno_ut_arr(
+		double tjd_ut,		// Julian day number, Universal Time
+		int32 *ipl,		// planet numbers
+		int32 nipl,		// number of planets
+		int32 iflag,		// ephemeris flag, SEFLG_TRUEPOS, SEFLG_TOPOCTR etc.
+		double *attr,		// return array, 20 doubles per planet
+		char *serr		// error string
+	);
+ * Returns a packed String of 6 doubles per body, as the Array returned by swe_pheno_ut.
+ * Bodies that cannot be computed get 6 zeros.
+ */
+static VALUE t_swe_pheno_ut_arr(VALUE self, VALUE julian_ut, VALUE bodies, VALUE iflag)
+{
+	VALUE list = rb_Array(bodies), buf, buf_attr;
+	long n = RARRAY_LEN(list);
+	int32 *ipl = ALLOCV_N(int32, buf, n);
+	double *attr = ALLOCV_N(double, buf_attr, n * 20);
+	VALUE output = rb_str_new(NULL, n * 6 * sizeof(double));
+	double *xp = (double *) RSTRING_PTR(output);
+	char serr[AS_MAXCH];
+	for (long i = 0; i < n; i++)
+		ipl[i] = NUM2INT(rb_ary_entry(list, i));
+	swe_pheno_ut_arr(NUM2DBL(julian_ut), ipl, (int32) n, NUM2INT(iflag), attr, serr);
+	for (long i = 0; i < n; i++)
+		for (int j = 0; j < 6; j++)
+			xp[6 * i + j] = attr[20 * i + j];
+	ALLOCV_END(buf);
+	ALLOCV_END(buf_attr);
+	return output;
+}
+
+/*
+ * Gauquelin sector position of a planet or star
+	int32 swe_gauquelin_sector(
+		double t_ut,		// Julian day number, Universal Time
+		int32 ipl,		// planet number
+		char *starname,		// star name, or NULL
+		int32 iflag,		// ephemeris flag
+		int32 imeth,		// 0, 1: from longitude (and latitude), 2 - 5: from rising and setting
+		double *geopos,		// 3 doubles for geographic longitude, latitude, height above sea
+		double atpress,		// atmospheric pressure, for imeth 3 and 5
+		double attemp,		// atmospheric temperature, for imeth 3 and 5
+		double *dgsect,		// return address for the sector position
+		char *serr		// error string
+	);
+ * Returns the sector position, 1.0 <= dgsect < 37.0
+ */
+static VALUE t_swe_gauquelin_sector(VALUE self, VALUE julian_ut, VALUE body, VALUE iflag, VALUE imeth, VALUE lon, VALUE lat, VALUE height, VALUE pressure, VALUE temp)
+{
+	double geopos[3], dgsect;
+	int32 ipl = 0;
+	char *starname = NULL;
+	char star[AS_MAXCH], serr[AS_MAXCH];
+
+	if (TYPE(body) == T_STRING) {
+		snprintf(star, AS_MAXCH, "%s", StringValueCStr(body));
+		starname = star;
+	} else {
+		ipl = NUM2INT(body);
+	}
+	geopos[0] = NUM2DBL(lon);
+	geopos[1] = NUM2DBL(lat);
+	geopos[2] = NUM2DBL(height);
+	if (swe_gauquelin_sector(NUM2DBL(julian_ut), ipl, starname, NUM2INT(iflag), NUM2INT(imeth), geopos, NUM2DBL(pressure), NUM2DBL(temp), &dgsect, serr) < 0)
+		rb_raise(rb_eRuntimeError, "%s", serr);
+	return rb_float_new(dgsect);
+}
+
+/*
+ * Gauquelin sector positions of several bodies for many dates and places
+	int32 swe_gauquelin_sector_arr(
+		double *tjd_ut,		// Julian day numbers, Universal Time
+		double *geopos,		// longitude, latitude, height of each record
+		int32 nrec,		// number of records
+		int32 *ipl,		// planet numbers
+		int32 nipl,		// number of planets
+		int32 iflag,		// ephemeris flag
+		int32 imeth,		// method, as with swe_gauquelin_sector()
+		double atpress,		// atmospheric pressure
+		double attemp,		// atmospheric temperature
+		int32 nthreads,		// number of threads
+		double *dgsect,		// return array, nipl doubles per record
+		char *serr		// error string
+	);
+ * Dates and places are passed in as packed Strings of 1 and 3 doubles per record, see
+ * Array#pack('d*'). Returns a packed String of one sector position per body and record;
+ * positions that cannot be computed, e.g. of circumpolar bodies, are 0.0.
+ * The computation runs without the GVL.
+ */
+struct gauquelin_sector_arr_args {
+	double *tjd_ut, *geopos, atpress, attemp, *dgsect;
+	int32 nrec, *ipl, nipl, iflag, imeth, nthreads;
+	char serr[AS_MAXCH];
+};
+
+static void *gauquelin_sector_arr_nogvl(void *p)
+{
+	struct gauquelin_sector_arr_args *a = (struct gauquelin_sector_arr_args *) p;
+	swe_gauquelin_sector_arr(a->tjd_ut, a->geopos, a->nrec, a->ipl, a->nipl, a->iflag, a->imeth, a->atpress, a->attemp, a->nthreads, a->dgsect, a->serr);
+	return NULL;
+}
+
+static VALUE t_swe_gauquelin_sector_arr(VALUE self, VALUE julian_days, VALUE geopos, VALUE bodies, VALUE iflag, VALUE imeth, VALUE pressure, VALUE temp, VALUE nthreads)
+{
+	struct gauquelin_sector_arr_args a;
+	VALUE list = rb_Array(bodies), buf, output;
+	long n = RARRAY_LEN(list);
+
+	StringValue(julian_days);
+	StringValue(geopos);
+	a.nrec = (int32) packed_count(julian_days, 1);
+	if (packed_count(geopos, 3) != a.nrec)
+		rb_raise(rb_eArgError, "expected 3 doubles of place per date");
+	a.ipl = ALLOCV_N(int32, buf, n);
+	for (long i = 0; i < n; i++)
+		a.ipl[i] = NUM2INT(rb_ary_entry(list, i));
+	a.nipl = (int32) n;
+	a.iflag = NUM2INT(iflag);
+	a.imeth = NUM2INT(imeth);
+	a.atpress = NUM2DBL(pressure);
+	a.attemp = NUM2DBL(temp);
+	a.nthreads = NUM2INT(nthreads);
+	output = rb_str_new(NULL, (long) a.nrec * n * sizeof(double));
+	a.tjd_ut = (double *) RSTRING_PTR(julian_days);
+	a.geopos = (double *) RSTRING_PTR(geopos);
+	a.dgsect = (double *) RSTRING_PTR(output);
+
+	rb_str_locktmp(julian_days);
+	rb_str_locktmp(geopos);
+	rb_thread_call_without_gvl(gauquelin_sector_arr_nogvl, &a, NULL, NULL);
+	rb_str_unlocktmp(geopos);
+	rb_str_unlocktmp(julian_days);
+	ALLOCV_END(buf);
+
+	return output;
+}
+
 // https://www.astro.com/swisseph/swephprg.htm#_Toc112949076
 /* equator -> ecliptic    : eps must be positive
 * ecliptic -> equator    : eps must be negative
@@ -485,21 +1769,89 @@ void Init_swe4r()
 	// Module
 	rb_mSwe4r = rb_define_module("Swe4r");
 
+	// Classes
+	rb_cPosition = rb_define_class_under(rb_mSwe4r, "Position", rb_cObject);
+	rb_define_alloc_func(rb_cPosition, position_alloc);
+	rb_define_method(rb_cPosition, "lon", position_lon, 0);
+	rb_define_method(rb_cPosition, "lat", position_lat, 0);
+	rb_define_method(rb_cPosition, "dist", position_dist, 0);
+	rb_define_method(rb_cPosition, "lon_speed", position_lon_speed, 0);
+	rb_define_method(rb_cPosition, "lat_speed", position_lat_speed, 0);
+	rb_define_method(rb_cPosition, "dist_speed", position_dist_speed, 0);
+	rb_define_method(rb_cPosition, "lon=", position_set_lon, 1);
+	rb_define_method(rb_cPosition, "lat=", position_set_lat, 1);
+	rb_define_method(rb_cPosition, "dist=", position_set_dist, 1);
+	rb_define_method(rb_cPosition, "lon_speed=", position_set_lon_speed, 1);
+	rb_define_method(rb_cPosition, "lat_speed=", position_set_lat_speed, 1);
+	rb_define_method(rb_cPosition, "dist_speed=", position_set_dist_speed, 1);
+	rb_define_method(rb_cPosition, "[]", position_aref, 1);
+	rb_define_method(rb_cPosition, "to_a", position_to_a, 0);
+
+	rb_cHouses = rb_define_class_under(rb_mSwe4r, "Houses", rb_cObject);
+	rb_define_alloc_func(rb_cHouses, houses_alloc);
+	rb_define_method(rb_cHouses, "cusp", houses_cusp, 1);
+	rb_define_method(rb_cHouses, "cusp_speed", houses_cusp_speed, 1);
+	rb_define_method(rb_cHouses, "ascmc", houses_ascmc, 1);
+	rb_define_method(rb_cHouses, "ascmc_speed", houses_ascmc_speed, 1);
+	rb_define_method(rb_cHouses, "asc", houses_asc, 0);
+	rb_define_method(rb_cHouses, "mc", houses_mc, 0);
+	rb_define_method(rb_cHouses, "cusps", houses_cusps, 0);
+
 	// Module Functions
 	rb_define_module_function(rb_mSwe4r, "swe_set_ephe_path", t_swe_set_ephe_path, 1);
 	rb_define_module_function(rb_mSwe4r, "swe_set_jpl_file", t_swe_set_jpl_file, 1);
+	rb_define_module_function(rb_mSwe4r, "swe_get_planet_name", t_swe_get_planet_name, 1);
+	rb_define_module_function(rb_mSwe4r, "swe_get_planet_name_arr", t_swe_get_planet_name_arr, 1);
 	rb_define_module_function(rb_mSwe4r, "swe_julday", t_swe_julday, -1);
 	rb_define_module_function(rb_mSwe4r, "swe_revjul", t_swe_revjul, -1);
+	rb_define_module_function(rb_mSwe4r, "swe_julday_arr", t_swe_julday_arr, -1);
+	rb_define_module_function(rb_mSwe4r, "swe_revjul_arr", t_swe_revjul_arr, -1);
+	rb_define_module_function(rb_mSwe4r, "swe_utc_to_jd_arr", t_swe_utc_to_jd_arr, -1);
+	rb_define_module_function(rb_mSwe4r, "swe_jdet_to_utc_arr", t_swe_jdet_to_utc_arr, -1);
 	rb_define_module_function(rb_mSwe4r, "swe_set_topo", t_swe_set_topo, 3);
+	rb_define_module_function(rb_mSwe4r, "swe_set_interpolate_deltat", t_swe_set_interpolate_deltat, 1);
+	rb_define_module_function(rb_mSwe4r, "swe_set_calc_cache", t_swe_set_calc_cache, 1);
+	rb_define_module_function(rb_mSwe4r, "swe_set_interpolate_ecl", t_swe_set_interpolate_ecl, 1);
+	rb_define_module_function(rb_mSwe4r, "swe_set_read_table_files", t_swe_set_read_table_files, 1);
+	rb_define_module_function(rb_mSwe4r, "swe_get_cache_stats", t_swe_get_cache_stats, 0);
+	rb_define_module_function(rb_mSwe4r, "swe_reset_cache_stats", t_swe_reset_cache_stats, 0);
 	rb_define_module_function(rb_mSwe4r, "swe_calc_ut", t_swe_calc_ut, 3);
+	rb_define_module_function(rb_mSwe4r, "swe_calc_ut_into", t_swe_calc_ut_into, 4);
+	rb_define_module_function(rb_mSwe4r, "ep4_calc", t_ep4_calc, 2);
+	rb_define_module_function(rb_mSwe4r, "ep4_calc_arr", t_ep4_calc_arr, 2);
+	rb_define_module_function(rb_mSwe4r, "ep4_make_file", t_ep4_make_file, -1);
+	rb_define_module_function(rb_mSwe4r, "ep4_close", t_ep4_close, 0);
+	rb_define_module_function(rb_mSwe4r, "swe_ecl_catalog_make", t_swe_ecl_catalog_make, -1);
+	rb_define_module_function(rb_mSwe4r, "swe_ecl_catalog_when", t_swe_ecl_catalog_when, 5);
+	rb_define_module_function(rb_mSwe4r, "swe_ecl_when_range", t_swe_ecl_when_range, 6);
+	rb_define_module_function(rb_mSwe4r, "swe_sol_eclipse_when_loc", t_swe_sol_eclipse_when_loc, 6);
+	rb_define_module_function(rb_mSwe4r, "swe_sol_eclipse_loc_arr", t_swe_sol_eclipse_loc_arr, 5);
+	rb_define_module_function(rb_mSwe4r, "swe_heliacal_ut", t_swe_heliacal_ut, -1);
+	rb_define_module_function(rb_mSwe4r, "swe_heliacal_range", t_swe_heliacal_range, -1);
+	rb_define_module_function(rb_mSwe4r, "swe_heliacal_stats", t_swe_heliacal_stats, 0);
 	rb_define_module_function(rb_mSwe4r, "swe_set_sid_mode", t_swe_set_sid_mode, 3);
 	rb_define_module_function(rb_mSwe4r, "swe_get_ayanamsa_ut", t_swe_get_ayanamsa_ut, 1);
 	rb_define_module_function(rb_mSwe4r, "swe_houses", t_swe_houses, 4);
+	rb_define_module_function(rb_mSwe4r, "swe_houses_into", t_swe_houses_into, 5);
 	rb_define_module_function(rb_mSwe4r, "swe_houses_ex2", t_swe_houses_ex2, 5);
+	rb_define_module_function(rb_mSwe4r, "swe_houses_ex2_into", t_swe_houses_ex2_into, 6);
 	rb_define_module_function(rb_mSwe4r, "swe_get_ayanamsa_ex_ut", t_swe_get_ayanamsa_ex_ut, 2);
 	rb_define_module_function(rb_mSwe4r, "swe_rise_trans", t_swe_rise_trans, 9);
 	rb_define_module_function(rb_mSwe4r, "swe_rise_trans_true_hor", t_swe_rise_trans_true_hor, 10);
+	rb_define_module_function(rb_mSwe4r, "swe_refrac_extended", t_swe_refrac_extended, 6);
 	rb_define_module_function(rb_mSwe4r, "swe_azalt", t_swe_azalt, 10);
+	rb_define_module_function(rb_mSwe4r, "swe_azalt_into", t_swe_azalt_into, 11);
+	rb_define_module_function(rb_mSwe4r, "swe_azalt_arr", t_swe_azalt_arr, 8);
+	rb_define_module_function(rb_mSwe4r, "swe_azalt_times", t_swe_azalt_times, 8);
+	rb_define_module_function(rb_mSwe4r, "swe_nod_aps", t_swe_nod_aps, 4);
+	rb_define_module_function(rb_mSwe4r, "swe_nod_aps_arr", t_swe_nod_aps_arr, 4);
+	rb_define_module_function(rb_mSwe4r, "swe_nod_aps_times", t_swe_nod_aps_times, 4);
+	rb_define_module_function(rb_mSwe4r, "swe_get_orbital_elements_arr", t_swe_get_orbital_elements_arr, 3);
+	rb_define_module_function(rb_mSwe4r, "swe_orbit_max_min_true_distance_arr", t_swe_orbit_max_min_true_distance_arr, 3);
+	rb_define_module_function(rb_mSwe4r, "swe_pheno_ut", t_swe_pheno_ut, 3);
+	rb_define_module_function(rb_mSwe4r, "swe_pheno_ut_arr", t_swe_pheno_ut_arr, 3);
+	rb_define_module_function(rb_mSwe4r, "swe_gauquelin_sector", t_swe_gauquelin_sector, 9);
+	rb_define_module_function(rb_mSwe4r, "swe_gauquelin_sector_arr", t_swe_gauquelin_sector_arr, 8);
 	rb_define_module_function(rb_mSwe4r, "swe_cotrans", t_swe_cotrans, -1);
 	rb_define_module_function(rb_mSwe4r, "swe_house_pos", t_swe_house_pos, 6);
 
@@ -537,6 +1889,8 @@ void Init_swe4r()
 
 	rb_define_const(rb_mSwe4r, "SE_INTP_APOG", INT2FIX(SE_INTP_APOG));
 	rb_define_const(rb_mSwe4r, "SE_INTP_PERG", INT2FIX(SE_INTP_PERG));
+	rb_define_const(rb_mSwe4r, "SE_AST_OFFSET", INT2FIX(SE_AST_OFFSET));
+	rb_define_const(rb_mSwe4r, "SE_FICT_OFFSET", INT2FIX(SE_FICT_OFFSET));
 
 	rb_define_const(rb_mSwe4r, "SEFLG_JPLEPH", INT2FIX(SEFLG_JPLEPH));
 	rb_define_const(rb_mSwe4r, "SEFLG_SWIEPH", INT2FIX(SEFLG_SWIEPH));
@@ -556,6 +1910,7 @@ void Init_swe4r()
 	rb_define_const(rb_mSwe4r, "SEFLG_TOPOCTR", INT2FIX(SEFLG_TOPOCTR));
 	rb_define_const(rb_mSwe4r, "SEFLG_SIDEREAL", INT2FIX(SEFLG_SIDEREAL));
 	rb_define_const(rb_mSwe4r, "SEFLG_ICRS", INT2FIX(SEFLG_ICRS));
+	rb_define_const(rb_mSwe4r, "SEFLG_ORBEL_AA", INT2FIX(SEFLG_ORBEL_AA));
 
 	/* sidereal modes (ayanamsas) */
 	rb_define_const(rb_mSwe4r, "SE_SIDM_FAGAN_BRADLEY", INT2FIX(SE_SIDM_FAGAN_BRADLEY)); // 0
@@ -613,6 +1968,14 @@ void Init_swe4r()
 
 	rb_define_const(rb_mSwe4r, "SE_ECL2HOR", INT2FIX(SE_ECL2HOR));
 	rb_define_const(rb_mSwe4r, "SE_EQU2HOR", INT2FIX(SE_EQU2HOR));
+	rb_define_const(rb_mSwe4r, "SE_TRUE_TO_APP", INT2FIX(SE_TRUE_TO_APP));
+	rb_define_const(rb_mSwe4r, "SE_APP_TO_TRUE", INT2FIX(SE_APP_TO_TRUE));
+	rb_define_const(rb_mSwe4r, "SE_REFRAC_TABLE", INT2FIX(SE_REFRAC_TABLE));
+
+	rb_define_const(rb_mSwe4r, "SE_NODBIT_MEAN", INT2FIX(SE_NODBIT_MEAN));
+	rb_define_const(rb_mSwe4r, "SE_NODBIT_OSCU", INT2FIX(SE_NODBIT_OSCU));
+	rb_define_const(rb_mSwe4r, "SE_NODBIT_OSCU_BAR", INT2FIX(SE_NODBIT_OSCU_BAR));
+	rb_define_const(rb_mSwe4r, "SE_NODBIT_FOPOINT", INT2FIX(SE_NODBIT_FOPOINT));
 
 
 	rb_define_const(rb_mSwe4r, "SE_CALC_RISE", INT2FIX(SE_CALC_RISE));
@@ -628,4 +1991,52 @@ void Init_swe4r()
 	rb_define_const(rb_mSwe4r, "SE_BIT_ASTRO_TWILIGHT", INT2FIX(SE_BIT_ASTRO_TWILIGHT));
 	rb_define_const(rb_mSwe4r, "SE_BIT_FIXED_DISC_SIZE", INT2FIX(SE_BIT_FIXED_DISC_SIZE));
 	rb_define_const(rb_mSwe4r, "SE_BIT_HINDU_RISING", INT2FIX(SE_BIT_HINDU_RISING));
+
+	// Eclipse types
+	rb_define_const(rb_mSwe4r, "SE_ECL_CENTRAL", INT2FIX(SE_ECL_CENTRAL));
+	rb_define_const(rb_mSwe4r, "SE_ECL_NONCENTRAL", INT2FIX(SE_ECL_NONCENTRAL));
+	rb_define_const(rb_mSwe4r, "SE_ECL_TOTAL", INT2FIX(SE_ECL_TOTAL));
+	rb_define_const(rb_mSwe4r, "SE_ECL_ANNULAR", INT2FIX(SE_ECL_ANNULAR));
+	rb_define_const(rb_mSwe4r, "SE_ECL_PARTIAL", INT2FIX(SE_ECL_PARTIAL));
+	rb_define_const(rb_mSwe4r, "SE_ECL_ANNULAR_TOTAL", INT2FIX(SE_ECL_ANNULAR_TOTAL));
+	rb_define_const(rb_mSwe4r, "SE_ECL_PENUMBRAL", INT2FIX(SE_ECL_PENUMBRAL));
+	rb_define_const(rb_mSwe4r, "SE_ECL_ONE_TRY", INT2FIX(SE_ECL_ONE_TRY));
+
+	// Cache counters
+	rb_define_const(rb_mSwe4r, "SE_STAT_FOPEN", INT2FIX(SE_STAT_FOPEN));
+	rb_define_const(rb_mSwe4r, "SE_STAT_FOPEN_MISS", INT2FIX(SE_STAT_FOPEN_MISS));
+	rb_define_const(rb_mSwe4r, "SE_STAT_FOPEN_PROBE", INT2FIX(SE_STAT_FOPEN_PROBE));
+	rb_define_const(rb_mSwe4r, "SE_STAT_FOPEN_CACHED", INT2FIX(SE_STAT_FOPEN_CACHED));
+	rb_define_const(rb_mSwe4r, "SE_STAT_PREC", INT2FIX(SE_STAT_PREC));
+	rb_define_const(rb_mSwe4r, "SE_STAT_PREC_CACHED", INT2FIX(SE_STAT_PREC_CACHED));
+	rb_define_const(rb_mSwe4r, "SE_STAT_OBSERVER", INT2FIX(SE_STAT_OBSERVER));
+	rb_define_const(rb_mSwe4r, "SE_STAT_OBSERVER_CACHED", INT2FIX(SE_STAT_OBSERVER_CACHED));
+	rb_define_const(rb_mSwe4r, "SE_STAT_CALC", INT2FIX(SE_STAT_CALC));
+	rb_define_const(rb_mSwe4r, "SE_STAT_CALC_CACHED", INT2FIX(SE_STAT_CALC_CACHED));
+	rb_define_const(rb_mSwe4r, "SE_NSTATS", INT2FIX(SE_NSTATS));
+
+	// Heliacal events
+	rb_define_const(rb_mSwe4r, "SE_HELIACAL_RISING", INT2FIX(SE_HELIACAL_RISING));
+	rb_define_const(rb_mSwe4r, "SE_HELIACAL_SETTING", INT2FIX(SE_HELIACAL_SETTING));
+	rb_define_const(rb_mSwe4r, "SE_EVENING_FIRST", INT2FIX(SE_EVENING_FIRST));
+	rb_define_const(rb_mSwe4r, "SE_MORNING_LAST", INT2FIX(SE_MORNING_LAST));
+	rb_define_const(rb_mSwe4r, "SE_HELFLAG_HIGH_PRECISION", INT2FIX(SE_HELFLAG_HIGH_PRECISION));
+	rb_define_const(rb_mSwe4r, "SE_HELFLAG_REFRAC_TABLE", INT2FIX(SE_HELFLAG_REFRAC_TABLE));
+
+	// Heliacal statistics
+	rb_define_const(rb_mSwe4r, "SE_HELSTAT_TIME", INT2FIX(SE_HELSTAT_TIME));
+	rb_define_const(rb_mSwe4r, "SE_HELSTAT_TIME_CONJ", INT2FIX(SE_HELSTAT_TIME_CONJ));
+	rb_define_const(rb_mSwe4r, "SE_HELSTAT_TIME_DAY", INT2FIX(SE_HELSTAT_TIME_DAY));
+	rb_define_const(rb_mSwe4r, "SE_HELSTAT_TIME_DETAILS", INT2FIX(SE_HELSTAT_TIME_DETAILS));
+	rb_define_const(rb_mSwe4r, "SE_HELSTAT_NVISLIM", INT2FIX(SE_HELSTAT_NVISLIM));
+	rb_define_const(rb_mSwe4r, "SE_HELSTAT_NVISLIM_MEMO", INT2FIX(SE_HELSTAT_NVISLIM_MEMO));
+	rb_define_const(rb_mSwe4r, "SE_HELSTAT_NLOC", INT2FIX(SE_HELSTAT_NLOC));
+	rb_define_const(rb_mSwe4r, "SE_HELSTAT_NLOC_MEMO", INT2FIX(SE_HELSTAT_NLOC_MEMO));
+	rb_define_const(rb_mSwe4r, "SE_HELSTAT_NMAG", INT2FIX(SE_HELSTAT_NMAG));
+	rb_define_const(rb_mSwe4r, "SE_HELSTAT_NMAG_MEMO", INT2FIX(SE_HELSTAT_NMAG_MEMO));
+	rb_define_const(rb_mSwe4r, "SE_HELSTAT_NSKY", INT2FIX(SE_HELSTAT_NSKY));
+	rb_define_const(rb_mSwe4r, "SE_HELSTAT_NSKY_MEMO", INT2FIX(SE_HELSTAT_NSKY_MEMO));
+	rb_define_const(rb_mSwe4r, "SE_HELSTAT_NRISE", INT2FIX(SE_HELSTAT_NRISE));
+	rb_define_const(rb_mSwe4r, "SE_HELSTAT_NRISE_MEMO", INT2FIX(SE_HELSTAT_NRISE_MEMO));
+	rb_define_const(rb_mSwe4r, "SE_NHELSTATS", INT2FIX(SE_NHELSTATS));
 }
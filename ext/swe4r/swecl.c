@@ -71,6 +71,34 @@ static int find_zero(double y00, double y11, double y2, double dx,
 			double *dxret, double *dxret2);
 static double calc_dip(double geoalt, double atpress, double attemp, double lapse_rate);
 static double calc_astronomical_refr(double geoalt,double atpress, double attemp);
+static double calc_refr_true_to_app(double inalt, double atpress, double attemp);
+static double refr_tab_interp(double *tab, int32 n, double x);
+static void azalt_equator(double *xin, double sineps, double coseps, double *xra);
+static void azalt_horizon(double armc, double sinlat, double coslat, double *xra, double *xaz);
+static double azalt_app_alt(double trualt, double dip, double atpress, double attemp, AS_BOOL use_table);
+static void azalt_armc(double tjd_ut, double armc, int32 calc_flag, double *geopos, 
+      double atpress, double attemp, double *xin, double *xaz);
+static void azalt_rev_armc(double tjd_ut, double armc, int32 calc_flag, double *geopos, 
+      double *xin, double *xout);
+static int32 get_orbital_elements(double tjd_et, int32 ipl, int32 iflag, double *rpl, double *dret, char *serr);
+struct osc_orbit;
+static void orbit_max_min_true_distance_geo(struct osc_orbit *orbp, struct osc_orbit *orbe, double *dmax, double *dmin, double *dtrue);
+struct pheno_epoch;
+static int32 pheno(double tjd, int32 ipl, int32 iflag, struct pheno_epoch *pe, double *attr, char *serr);
+struct rise_epoch;
+struct rise_hor;
+static int32 rise_trans(double tjd_ut, int32 ipl, char *starname, int32 epheflag, int32 rsmi,
+               double *geopos, double atpress, double attemp, struct rise_epoch *re, 
+               double *tret, char *serr);
+static int32 rise_hor_init(struct rise_hor *rh, double tjd_ut, int32 ipl, char *starname,
+	       int32 epheflag, int32 rsmi, double *geopos, double atpress, double attemp,
+	       double horhgt, char *serr);
+static int32 rise_hor_heights(struct rise_hor *rh, struct rise_epoch *re, char *serr);
+static int32 rise_hor_find(struct rise_hor *rh, int32 rsmi, double *tret, char *serr);
+struct gauq_epoch;
+static int32 gauquelin_sector(double t_ut, int32 ipl, char *starname, int32 iflag, int32 imeth,
+               double *geopos, double atpress, double attemp, struct gauq_epoch *ge, 
+               double *dgsect, char *serr);
 static TLS double const_lapse_rate = SE_LAPSE_RATE;  /* for refraction */
 
 #if 0
@@ -103,6 +131,8 @@ static int32 calc_mer_trans(
                double *tret,
                char *serr); 
 static int32 calc_planet_star(double tjd_et, int32 ipl, char *starname, int32 iflag, double *x, char *serr);
+static void ecl_track_open(double tjd_et, int32 ipl, char *starname, int32 iflag);
+static int32 ecl_calc(double tjd_et, int32 ipl, char *starname, int32 iflag, double *x, char *serr);
 
 struct saros_data {int series_no; double tstart;};
 
@@ -670,16 +700,16 @@ static int32 eclipse_where( double tjd_ut, int32 ipl, char *starname, int32 ifl,
   deltat = swe_deltat_ex(tjd_ut, ifl, serr);
   tjd = tjd_ut + deltat;
   /* moon in cartesian coordinates */
-  if ((retc = swe_calc(tjd, SE_MOON, iflag, rm, serr)) == ERR)
+  if ((retc = ecl_calc(tjd, SE_MOON, NULL, iflag, rm, serr)) == ERR)
     return retc;
   /* moon in polar coordinates */
-  if ((retc = swe_calc(tjd, SE_MOON, iflag2, lm, serr)) == ERR)
+  if ((retc = ecl_calc(tjd, SE_MOON, NULL, iflag2, lm, serr)) == ERR)
     return retc;
   /* sun in cartesian coordinates */
-  if ((retc = calc_planet_star(tjd, ipl, starname, iflag, rs, serr)) == ERR)
+  if ((retc = ecl_calc(tjd, ipl, starname, iflag, rs, serr)) == ERR)
     return retc;
   /* sun in polar coordinates */
-  if ((retc = calc_planet_star(tjd, ipl, starname, iflag2, ls, serr)) == ERR)
+  if ((retc = ecl_calc(tjd, ipl, starname, iflag2, ls, serr)) == ERR)
     return retc;
   /* save sun position */
   for (i = 0; i <= 2; i++)
@@ -687,10 +717,14 @@ static int32 eclipse_where( double tjd_ut, int32 ipl, char *starname, int32 ifl,
   /* save moon position */
   for (i = 0; i <= 2; i++)
     rmt[i] = rm[i];
-  if (iflag & SEFLG_NONUT)
+  if (iflag & SEFLG_NONUT) {
+    /* the positions may come from the cache of swe_calc(), which 
+     * does not update the obliquity */
+    swi_check_ecliptic(tjd, iflag);
     sidt = swe_sidtime0(tjd_ut, oe->eps * RADTODEG, 0) * 15 * DEGTORAD;
-  else
+  } else {
     sidt = swe_sidtime(tjd_ut) * 15 * DEGTORAD;
+  }
   /*
    * radius of planet disk in AU
    */
@@ -896,6 +930,139 @@ static int32 calc_planet_star(double tjd_et, int32 ipl, char *starname, int32 if
   return retc;
 }
 
+/*
+ * Tracks of sun, moon and planets for the refinement loops of the
+ * eclipse and occultation functions, see swe_set_interpolate_ecl().
+ * Once such a loop has come close to its result, ecl_track_open()
+ * fits Chebyshev series to the positions of the body over a window
+ * of a few hours around it, and ecl_calc() evaluates them instead of 
+ * calling swe_calc() again for every step of the iteration.
+ * A track is for one body and one set of flags (apart from 
+ * SEFLG_XYZ, SEFLG_SPEED and SEFLG_RADIANS, which are applied on output),
+ * and for topocentric flags also for one geographic position.
+ * Fixed stars are not interpolated.
+ */
+#define ECL_TRACK_NCF	12	/* number of coefficients */
+#define ECL_TRACK_HALF	0.125	/* half width of window, days */
+#define ECL_TRACK_N	6
+#define ECL_TRACK_FLAGS	(SEFLG_XYZ | SEFLG_SPEED | SEFLG_RADIANS)
+struct ecl_track {
+  int32 ipl, iflag, retflag;
+  double tmid;
+  double topd[3];
+  double coef[3][ECL_TRACK_NCF];
+};
+static TLS struct {
+  struct ecl_track tr[ECL_TRACK_N];
+  int32 n, next;
+} ecltrack;
+
+void swi_ecl_track_clear(void)
+{
+  ecltrack.n = 0;
+  ecltrack.next = 0;
+}
+
+/* switches the interpolation of positions in eclipse and 
+ * occultation refinement loops on or off (default) */
+void CALL_CONV swe_set_interpolate_ecl(AS_BOOL do_interpolate)
+{
+  swed.do_interpolate_ecl = do_interpolate ? TRUE : FALSE;
+  swi_ecl_track_clear();
+}
+
+static struct ecl_track *ecl_track_find(double tjd_et, int32 ipl, int32 iflag, double margin)
+{
+  int i;
+  struct ecl_track *tr;
+  iflag &= ~ECL_TRACK_FLAGS;
+  for (i = 0; i < ecltrack.n; i++) {
+    tr = &ecltrack.tr[i];
+    if (tr->ipl != ipl || tr->iflag != iflag)
+      continue;
+    if (fabs(tjd_et - tr->tmid) > ECL_TRACK_HALF - margin)
+      continue;
+    if ((iflag & SEFLG_TOPOCTR) && (tr->topd[0] != swed.topd.geolon
+      || tr->topd[1] != swed.topd.geolat || tr->topd[2] != swed.topd.geoalt))
+      continue;
+    return tr;
+  }
+  return NULL;
+}
+
+/* fits a track to body ipl for a window around tjd_et, 
+ * unless there is one that covers most of it */
+static void ecl_track_open(double tjd_et, int32 ipl, char *starname, int32 iflag)
+{
+  int j, k;
+  double t, x[6], f[3][ECL_TRACK_NCF];
+  struct ecl_track *tr;
+  int32 retflag = 0;
+  if (!swed.do_interpolate_ecl || (starname != NULL && *starname != '\0'))
+    return;
+  if (iflag & SEFLG_SIDEREAL)
+    return;
+  if (ecl_track_find(tjd_et, ipl, iflag, ECL_TRACK_HALF / 2) != NULL)
+    return;
+  iflag = (iflag & ~ECL_TRACK_FLAGS) | SEFLG_XYZ;
+  for (k = 0; k < ECL_TRACK_NCF; k++) {
+    t = tjd_et + ECL_TRACK_HALF * cos(PI * (k + 0.5) / ECL_TRACK_NCF);
+    if ((retflag = swe_calc(t, ipl, iflag, x, NULL)) == ERR)
+      return;
+    for (j = 0; j < 3; j++)
+      f[j][k] = x[j];
+  }
+  tr = &ecltrack.tr[ecltrack.next];
+  ecltrack.next = (ecltrack.next + 1) % ECL_TRACK_N;
+  if (ecltrack.n < ECL_TRACK_N)
+    ecltrack.n++;
+  tr->ipl = ipl;
+  tr->iflag = iflag & ~ECL_TRACK_FLAGS;
+  tr->retflag = retflag & ~ECL_TRACK_FLAGS;
+  tr->tmid = tjd_et;
+  tr->topd[0] = swed.topd.geolon;
+  tr->topd[1] = swed.topd.geolat;
+  tr->topd[2] = swed.topd.geoalt;
+  for (j = 0; j < 3; j++) {
+    for (k = 0; k < ECL_TRACK_NCF; k++) {
+      double sum = 0;
+      int m;
+      for (m = 0; m < ECL_TRACK_NCF; m++)
+        sum += f[j][m] * cos(PI * k * (m + 0.5) / ECL_TRACK_NCF);
+      tr->coef[j][k] = sum * 2 / ECL_TRACK_NCF;
+    }
+  }
+}
+
+/* like calc_planet_star(), but from a track, if there is one */
+static int32 ecl_calc(double tjd_et, int32 ipl, char *starname, int32 iflag, double *x, char *serr)
+{
+  int j;
+  double u;
+  struct ecl_track *tr;
+  if (ecltrack.n == 0 || (starname != NULL && *starname != '\0')
+    || (tr = ecl_track_find(tjd_et, ipl, iflag, 0)) == NULL)
+    return calc_planet_star(tjd_et, ipl, starname, iflag, x, serr);
+  u = (tjd_et - tr->tmid) / ECL_TRACK_HALF;
+  for (j = 0; j < 3; j++) {
+    x[j] = swi_echeb(u, tr->coef[j], ECL_TRACK_NCF);
+    if (iflag & SEFLG_SPEED)
+      x[j+3] = swi_edcheb(u, tr->coef[j], ECL_TRACK_NCF) / ECL_TRACK_HALF;
+    else
+      x[j+3] = 0;
+  }
+  if (!(iflag & SEFLG_XYZ)) {
+    swi_cartpol_sp(x, x);
+    if (!(iflag & SEFLG_RADIANS)) {
+      for (j = 0; j < 2; j++) {
+        x[j] *= RADTODEG;
+        x[j+3] *= RADTODEG;
+      }
+    }
+  }
+  return tr->retflag | (iflag & ECL_TRACK_FLAGS);
+}
+
 /* Computes attributes of a solar eclipse for given tjd, geo. longitude, 
  * geo. latitude, and geo. height.
  * 
@@ -964,6 +1131,38 @@ int32 CALL_CONV swe_sol_eclipse_how(
 }
 
 #define USE_AZ_NAV 0
+/* 
+ * fraction of the solar disc (radius lsun) obscured by the moon (radius
+ * lmoon) at distance lctr between the centres; retc is the eclipse type
+ */
+static double ecl_obscuration(double lsun, double lmoon, double lctr, int32 retc)
+{
+  double a, b, sc1, sc2;
+  if (retc == 0 || lsun == 0) {
+    //return 100;
+    return 1;
+  } else if (retc == SE_ECL_TOTAL || retc == SE_ECL_ANNULAR) {
+    return lmoon * lmoon / lsun / lsun;
+  } 
+  a = 2 * lctr * lmoon;
+  b = 2 * lctr * lsun;
+  if (a < 1e-9) 
+    return lmoon * lmoon / lsun / lsun;
+  a = (lctr * lctr + lmoon * lmoon - lsun * lsun) / a;
+  if (a > 1) a = 1;
+  if (a < -1) a = -1;
+  b = (lctr * lctr + lsun * lsun - lmoon * lmoon) / b;
+  if (b > 1) b = 1;
+  if (b < -1) b = -1;
+  a = acos(a);
+  b = acos(b);
+  sc1 = a * lmoon * lmoon / 2;
+  sc2 = b * lsun * lsun / 2;
+  sc1 -= (cos(a) * sin(a)) * lmoon * lmoon / 2;
+  sc2 -= (cos(b) * sin(b)) * lsun * lsun / 2;
+  return (sc1 + sc2) * 2 / PI / lsun / lsun;
+}
+
 static int32 eclipse_how( double tjd_ut, int32 ipl, char *starname, int32 ifl,
           double geolon, double geolat, double geohgt,
           double *attr, char *serr)
@@ -981,7 +1180,7 @@ static int32 eclipse_how( double tjd_ut, int32 ipl, char *starname, int32 ifl,
   double mdd, eps, sidt, armc;
 #endif
   double xh[6], hmin_appr;
-  double lsun, lmoon, lctr, lsunleft, a, b, sc1, sc2;
+  double lsun, lsunleft;
   double geopos[3];
   for (i = 0; i < 10; i++)
     attr[i] = 0;
@@ -1076,35 +1275,7 @@ static int32 eclipse_how( double tjd_ut, int32 ipl, char *starname, int32 ifl,
    * obscuration:
    * fraction of solar disc obscured by moon
    */
-  lsun = rsun;
-  lmoon = rmoon;
-  lctr = dctr;
-  if (retc == 0 || lsun == 0) {
-    //attr[2] = 100;
-    attr[2] = 1;
-  } else if (retc == SE_ECL_TOTAL || retc == SE_ECL_ANNULAR) {
-    attr[2] = lmoon * lmoon / lsun / lsun;
-  } else {
-    a = 2 * lctr * lmoon;
-    b = 2 * lctr * lsun;
-    if (a < 1e-9) {
-      attr[2] = lmoon * lmoon / lsun / lsun;
-    } else {
-      a = (lctr * lctr + lmoon * lmoon - lsun * lsun) / a;
-      if (a > 1) a = 1;
-      if (a < -1) a = -1;
-      b = (lctr * lctr + lsun * lsun - lmoon * lmoon) / b;
-      if (b > 1) b = 1;
-      if (b < -1) b = -1;
-      a = acos(a);
-      b = acos(b);
-      sc1 = a * lmoon * lmoon / 2;
-      sc2 = b * lsun * lsun / 2;
-      sc1 -= (cos(a) * sin(a)) * lmoon * lmoon / 2;
-      sc2 -= (cos(b) * sin(b)) * lsun * lsun / 2;
-      attr[2] = (sc1 + sc2) * 2 / PI / lsun / lsun;
-    }
-  }
+  attr[2] = ecl_obscuration(rsun, rmoon, dctr, retc);
   attr[7] = dctr;
   /* approximate minimum height for visibility, considering
    * refraction and dip
@@ -1301,6 +1472,11 @@ next_try:
   tjds = tjd - swe_deltat_ex(tjd, ifl, serr);
   tjds = tjd - swe_deltat_ex(tjds, ifl, serr);
   tjds = tjd = tjd - swe_deltat_ex(tjds, ifl, serr);
+  /* eclipse_where() will be called many times during the eclipse */
+  tjds = tjd + swe_deltat_ex(tjd, ifl, serr);
+  ecl_track_open(tjds, SE_SUN, NULL, SEFLG_EQUATORIAL | ifl);
+  ecl_track_open(tjds, SE_MOON, NULL, SEFLG_EQUATORIAL | ifl);
+  tjds = tjd;
   if ((retflag = eclipse_where(tjd, SE_SUN, NULL, ifl, geopos, dcore, serr)) == ERR)
     return retflag;
   retflag2 = retflag;
@@ -1715,6 +1891,8 @@ next_try:
     find_maximum(dc[0], dc[1], dc[2], dt, &dtint, &dctr);
     tjd += dtint + dt;
   }
+  ecl_track_open(tjd, ipl, starname, SEFLG_EQUATORIAL | ifl);
+  ecl_track_open(tjd, SE_MOON, NULL, SEFLG_EQUATORIAL | ifl);
   tjd -= swe_deltat_ex(tjd, ifl, serr);
   tjds = tjd;
   if ((retflag = eclipse_where(tjd, ipl, starname, ifl, geopos, dcore, serr)) == ERR)
@@ -2171,16 +2349,22 @@ next_try:
        dt /= dtdiv) {
     if (dt < 0.1) 
       dtdiv = 3;
+    /* close to the maximum, positions for the rest of the
+     * search can be interpolated */
+    if (dt < 0.05) {
+      ecl_track_open(tjd, SE_SUN, NULL, iflag);
+      ecl_track_open(tjd, SE_MOON, NULL, iflag);
+    }
     for (i = 0, t = tjd - dt; i <= 2; i++, t += dt) {
       /* this takes some time, but is necessary to avoid
        * missing an eclipse */
-      if (swe_calc(t, SE_SUN, iflagcart, xs, serr) == ERR)
+      if (ecl_calc(t, SE_SUN, NULL, iflagcart, xs, serr) == ERR)
         return ERR;
-      if (swe_calc(t, SE_SUN, iflag, ls, serr) == ERR)
+      if (ecl_calc(t, SE_SUN, NULL, iflag, ls, serr) == ERR)
         return ERR;
-      if (swe_calc(t, SE_MOON, iflagcart, xm, serr) == ERR)
+      if (ecl_calc(t, SE_MOON, NULL, iflagcart, xm, serr) == ERR)
         return ERR;
-      if (swe_calc(t, SE_MOON, iflag, lm, serr) == ERR)
+      if (ecl_calc(t, SE_MOON, NULL, iflag, lm, serr) == ERR)
         return ERR;
       dm = sqrt(square_sum(xm));
       ds = sqrt(square_sum(xs));
@@ -2193,13 +2377,13 @@ next_try:
     find_maximum(dc[0], dc[1], dc[2], dt, &dtint, &dctr);
     tjd += dtint + dt;
   }
-  if (swe_calc(tjd, SE_SUN, iflagcart, xs, serr) == ERR)
+  if (ecl_calc(tjd, SE_SUN, NULL, iflagcart, xs, serr) == ERR)
         return ERR;
-  if (swe_calc(tjd, SE_SUN, iflag, ls, serr) == ERR)
+  if (ecl_calc(tjd, SE_SUN, NULL, iflag, ls, serr) == ERR)
         return ERR;
-  if (swe_calc(tjd, SE_MOON, iflagcart, xm, serr) == ERR)
+  if (ecl_calc(tjd, SE_MOON, NULL, iflagcart, xm, serr) == ERR)
         return ERR;
-  if (swe_calc(tjd, SE_MOON, iflag, lm, serr) == ERR)
+  if (ecl_calc(tjd, SE_MOON, NULL, iflag, lm, serr) == ERR)
         return ERR;
   dctr = acos(swi_dot_prod_unit(xs, xm)) * RADTODEG;
   rmoon = asin(RMOON / lm[2]) * RADTODEG;
@@ -2236,9 +2420,9 @@ next_try:
   else {
     dc[1] = fabs(rsminusrm) - dctrmin;
     for (i = 0, t = tjd - twomin; i <= 2; i += 2, t = tjd + twomin) {
-      if (swe_calc(t, SE_SUN, iflagcart, xs, serr) == ERR)
+      if (ecl_calc(t, SE_SUN, NULL, iflagcart, xs, serr) == ERR)
         return ERR;
-      if (swe_calc(t, SE_MOON, iflagcart, xm, serr) == ERR)
+      if (ecl_calc(t, SE_MOON, NULL, iflagcart, xm, serr) == ERR)
         return ERR;
       dm = sqrt(square_sum(xm));
       ds = sqrt(square_sum(xs));
@@ -2258,9 +2442,9 @@ next_try:
     tret[3] = tjd + dt2 + twomin;
     for (m = 0, dt = tensec; m < 2; m++, dt /= 10) {
       for (j = 2; j <= 3; j++) {
-        if (swe_calc(tret[j], SE_SUN, iflagcart | SEFLG_SPEED, xs, serr) == ERR)
+        if (ecl_calc(tret[j], SE_SUN, NULL, iflagcart | SEFLG_SPEED, xs, serr) == ERR)
           return ERR;
-        if (swe_calc(tret[j], SE_MOON, iflagcart | SEFLG_SPEED, xm, serr) == ERR)
+        if (ecl_calc(tret[j], SE_MOON, NULL, iflagcart | SEFLG_SPEED, xm, serr) == ERR)
           return ERR;
         for (i = 0; i < 2; i++) {
           if (i == 1) {
@@ -2292,9 +2476,9 @@ next_try:
   /* contacts 1 and 4 */
   dc[1] = rsplusrm - dctrmin;
   for (i = 0, t = tjd - twohr; i <= 2; i += 2, t = tjd + twohr) {
-    if (swe_calc(t, SE_SUN, iflagcart, xs, serr) == ERR)
+    if (ecl_calc(t, SE_SUN, NULL, iflagcart, xs, serr) == ERR)
       return ERR;
-    if (swe_calc(t, SE_MOON, iflagcart, xm, serr) == ERR)
+    if (ecl_calc(t, SE_MOON, NULL, iflagcart, xm, serr) == ERR)
       return ERR;
     dm = sqrt(square_sum(xm));
     ds = sqrt(square_sum(xs));
@@ -2313,9 +2497,9 @@ next_try:
   tret[4] = tjd + dt2 + twohr;
   for (m = 0, dt = tenmin; m < 3; m++, dt /= 10) {
     for (j = 1; j <= 4; j += 3) {
-      if (swe_calc(tret[j], SE_SUN, iflagcart | SEFLG_SPEED, xs, serr) == ERR)
+      if (ecl_calc(tret[j], SE_SUN, NULL, iflagcart | SEFLG_SPEED, xs, serr) == ERR)
         return ERR;
-      if (swe_calc(tret[j], SE_MOON, iflagcart | SEFLG_SPEED, xm, serr) == ERR)
+      if (ecl_calc(tret[j], SE_MOON, NULL, iflagcart | SEFLG_SPEED, xm, serr) == ERR)
         return ERR;
       for (i = 0; i < 2; i++) {
         if (i == 1) {
@@ -2448,7 +2632,7 @@ static int32 occult_when_loc(
   tjd = tjd_start;
 next_try:
   //is_partial = FALSE;
-  if (calc_planet_star(t, ipl, starname, iflaggeo, ls, serr) == ERR)
+  if (ecl_calc(t, ipl, starname, iflaggeo, ls, serr) == ERR)
       return ERR;
   /* fixed stars with an ecliptic latitude > 7  or < -7 cannot have 
    * an occultation. Even lunar parallax andd proper motion of star
@@ -2458,7 +2642,7 @@ next_try:
       sprintf(serr, "occultation never occurs: star %s has ecl. lat. %.1f", starname, ls[1]);
     return ERR;
   }
-  if (swe_calc(t, SE_MOON, iflaggeo, lm, serr) == ERR)
+  if (ecl_calc(t, SE_MOON, NULL, iflaggeo, lm, serr) == ERR)
       return ERR;
   dl = swe_degnorm(ls[0] - lm[0]);
   if (direction < 0)
@@ -2466,9 +2650,9 @@ next_try:
   /* get rough conjunction in ecliptic longitude */
   while (fabs(dl) > 0.1) {
     t += dl / 13;
-    if (calc_planet_star(t, ipl, starname, iflaggeo, ls, serr) == ERR)
+    if (ecl_calc(t, ipl, starname, iflaggeo, ls, serr) == ERR)
 	return ERR;
-    if (swe_calc(t, SE_MOON, iflaggeo, lm, serr) == ERR)
+    if (ecl_calc(t, SE_MOON, NULL, iflaggeo, lm, serr) == ERR)
 	return ERR;
     dl = swe_degnorm(ls[0] - lm[0]);
     if (dl > 180) dl -= 360;
@@ -2504,16 +2688,20 @@ next_try:
        dt /= dtdiv) {
     if (dt < 0.01) 
       dtdiv = 2;
+    if (dt < 0.05) {
+      ecl_track_open(tjd, ipl, starname, iflag);
+      ecl_track_open(tjd, SE_MOON, NULL, iflag);
+    }
     for (i = 0, t = tjd - dt; i <= 2; i++, t += dt) {
       /* this takes some time, but is necessary to avoid
        * missing an eclipse */
-      if (calc_planet_star(t, ipl, starname, iflagcart, xs, serr) == ERR)
+      if (ecl_calc(t, ipl, starname, iflagcart, xs, serr) == ERR)
         return ERR;
-      if (calc_planet_star(t, ipl, starname, iflag, ls, serr) == ERR)
+      if (ecl_calc(t, ipl, starname, iflag, ls, serr) == ERR)
         return ERR;
-      if (swe_calc(t, SE_MOON, iflagcart, xm, serr) == ERR)
+      if (ecl_calc(t, SE_MOON, NULL, iflagcart, xm, serr) == ERR)
         return ERR;
-      if (swe_calc(t, SE_MOON, iflag, lm, serr) == ERR)
+      if (ecl_calc(t, SE_MOON, NULL, iflag, lm, serr) == ERR)
         return ERR;
       if (dt < 0.1 && fabs(ls[1] - lm[1]) > 2) {
         if (one_try || stop_after_this) {
@@ -2537,13 +2725,13 @@ next_try:
     tret[0] = tjd + direction;  /* return a date suitable for next try */
     return 0;
   }
-  if (calc_planet_star(tjd, ipl, starname, iflagcart, xs, serr) == ERR)
+  if (ecl_calc(tjd, ipl, starname, iflagcart, xs, serr) == ERR)
         return ERR;
-  if (calc_planet_star(tjd, ipl, starname, iflag, ls, serr) == ERR)
+  if (ecl_calc(tjd, ipl, starname, iflag, ls, serr) == ERR)
         return ERR;
-  if (swe_calc(tjd, SE_MOON, iflagcart, xm, serr) == ERR)
+  if (ecl_calc(tjd, SE_MOON, NULL, iflagcart, xm, serr) == ERR)
         return ERR;
-  if (swe_calc(tjd, SE_MOON, iflag, lm, serr) == ERR)
+  if (ecl_calc(tjd, SE_MOON, NULL, iflag, lm, serr) == ERR)
         return ERR;
   dctr = acos(swi_dot_prod_unit(xs, xm)) * RADTODEG;
   rmoon = asin(RMOON / lm[2]) * RADTODEG;
@@ -2587,9 +2775,9 @@ next_try:
   } else {
     dc[1] = fabs(rsminusrm) - dctrmin;
     for (i = 0, t = tjd - twomin; i <= 2; i += 2, t = tjd + twomin) {
-      if (calc_planet_star(t, ipl, starname, iflagcart, xs, serr) == ERR)
+      if (ecl_calc(t, ipl, starname, iflagcart, xs, serr) == ERR)
         return ERR;
-      if (swe_calc(t, SE_MOON, iflagcart, xm, serr) == ERR)
+      if (ecl_calc(t, SE_MOON, NULL, iflagcart, xm, serr) == ERR)
         return ERR;
       dm = sqrt(square_sum(xm));
       ds = sqrt(square_sum(xs));
@@ -2609,9 +2797,9 @@ next_try:
     tret[3] = tjd + dt2 + twomin;
     for (m = 0, dt = tensec; m < 2; m++, dt /= 10) {
       for (j = 2; j <= 3; j++) {
-        if (calc_planet_star(tret[j], ipl, starname, iflagcart | SEFLG_SPEED, xs, serr) == ERR)
+        if (ecl_calc(tret[j], ipl, starname, iflagcart | SEFLG_SPEED, xs, serr) == ERR)
           return ERR;
-        if (swe_calc(tret[j], SE_MOON, iflagcart | SEFLG_SPEED, xm, serr) == ERR)
+        if (ecl_calc(tret[j], SE_MOON, NULL, iflagcart | SEFLG_SPEED, xm, serr) == ERR)
           return ERR;
         for (i = 0; i < 2; i++) {
           if (i == 1) {
@@ -2645,9 +2833,9 @@ next_try:
   dc[1] = rsplusrm - dctrmin;
 if (starname == NULL || *starname == '\0') {
   for (i = 0, t = tjd - twohr; i <= 2; i += 2, t = tjd + twohr) {
-    if (calc_planet_star(t, ipl, starname, iflagcart, xs, serr) == ERR)
+    if (ecl_calc(t, ipl, starname, iflagcart, xs, serr) == ERR)
       return ERR;
-    if (swe_calc(t, SE_MOON, iflagcart, xm, serr) == ERR)
+    if (ecl_calc(t, SE_MOON, NULL, iflagcart, xm, serr) == ERR)
       return ERR;
     dm = sqrt(square_sum(xm));
     ds = sqrt(square_sum(xs));
@@ -2666,9 +2854,9 @@ if (starname == NULL || *starname == '\0') {
   tret[4] = tjd + dt2 + twohr;
   for (m = 0, dt = tenmin; m < 3; m++, dt /= 10) {
     for (j = 1; j <= 4; j += 3) {
-      if (calc_planet_star(tret[j], ipl, starname, iflagcart | SEFLG_SPEED, xs, serr) == ERR)
+      if (ecl_calc(tret[j], ipl, starname, iflagcart | SEFLG_SPEED, xs, serr) == ERR)
         return ERR;
-      if (swe_calc(tret[j], SE_MOON, iflagcart | SEFLG_SPEED, xm, serr) == ERR)
+      if (ecl_calc(tret[j], SE_MOON, NULL, iflagcart | SEFLG_SPEED, xm, serr) == ERR)
         return ERR;
       for (i = 0; i < 2; i++) {
         if (i == 1) {
@@ -2795,11 +2983,21 @@ void CALL_CONV swe_azalt(
       double attemp,
       double *xin, 
       double *xaz) 
+{
+  double armc = swe_degnorm(swe_sidtime(tjd_ut) * 15 + geopos[0]);
+  azalt_armc(tjd_ut, armc, calc_flag, geopos, atpress, attemp, xin, xaz);
+}
+
+/* swe_azalt() for a given armc, i.e. sidereal time at tjd_ut 
+ * plus geographic longitude */
+static void azalt_armc(double tjd_ut, double armc, int32 calc_flag, double *geopos, 
+      double atpress, double attemp, double *xin, double *xaz)
 {
   int i;
   double x[6], xra[3];
-  double armc = swe_degnorm(swe_sidtime(tjd_ut) * 15 + geopos[0]);
   double mdd, eps_true;
+  int32 refr_flag = SE_TRUE_TO_APP | (calc_flag & SE_REFRAC_TABLE);
+  calc_flag &= ~SE_REFRAC_TABLE;
   for (i = 0; i < 2; i++)
     xra[i] = xin[i];
   xra[2] = 1;
@@ -2822,7 +3020,7 @@ void CALL_CONV swe_azalt(
     /* estimate atmospheric pressure */
     atpress = 1013.25 * pow(1 - 0.0065 * geopos[2] / 288, 5.255);
   } 
-  xaz[2] = swe_refrac_extended(x[1], geopos[2], atpress, attemp, const_lapse_rate, SE_TRUE_TO_APP, NULL);
+  xaz[2] = swe_refrac_extended(x[1], geopos[2], atpress, attemp, const_lapse_rate, refr_flag, NULL);
   /* xaz[2] = swe_refrac_extended(xaz[2], geopos[2], atpress, attemp, const_lapse_rate, SE_APP_TO_TRUE, NULL);*/
 }
 
@@ -2844,13 +3042,20 @@ void CALL_CONV swe_azalt_rev(
       double *geopos,
       double *xin, 
       double *xout) 
+{
+  double armc = swe_degnorm(swe_sidtime(tjd_ut) * 15 + geopos[0]);
+  azalt_rev_armc(tjd_ut, armc, calc_flag, geopos, xin, xout);
+}
+
+/* swe_azalt_rev() for a given armc */
+static void azalt_rev_armc(double tjd_ut, double armc, int32 calc_flag, double *geopos, 
+      double *xin, double *xout)
 {
   int i;
   double x[6], xaz[3];
-  double geolon = geopos[0];
   double geolat = geopos[1];
-  double armc = swe_degnorm(swe_sidtime(tjd_ut) * 15 + geolon);
   double eps_true, dang;
+  calc_flag &= ~SE_REFRAC_TABLE;  /* no refraction here */
   for (i = 0; i < 2; i++)
     xaz[i] = xin[i];
   xaz[2] = 1;
@@ -2874,6 +3079,137 @@ void CALL_CONV swe_azalt_rev(
   }
 }
 
+/*
+ * Array versions of swe_azalt()
+ *
+ * swe_azalt_arr() converts n positions xin[3 * i + 0 .. 2] for one date 
+ * and place; sidereal time, obliquity and the refraction setup are
+ * computed once.
+ * swe_azalt_times() converts one position per date, xin[3 * i + 0 .. 2]
+ * for tjd_ut[i], e.g. a body along its path across the sky.
+ * Both return xaz[3 * i + 0 .. 2] = azimuth, true altitude, apparent 
+ * altitude, as swe_azalt() does; the results agree with it to 1e-10 
+ * degrees.
+ */
+void CALL_CONV swe_azalt_arr(
+      double tjd_ut,
+      int32  calc_flag,
+      double *geopos,
+      double atpress,
+      double attemp,
+      double *xin, 
+      int32  n,
+      double *xaz) 
+{
+  int32 i;
+  double x[6], xra[2], sineps = 0, coseps = 1;
+  double armc = swe_degnorm(swe_sidtime(tjd_ut) * 15 + geopos[0]);
+  double singlat = sin(geopos[1] * DEGTORAD), cosglat = cos(geopos[1] * DEGTORAD);
+  double dip;
+  AS_BOOL use_table = (calc_flag & SE_REFRAC_TABLE) != 0;
+  calc_flag &= ~SE_REFRAC_TABLE;
+  if (calc_flag == SE_ECL2HOR) {
+    swe_calc(tjd_ut + swe_deltat_ex(tjd_ut, -1, NULL), SE_ECL_NUT, 0, x, NULL);
+    sineps = sin(x[0] * DEGTORAD);
+    coseps = cos(x[0] * DEGTORAD);
+  }
+  if (atpress == 0) 
+    atpress = 1013.25 * pow(1 - 0.0065 * geopos[2] / 288, 5.255);
+  dip = calc_dip(geopos[2], atpress, attemp, const_lapse_rate);
+  /* geometry, without branches */
+  for (i = 0; i < n; i++) {
+    azalt_equator(xin + 3 * i, sineps, coseps, xra);
+    azalt_horizon(armc, singlat, cosglat, xra, xaz + 3 * i);
+  }
+  for (i = 0; i < n; i++)
+    xaz[3 * i + 2] = azalt_app_alt(xaz[3 * i + 1], dip, atpress, attemp, use_table);
+}
+
+void CALL_CONV swe_azalt_times(
+      double *tjd_ut,
+      int32  n,
+      int32  calc_flag,
+      double *geopos,
+      double atpress,
+      double attemp,
+      double *xin, 
+      double *xaz) 
+{
+  int32 i;
+  double tjde, eps, nutlo[2], xra[2], armc, sineps = 0, coseps = 1;
+  double singlat = sin(geopos[1] * DEGTORAD), cosglat = cos(geopos[1] * DEGTORAD);
+  double dip;
+  AS_BOOL use_table = (calc_flag & SE_REFRAC_TABLE) != 0;
+  calc_flag &= ~SE_REFRAC_TABLE;
+  if (atpress == 0) 
+    atpress = 1013.25 * pow(1 - 0.0065 * geopos[2] / 288, 5.255);
+  dip = calc_dip(geopos[2], atpress, attemp, const_lapse_rate);
+  swi_init_swed_if_start();
+  for (i = 0; i < n; i++) {
+    /* one nutation for both sidereal time and true obliquity, 
+     * as swe_sidtime() and swe_calc(SE_ECL_NUT) compute them */
+    tjde = tjd_ut[i] + swe_deltat_ex(tjd_ut[i], -1, NULL);
+    eps = swi_epsiln(tjde, 0) * RADTODEG;
+    swi_nutation(tjde, 0, nutlo);
+    nutlo[0] *= RADTODEG;
+    nutlo[1] *= RADTODEG;
+    armc = swe_degnorm(swe_sidtime0(tjd_ut[i], eps + nutlo[1], nutlo[0]) * 15 + geopos[0]);
+    if (calc_flag == SE_ECL2HOR) {
+      sineps = sin((eps + nutlo[1]) * DEGTORAD);
+      coseps = cos((eps + nutlo[1]) * DEGTORAD);
+    }
+    azalt_equator(xin + 3 * i, sineps, coseps, xra);
+    azalt_horizon(armc, singlat, cosglat, xra, xaz + 3 * i);
+  }
+  for (i = 0; i < n; i++)
+    xaz[3 * i + 2] = azalt_app_alt(xaz[3 * i + 1], dip, atpress, attemp, use_table);
+}
+
+/* right ascension and declination xra[0..1] of ecliptic position xin,
+ * for obliquity with sine sineps and cosine coseps (sineps = 0 leaves
+ * equatorial input unchanged) */
+static void azalt_equator(double *xin, double sineps, double coseps, double *xra)
+{
+  double sinlon = sin(xin[0] * DEGTORAD), coslon = cos(xin[0] * DEGTORAD);
+  double sinlat = sin(xin[1] * DEGTORAD), coslat = cos(xin[1] * DEGTORAD);
+  double x = coslon * coslat;
+  double y = sinlon * coslat * coseps - sinlat * sineps;
+  double z = sinlat * coseps + sinlon * coslat * sineps;
+  xra[0] = atan2(y, x) * RADTODEG;
+  xra[1] = atan2(z, sqrt(x * x + y * y)) * RADTODEG;
+}
+
+/* azimuth (from south, clockwise) and true altitude of a body at
+ * right ascension and declination xra[0..1], for sidereal time armc 
+ * and geographic latitude with sine sinlat and cosine coslat */
+static void azalt_horizon(double armc, double sinlat, double coslat, double *xra, double *xaz)
+{
+  double ha = (armc - xra[0]) * DEGTORAD;
+  double sinha = sin(ha), cosha = cos(ha);
+  double sinde = sin(xra[1] * DEGTORAD), cosde = cos(xra[1] * DEGTORAD);
+  double x = cosde * cosha * sinlat - sinde * coslat;
+  double y = cosde * sinha;
+  double z = sinde * sinlat + cosde * cosha * coslat;
+  xaz[0] = swe_degnorm(atan2(y, x) * RADTODEG);
+  xaz[1] = atan2(z, sqrt(x * x + y * y)) * RADTODEG;
+}
+
+/* apparent altitude for true altitude trualt, 
+ * same as swe_refrac_extended(..., SE_TRUE_TO_APP, NULL) */
+static double azalt_app_alt(double trualt, double dip, double atpress, double attemp, AS_BOOL use_table)
+{
+  double refr;
+  if (trualt < -10)
+    return trualt;
+  if (use_table)
+    refr = swi_refrac_table(trualt, atpress, attemp, SE_TRUE_TO_APP);
+  else
+    refr = calc_refr_true_to_app(trualt, atpress, attemp);
+  if (trualt + refr < dip)
+    return trualt;
+  return trualt + refr;
+}
+
 /* swe_refrac()
  * Transforms apparent to true altitude and vice-versa.
  * These formulae do not handle the case when the
@@ -3033,14 +3369,17 @@ void CALL_CONV swe_set_lapse_rate(double lapse_rate)
  * - the input altitude otherwise
  *
  * The body is above the horizon if the dret[0] != dret[1]
+ *
+ * With SE_REFRAC_TABLE or'ed to calc_flag, the refraction is interpolated
+ * in a table, see swi_refrac_table().
  */
 double CALL_CONV swe_refrac_extended(double inalt, double geoalt, double atpress, double attemp, double lapse_rate, int32 calc_flag, double *dret)
 {
   double refr;
   double trualt;
   double dip = calc_dip(geoalt, atpress, attemp, lapse_rate);
-  double D, D0, N, y, yy0;
-  int i;
+  AS_BOOL use_table = (calc_flag & SE_REFRAC_TABLE) != 0;
+  calc_flag &= ~SE_REFRAC_TABLE;
   /* make sure that inalt <=90 */
   if( (inalt>90) )
     inalt=180-inalt;
@@ -3054,24 +3393,10 @@ double CALL_CONV swe_refrac_extended(double inalt, double geoalt, double atpress
       }
       return inalt;
     }
-    /* by iteration */
-    y = inalt;
-    D = 0.0;
-    yy0 = 0;
-    D0 = D;
-    for(i=0; i<5; i++) {
-      D = calc_astronomical_refr(y,atpress,attemp);
-      N = y - yy0;
-      yy0 = D - D0 - N; /* denominator of derivative */
-      if (N != 0.0 && yy0 != 0.0) /* sic !!! code by Moshier */
-        N = y - N*(inalt + D - y)/yy0; /* Newton iteration with numerically estimated derivative */
-      else /* Can't do it on first pass */
-        N = inalt + D;
-      yy0 = y;
-      D0 = D;
-      y = N;
-    }
-    refr = D;
+    if (use_table)
+      refr = swi_refrac_table(inalt, atpress, attemp, SE_TRUE_TO_APP);
+    else
+      refr = calc_refr_true_to_app(inalt, atpress, attemp);
     if (inalt + refr < dip) {
       if (dret != NULL) {
 	dret[0]=inalt;
@@ -3089,7 +3414,10 @@ double CALL_CONV swe_refrac_extended(double inalt, double geoalt, double atpress
     }
     return inalt+refr;
   } else {
-    refr = calc_astronomical_refr(inalt,atpress,attemp);
+    if (use_table)
+      refr = swi_refrac_table(inalt, atpress, attemp, SE_APP_TO_TRUE);
+    else
+      refr = calc_astronomical_refr(inalt,atpress,attemp);
     trualt=inalt-refr;
     //printf("inalt=%f, dip=%f\n", inalt, dip);
     if (dret != NULL) {
@@ -3116,6 +3444,133 @@ double CALL_CONV swe_refrac_extended(double inalt, double geoalt, double atpress
   }
 }
 
+/* refraction of a body at true altitude inalt, 
+ * found by iteration from the refraction at apparent altitude */
+static double calc_refr_true_to_app(double inalt, double atpress, double attemp)
+{
+  double D, D0, N, y, yy0;
+  int i;
+  y = inalt;
+  D = 0.0;
+  yy0 = 0;
+  D0 = D;
+  for(i=0; i<5; i++) {
+    D = calc_astronomical_refr(y,atpress,attemp);
+    N = y - yy0;
+    yy0 = D - D0 - N; /* denominator of derivative */
+    if (N != 0.0 && yy0 != 0.0) /* sic !!! code by Moshier */
+      N = y - N*(inalt + D - y)/yy0; /* Newton iteration with numerically estimated derivative */
+    else /* Can't do it on first pass */
+      N = inalt + D;
+    yy0 = y;
+    D0 = D;
+    y = N;
+  }
+  return D;
+}
+
+/* Refraction tables, for SE_REFRAC_TABLE.
+ * There is one table per atmospheric pressure and temperature; the lapse 
+ * rate only enters the dip of the horizon, which is cheap to compute. 
+ * Refraction is tabulated every REFR_TAB_STEP degrees 
+ * - of true altitude from REFR_TAB_TRUE_MIN to 90 degrees, as found by
+ *   the iteration of calc_refr_true_to_app(), and
+ * - of apparent altitude from REFR_TAB_APP_MIN to 90 degrees, from
+ *   calc_astronomical_refr(),
+ * and interpolated with cubic polynomials. The interpolated refraction 
+ * differs from the computed one by less than 5e-6 degrees (0.02"). The
+ * largest errors occur around true altitude 0.4 degrees, where the 
+ * iteration does not converge smoothly, and at 17.9 degrees, where
+ * calc_astronomical_refr() switches formulae. Below the tables, where 
+ * the iteration is erratic, refraction is computed.
+ * A table takes about 4000 evaluations of calc_astronomical_refr() to 
+ * build, i.e. as much as 800 conversions from true to apparent altitude.
+ * The tables (31 KB each) are allocated when first used and freed by 
+ * swe_close().
+ */
+#define REFR_TAB_N		4
+#define REFR_TAB_STEP		0.05
+#define REFR_TAB_TRUE_MIN	-4.0
+#define REFR_TAB_APP_MIN	-10.0
+#define REFR_TAB_NTRUE		1881	/* (90 - REFR_TAB_TRUE_MIN) / REFR_TAB_STEP + 1 */
+#define REFR_TAB_NAPP		2001	/* (90 - REFR_TAB_APP_MIN) / REFR_TAB_STEP + 1 */
+struct refr_table {
+  double atpress, attemp;
+  double rtrue[REFR_TAB_NTRUE];
+  double rapp[REFR_TAB_NAPP];
+};
+static TLS struct {
+  struct refr_table *t[REFR_TAB_N];
+  int32 n, next;
+} refrtab;
+
+void swi_refrac_table_close(void)
+{
+  int32 i;
+  for (i = 0; i < refrtab.n; i++) {
+    free(refrtab.t[i]);
+    refrtab.t[i] = NULL;
+  }
+  refrtab.n = refrtab.next = 0;
+}
+
+/* cubic interpolation in tab[0 .. n-1] at x, in table steps */
+static double refr_tab_interp(double *tab, int32 n, double x)
+{
+  int32 k = (int32) x;
+  double f;
+  if (k < 1)
+    k = 1;
+  else if (k > n - 3)
+    k = n - 3;
+  f = x - k;
+  return (-f * (f - 1) * (f - 2) * tab[k - 1] + (f - 2) * (3 * (f + 1) * (f - 1) * tab[k] 
+	- 3 * (f + 1) * f * tab[k + 1]) + (f + 1) * f * (f - 1) * tab[k + 2]) / 6;
+}
+
+/* refraction in degrees at true altitude (calc_flag = SE_TRUE_TO_APP)
+ * or apparent altitude (SE_APP_TO_TRUE) inalt */
+double swi_refrac_table(double inalt, double atpress, double attemp, int32 calc_flag)
+{
+  int32 i;
+  struct refr_table *rt = NULL;
+  if (calc_flag == SE_TRUE_TO_APP) {
+    if (inalt < REFR_TAB_TRUE_MIN || inalt > 90)
+      return calc_refr_true_to_app(inalt, atpress, attemp);
+  } else {
+    if (inalt < REFR_TAB_APP_MIN || inalt > 90)
+      return calc_astronomical_refr(inalt, atpress, attemp);
+  }
+  for (i = 0; i < refrtab.n; i++) {
+    if (refrtab.t[i]->atpress == atpress && refrtab.t[i]->attemp == attemp) {
+      rt = refrtab.t[i];
+      break;
+    }
+  }
+  if (rt == NULL) {
+    if (refrtab.n < REFR_TAB_N) {
+      if ((rt = (struct refr_table *) malloc(sizeof(struct refr_table))) == NULL) {
+        if (calc_flag == SE_TRUE_TO_APP)
+          return calc_refr_true_to_app(inalt, atpress, attemp);
+        return calc_astronomical_refr(inalt, atpress, attemp);
+      }
+      refrtab.t[refrtab.n++] = rt;
+    } else {
+      rt = refrtab.t[refrtab.next];
+    }
+    refrtab.next = (refrtab.next + 1) % REFR_TAB_N;
+    rt->atpress = atpress;
+    rt->attemp = attemp;
+    for (i = 0; i < REFR_TAB_NTRUE; i++)
+      rt->rtrue[i] = calc_refr_true_to_app(REFR_TAB_TRUE_MIN + i * REFR_TAB_STEP, atpress, attemp);
+    for (i = 0; i < REFR_TAB_NAPP; i++)
+      rt->rapp[i] = calc_astronomical_refr(REFR_TAB_APP_MIN + i * REFR_TAB_STEP, atpress, attemp);
+  }
+  if (calc_flag == SE_TRUE_TO_APP)
+    return refr_tab_interp(rt->rtrue, REFR_TAB_NTRUE, (inalt - REFR_TAB_TRUE_MIN) / REFR_TAB_STEP);
+  return refr_tab_interp(rt->rapp, REFR_TAB_NAPP, (inalt - REFR_TAB_APP_MIN) / REFR_TAB_STEP);
+}
+
 /* calculate the astronomical refraction
  * input parameters:
  * double inalt        * apparent altitude of object
@@ -3790,7 +4245,70 @@ static const double mag_elem[NMAG_ELEM][4] = {
                 {5.33, 0.32, 0, 0},     /* Juno */
                 {3.20, 0.32, 0, 0},     /* Vesta */
                 };
+#define PHENO_IFLAG_MASK  (SEFLG_EPHMASK | SEFLG_TRUEPOS | SEFLG_J2000 \
+                           | SEFLG_NONUT | SEFLG_NOGDEFL | SEFLG_NOABERR \
+                           | SEFLG_TOPOCTR)
+
+/* 
+ * What the phenomena of several bodies at one date have in common, see
+ * swe_pheno_arr(): the geocentric sun, and ecliptic and nutation of tjd. 
+ * The latter are used to refer the heliocentric position of a body, 
+ * computed for J2000 without nutation, to the ecliptic of tjd; a frame
+ * of its own for every tjd - dt would cost more than the position itself.
+ */
+struct pheno_epoch {
+  double tjd;
+  int32 iflag;		/* flags as in pheno(), ephemeris as found */
+  double xxs[6], lbrs[6];
+  struct epsilon oec;
+  struct nut nut;
+};
+
 int32 CALL_CONV swe_pheno(double tjd, int32 ipl, int32 iflag, double *attr, char *serr)
+{
+  return pheno(tjd, ipl, iflag, NULL, attr, serr);
+}
+
+static int32 pheno_epoch_init(double tjd, int32 iflag, struct pheno_epoch *pe, char *serr)
+{
+  int32 retflag;
+  iflag &= ~(SEFLG_JPLHOR | SEFLG_JPLHOR_APPROX);
+  iflag &= PHENO_IFLAG_MASK;
+  if ((retflag = swe_calc(tjd, SE_SUN, iflag | SEFLG_XYZ, pe->xxs, serr)) == ERR)
+    return ERR;
+  iflag = (iflag & ~SEFLG_EPHMASK) | (retflag & SEFLG_EPHMASK);
+  if (swe_calc(tjd, SE_SUN, iflag, pe->lbrs, serr) == ERR)
+    return ERR;
+  swi_check_ecliptic(tjd, iflag);
+  swi_check_nutation(tjd, iflag);
+  pe->tjd = tjd;
+  pe->iflag = iflag;
+  pe->oec = swed.oec;
+  pe->nut = swed.nut;
+  return OK;
+}
+
+/* J2000 equatorial cartesian position -> ecliptic of date pe->tjd, 
+ * as in app_pos_rest() */
+static void pheno_j2000_to_date(struct pheno_epoch *pe, int32 iflag, double *x)
+{
+  int i;
+  double xx[3];
+  swi_precess(x, pe->tjd, iflag, J2000_TO_J);
+  if (!(iflag & SEFLG_NONUT)) {
+    for (i = 0; i <= 2; i++) 
+      xx[i] = x[0] * pe->nut.matrix[0][i] 
+            + x[1] * pe->nut.matrix[1][i] 
+            + x[2] * pe->nut.matrix[2][i];
+    for (i = 0; i <= 2; i++) 
+      x[i] = xx[i];
+  }
+  swi_coortrf2(x, x, pe->oec.seps, pe->oec.ceps);
+  if (!(iflag & SEFLG_NONUT)) 
+    swi_coortrf2(x, x, pe->nut.snut, pe->nut.cnut);
+}
+
+static int32 pheno(double tjd, int32 ipl, int32 iflag, struct pheno_epoch *pe, double *attr, char *serr)
 {
   int i;
   double xx[6], xx2[6], xxs[6], lbr[6], lbr2[6], dt = 0, dd;
@@ -3810,13 +4328,7 @@ int32 CALL_CONV swe_pheno(double tjd, int32 ipl, int32 iflag, double *attr, char
   /* Ceres - Vesta must be SE_CERES etc., not 10001 etc. */
   if (ipl > SE_AST_OFFSET && ipl <= SE_AST_OFFSET + 4)
         ipl = ipl - SE_AST_OFFSET - 1 + SE_CERES;
-  iflag = iflag & (SEFLG_EPHMASK | 
-                   SEFLG_TRUEPOS | 
-                   SEFLG_J2000 | 
-                   SEFLG_NONUT |
-                   SEFLG_NOGDEFL |
-                   SEFLG_NOABERR |
-                   SEFLG_TOPOCTR);
+  iflag = iflag & PHENO_IFLAG_MASK;
   iflagp = iflag & (SEFLG_EPHMASK | 
                    SEFLG_TRUEPOS | 
                    SEFLG_J2000 | 
@@ -3839,13 +4351,20 @@ int32 CALL_CONV swe_pheno(double tjd, int32 ipl, int32 iflag, double *attr, char
     iflagp |= epheflag2;
     epheflag = epheflag2;
   }
+  /* the shared sun and frame only fit the same flags */
+  if (pe != NULL && pe->iflag != iflag)
+    pe = NULL;
   if (swe_calc(tjd, (int) ipl, iflag, lbr, serr) == ERR)
     /* int cast can be removed when swe_calc() gets int32 ipl definition */
     return ERR;
   /* if moon, we need sun as well, for magnitude */
   if (ipl == SE_MOON) {
-    if (swe_calc(tjd, SE_SUN, iflag | SEFLG_XYZ, xxs, serr) == ERR)
+    if (pe != NULL) {
+      for (i = 0; i <= 5; i++)
+        xxs[i] = pe->xxs[i];
+    } else if (swe_calc(tjd, SE_SUN, iflag | SEFLG_XYZ, xxs, serr) == ERR) {
       return ERR;
+    }
   }
   if (ipl != SE_SUN && ipl != SE_EARTH &&
     ipl != SE_MEAN_NODE && ipl != SE_TRUE_NODE &&
@@ -3859,12 +4378,22 @@ int32 CALL_CONV swe_pheno(double tjd, int32 ipl, int32 iflag, double *attr, char
     /* 
      * heliocentric planet at tjd - dt
      */
-    if (swe_calc(tjd - dt, (int) ipl, iflagp | SEFLG_XYZ, xx2, serr) == ERR)
-    /* int cast can be removed when swe_calc() gets int32 ipl definition */
-      return ERR;
-    if (swe_calc(tjd - dt, (int) ipl, iflagp, lbr2, serr) == ERR)
-    /* int cast can be removed when swe_calc() gets int32 ipl definition */
-      return ERR;
+    if (pe != NULL && !(iflagp & SEFLG_J2000)) {
+      /* referred to the ecliptic of tjd, see struct pheno_epoch */
+      if (swe_calc(tjd - dt, (int) ipl, iflagp | SEFLG_J2000 | SEFLG_NONUT | SEFLG_EQUATORIAL | SEFLG_XYZ, xx2, serr) == ERR)
+        return ERR;
+      pheno_j2000_to_date(pe, iflagp, xx2);
+      swi_cartpol(xx2, lbr2);
+      lbr2[0] *= RADTODEG;
+      lbr2[1] *= RADTODEG;
+    } else {
+      if (swe_calc(tjd - dt, (int) ipl, iflagp | SEFLG_XYZ, xx2, serr) == ERR)
+      /* int cast can be removed when swe_calc() gets int32 ipl definition */
+        return ERR;
+      if (swe_calc(tjd - dt, (int) ipl, iflagp, lbr2, serr) == ERR)
+      /* int cast can be removed when swe_calc() gets int32 ipl definition */
+        return ERR;
+    }
     /*
      * phase angle
      */
@@ -4061,10 +4590,17 @@ int32 CALL_CONV swe_pheno(double tjd, int32 ipl, int32 iflag, double *attr, char
     /* 
      * elongation of planet
      */
-    if (swe_calc(tjd, SE_SUN, iflag | SEFLG_XYZ, xx2, serr) == ERR)
-      return ERR;
-    if (swe_calc(tjd, SE_SUN, iflag, lbr2, serr) == ERR)
-      return ERR;
+    if (pe != NULL) {
+      for (i = 0; i <= 5; i++) {
+        xx2[i] = pe->xxs[i];
+        lbr2[i] = pe->lbrs[i];
+      }
+    } else {
+      if (swe_calc(tjd, SE_SUN, iflag | SEFLG_XYZ, xx2, serr) == ERR)
+        return ERR;
+      if (swe_calc(tjd, SE_SUN, iflag, lbr2, serr) == ERR)
+        return ERR;
+    }
     attr[2] = acos(swi_dot_prod_unit(xx, xx2)) * RADTODEG;
   }
   /* horizontal parallax */
@@ -4132,6 +4668,67 @@ int32 CALL_CONV swe_pheno_ut(double tjd_ut, int32 ipl, int32 iflag, double *attr
   return retflag;
 }
 
+/*
+ * Array versions of swe_pheno() and swe_pheno_ut(), for nipl bodies ipl[i]
+ * at one date. attr holds 20 doubles per body, attr[20 * i + 0 .. 19] as 
+ * attr[0 .. 19] of swe_pheno().
+ * The geocentric sun, ecliptic and nutation are computed once. The
+ * heliocentric position of a body at tjd - dt is referred to the ecliptic
+ * of tjd, which the geocentric positions refer to, instead of the 
+ * ecliptic of tjd - dt; phase angles differ from swe_pheno() by less 
+ * than 0.1".
+ * The functions return the number of bodies that could not be computed;
+ * their results are 0, and serr contains the error message of the first 
+ * one (or a warning, if there was no error).
+ */
+static int32 pheno_arr(double tjd, int32 *ipl, int32 nipl, int32 iflag, double *attr, int32 *epheflag, char *serr)
+{
+  int32 i, j, nerr = 0;
+  struct pheno_epoch pe;
+  char *sp = serr;
+  AS_BOOL epoch_ok;
+  if (serr != NULL)
+    *serr = '\0';
+  epoch_ok = (pheno_epoch_init(tjd, iflag, &pe, sp) == OK);
+  *epheflag = epoch_ok ? (pe.iflag & SEFLG_EPHMASK) : (iflag & SEFLG_EPHMASK);
+  for (i = 0; i < nipl; i++) {
+    double *ap = attr + 20 * i;
+    if (!epoch_ok || pheno(tjd, ipl[i], iflag, &pe, ap, sp) == ERR) {
+      for (j = 0; j < 20; j++)
+        ap[j] = 0;
+      /* keep the first error message */
+      nerr++;
+      sp = NULL;
+    }
+  }
+  return nerr;
+}
+
+int32 CALL_CONV swe_pheno_arr(double tjd, int32 *ipl, int32 nipl, int32 iflag, double *attr, char *serr)
+{
+  int32 epheflag;
+  return pheno_arr(tjd, ipl, nipl, iflag, attr, &epheflag, serr);
+}
+
+int32 CALL_CONV swe_pheno_ut_arr(double tjd_ut, int32 *ipl, int32 nipl, int32 iflag, double *attr, char *serr)
+{
+  double deltat;
+  int32 nerr, epheflag2;
+  int32 epheflag = iflag & SEFLG_EPHMASK;
+  if (epheflag == 0) {
+    epheflag = SEFLG_SWIEPH;
+    iflag |= SEFLG_SWIEPH;
+  }
+  deltat = swe_deltat_ex(tjd_ut, iflag, serr);
+  nerr = pheno_arr(tjd_ut + deltat, ipl, nipl, iflag, attr, &epheflag2, serr);
+  /* if ephe required is not ephe returned, adjust delta t: */
+  if (epheflag2 != epheflag) {
+    deltat = swe_deltat_ex(tjd_ut, epheflag2, serr);
+    nerr = pheno_arr(tjd_ut + deltat, ipl, nipl, iflag, attr, &epheflag2, serr);
+  }
+  return nerr;
+}
+
 static int find_maximum(double y00, double y11, double y2, double dx, 
                         double *dxret, double *yret)
 {
@@ -4195,6 +4792,55 @@ static double get_sun_rad_plus_refr(int32 ipl, double dd, int32 rsmi, double ref
   return rdi;
 }
 
+/* 
+ * Rising and setting of several bodies from the same time and place
+ * share the sidereal time at tjd_ut, the refraction at the horizon 
+ * and, for the slow method, Delta T and sidereal time of its steps
+ * of two hours from tjd_ut - 2 hours on (see swe_gauquelin_sector_arr()).
+ */
+#define RISE_NSTEP	15
+struct rise_epoch {
+  double tjd_ut;
+  double armc;		/* sidereal time at tjd_ut + geogr. longitude, in degrees */
+  double refr;		/* refraction at the horizon */
+  AS_BOOL have_steps;
+  double te[RISE_NSTEP], armc_step[RISE_NSTEP];
+};
+
+/* state of a search of swe_rise_trans_true_hor(), see rise_hor_init() */
+struct rise_hor {
+  double tjd_ut;
+  int32 ipl, epheflag, iflag, rsmi, tohor_flag;
+  char *starname;
+  AS_BOOL do_fixstar;
+  double *geopos, atpress, attemp, horhgt;
+  double dd;		/* diameter of body */
+  double xc[6];
+  int jmax;
+  double tc[20], h[20];	/* times and heights */
+};
+
+/* refraction of a body at the horizon, for rise_set_fast() */
+static double rise_refr(double *dgeo, double atpress, double attemp)
+{
+  double xx[6];
+  if (atpress == 0) {
+    /* estimate atmospheric pressure */
+    atpress = 1013.25 * pow(1 - 0.0065 * dgeo[2] / 288, 5.255);
+  } 
+  swe_refrac_extended(0.000001, 0, atpress, attemp, const_lapse_rate, SE_APP_TO_TRUE, xx);
+  return xx[1] - xx[0];
+}
+
+static void rise_epoch_init(struct rise_epoch *re, double tjd_ut, double *geopos, 
+               double atpress, double attemp)
+{
+  re->tjd_ut = tjd_ut;
+  re->armc = swe_degnorm(swe_sidtime(tjd_ut) * 15 + geopos[0]);
+  re->refr = rise_refr(geopos, atpress, attemp);
+  re->have_steps = FALSE;
+}
+
 /* Simple fast algorithm for risings and settings of 
  * - planets Sun, Moon, Mercury - Pluto + Lunar Nodes and Fixed stars
  * Does not work well for geographic latitudes
@@ -4207,6 +4853,7 @@ static int32 rise_set_fast(
 	       int32 epheflag, int32 rsmi,
                double *dgeo, 
 	       double atpress, double attemp,
+               struct rise_epoch *re,
                double *tret,
                char *serr)
 {
@@ -4254,7 +4901,10 @@ run_rise_again:
     sda = acos(sda) * RADTODEG;
   }
   // sidereal time at tjd_start
-  armc = swe_degnorm(swe_sidtime(tjd_ut) * 15 + dgeo[0]); 
+  if (re != NULL && tjd_ut == re->tjd_ut)
+    armc = re->armc;
+  else
+    armc = swe_degnorm(swe_sidtime(tjd_ut) * 15 + dgeo[0]); 
   // meridian distance of object
   md = swe_degnorm(xx[0] - armc);
   mdrise = swe_degnorm(sda * facrise);
@@ -4280,13 +4930,11 @@ run_rise_again:
   /* true altitude of sun, when it appears at the horizon; 
    * refraction for a body visible at the horizon at 0m above sea,
    */
+  refr = (re != NULL) ? re->refr : rise_refr(dgeo, atpress, attemp);
   if (atpress == 0) {
     /* estimate atmospheric pressure */
     atpress = 1013.25 * pow(1 - 0.0065 * dgeo[2] / 288, 5.255);
   } 
-  swe_refrac_extended(0.000001, 0, atpress, attemp, const_lapse_rate, SE_APP_TO_TRUE, xx);
-  refr = xx[1] - xx[0];
-//fprintf(stderr, "refr=%f, %f, %f\n", refr, xx[0], xx[1]);
   if (rsmi & SE_BIT_GEOCTR_NO_ECL_LAT) {
     tohor_flag = SE_ECL2HOR;
     iflagtopo = iflag;
@@ -4361,51 +5009,93 @@ int32 CALL_CONV swe_rise_trans(
                double *tret,
                char *serr)
 {
-  int32 retval = 0;
-  /* Simple fast algorithm for risings and settings of 
-   * - planets Sun, Moon, Mercury - Pluto + Lunar Nodes
-   * Does not work well for geographic latitudes
-   * > 65 N/S for the Sun
-   * > 60 N/S for the Moon and the planets
-   * Beyond these limits, some risings or settings may be missed.
-   */
+  return rise_trans(tjd_ut, ipl, starname, epheflag, rsmi, geopos, atpress, attemp, NULL, tret, serr);
+}
+
+/* Simple fast algorithm for risings and settings of 
+ * - planets Sun, Moon, Mercury - Pluto + Lunar Nodes
+ * Does not work well for geographic latitudes
+ * > 65 N/S for the Sun
+ * > 60 N/S for the Moon and the planets
+ * Beyond these limits, some risings or settings may be missed.
+ */
+static AS_BOOL rise_use_fast(int32 ipl, char *starname, int32 rsmi, double *geopos)
+{
   AS_BOOL do_fixstar = (starname != NULL && *starname != '\0');
-  if (!do_fixstar
+  return (!do_fixstar
     && (rsmi & (SE_CALC_RISE|SE_CALC_SET)) 
     && !(rsmi & SE_BIT_FORCE_SLOW_METHOD)
     && !(rsmi & (SE_BIT_CIVIL_TWILIGHT|SE_BIT_NAUTIC_TWILIGHT|SE_BIT_ASTRO_TWILIGHT))
     && (ipl >= SE_SUN && ipl <= SE_TRUE_NODE)
     && (fabs(geopos[1]) <= 60 || (ipl == SE_SUN && fabs(geopos[1]) <= 65))
-    ) {
-      retval = rise_set_fast(tjd_ut, ipl, epheflag, rsmi, geopos, atpress, attemp, tret, serr);
-      return retval;
-  }
-  return swe_rise_trans_true_hor(tjd_ut, ipl, starname, epheflag, rsmi, geopos, atpress, attemp, 0, tret, serr);
+    );
 }
 
-/* same as swe_rise_trans(), but allows to define the height of the horizon
- * at the point of the rising or setting (horhgt) */
-int32 CALL_CONV swe_rise_trans_true_hor(
+/* swe_rise_trans() with an optional epoch re of tjd_ut and geopos */
+static int32 rise_trans(
                double tjd_ut, int32 ipl, char *starname,
 	       int32 epheflag, int32 rsmi,
                double *geopos, 
 	       double atpress, double attemp,
-	       double horhgt,
+               struct rise_epoch *re,
                double *tret,
                char *serr)
 {
-  int i, j, k, ii, calc_culm, nculm = -1;
-  double tjd_et = tjd_ut + swe_deltat_ex(tjd_ut, epheflag, serr);
-  double xc[6], xh[20][6], ah[6], aha;
-  double tculm[4], tcu, tc[20], h[20], t2[6], dc[6], dtint, dx, rdi, dd = 0;
+  struct rise_hor rh;
+  int32 retc;
+  if (rise_use_fast(ipl, starname, rsmi, geopos))
+    return rise_set_fast(tjd_ut, ipl, epheflag, rsmi, geopos, atpress, attemp, re, tret, serr);
+  if (re == NULL || (rsmi & (SE_CALC_MTRANSIT | SE_CALC_ITRANSIT)))
+    return swe_rise_trans_true_hor(tjd_ut, ipl, starname, epheflag, rsmi, geopos, atpress, attemp, 0, tret, serr);
+  *tret = 0;
+  if ((retc = rise_hor_init(&rh, tjd_ut, ipl, starname, epheflag, rsmi, geopos, atpress, attemp, 0, serr)) != OK
+    || (retc = rise_hor_heights(&rh, re, serr)) != OK)
+    return retc;
+  return rise_hor_find(&rh, rh.rsmi, tret, serr);
+}
+
+/* same as swe_rise_trans(), but allows to define the height of the horizon
+ * at the point of the rising or setting (horhgt) */
+int32 CALL_CONV swe_rise_trans_true_hor(
+               double tjd_ut, int32 ipl, char *starname,
+	       int32 epheflag, int32 rsmi,
+               double *geopos, 
+	       double atpress, double attemp,
+	       double horhgt,
+               double *tret,
+               char *serr)
+{
+  struct rise_hor rh;
+  int32 retc;
+  *tret = 0;
+  if (rise_hor_init(&rh, tjd_ut, ipl, starname, epheflag, rsmi, geopos, atpress, attemp, horhgt, serr) == ERR)
+    return ERR;
+  if (rsmi & (SE_CALC_MTRANSIT | SE_CALC_ITRANSIT))
+    return calc_mer_trans(tjd_ut, rh.ipl, epheflag, rsmi, 
+		geopos, starname, tret, serr);
+  if ((retc = rise_hor_heights(&rh, NULL, serr)) != OK)
+    return retc;
+  return rise_hor_find(&rh, rh.rsmi, tret, serr);
+}
+
+/* 
+ * The search of swe_rise_trans_true_hor() is done in three steps:
+ * rise_hor_init() checks the input and sets up the flags,
+ * rise_hor_heights() computes the heights of the body above the
+ * horizon in steps of two hours from tjd_ut - 2 hours to tjd_ut + 26 hours, 
+ * including culminations, and rise_hor_find() finds the first rising 
+ * or setting after tjd_ut between these. So one call of rise_hor_heights()
+ * serves the searches for both rising and setting.
+ */
+static int32 rise_hor_init(struct rise_hor *rh,
+               double tjd_ut, int32 ipl, char *starname,
+	       int32 epheflag, int32 rsmi,
+               double *geopos, 
+	       double atpress, double attemp,
+	       double horhgt,
+               char *serr)
+{
   int32 iflag = epheflag;
-  int jmax = 14;
-  double t, te, tt, dt, twohrs = 1.0 / 12.0;
-  double curdist;
-  int32 tohor_flag = SE_EQU2HOR;
-int nazalt = 0;
-int ncalc = 0;
-  AS_BOOL do_fixstar = (starname != NULL && *starname != '\0');
   if (geopos[2] < SEI_ECL_GEOALT_MIN || geopos[2] > SEI_ECL_GEOALT_MAX) {
     if (serr != NULL)
       sprintf(serr, "location for swe_rise_trans() must be between %.0f and %.0f m above sea", SEI_ECL_GEOALT_MIN, SEI_ECL_GEOALT_MAX);
@@ -4421,22 +5111,17 @@ int ncalc = 0;
    * are treated as calls for Pluto as main body SE_PLUTO */
   if (ipl == SE_AST_OFFSET + 134340)
     ipl = SE_PLUTO;
-  xh[0][0] = 0; /* to shut up mint */
   /* allowing SEFLG_NONUT and SEFLG_TRUEPOS speeds it up */
   iflag &= (SEFLG_EPHMASK | SEFLG_NONUT | SEFLG_TRUEPOS);
-  *tret = 0;
   if (rsmi & SE_BIT_GEOCTR_NO_ECL_LAT) {
-    tohor_flag = SE_ECL2HOR;
+    rh->tohor_flag = SE_ECL2HOR;
   } else {
-    tohor_flag = SE_EQU2HOR;
+    rh->tohor_flag = SE_EQU2HOR;
     iflag |= SEFLG_EQUATORIAL;
     iflag |= SEFLG_TOPOCTR;
     swe_set_topo(geopos[0], geopos[1], geopos[2]);
   }
-  if (rsmi & (SE_CALC_MTRANSIT | SE_CALC_ITRANSIT))
-    return calc_mer_trans(tjd_ut, ipl, epheflag, rsmi, 
-		geopos, starname, tret, serr);
-  if (!(rsmi & (SE_CALC_RISE | SE_CALC_SET)))
+  if (!(rsmi & (SE_CALC_MTRANSIT | SE_CALC_ITRANSIT | SE_CALC_RISE | SE_CALC_SET)))
     rsmi |= SE_CALC_RISE;
   /* twilight calculation */
   if (ipl == SE_SUN && (rsmi & (SE_BIT_CIVIL_TWILIGHT|SE_BIT_NAUTIC_TWILIGHT|SE_BIT_ASTRO_TWILIGHT))) {
@@ -4445,6 +5130,82 @@ int ncalc = 0;
       /* note: twilight is not dependent on height of horizon, so we can
        * use this parameter and define a fictitious height of horizon */
   }
+  rh->tjd_ut = tjd_ut;
+  rh->ipl = ipl;
+  rh->starname = starname;
+  rh->do_fixstar = (starname != NULL && *starname != '\0');
+  rh->epheflag = epheflag;
+  rh->iflag = iflag;
+  rh->rsmi = rsmi;
+  rh->geopos = geopos;
+  rh->atpress = atpress;
+  rh->attemp = attemp;
+  rh->horhgt = horhgt;
+  rh->xc[0] = 0; /* to shut up mint */
+  return OK;
+}
+
+/* height of the body at t (UT), te (ET) for sidereal time armc, 
+ * in xh[1] (true) and xh[2] (apparent, if refraction is wanted);
+ * with do_calc = FALSE, the position rh->xc is already there */
+static int32 rise_hor_height(struct rise_hor *rh, double t, double te, double armc, 
+               AS_BOOL do_calc, double *xh, double *h, char *serr)
+{
+  double rdi, curdist;
+  double *xc = rh->xc;
+  int32 rsmi = rh->rsmi;
+  if (do_calc) {
+    if (swe_calc(te, rh->ipl, rh->iflag, xc, serr) == ERR)
+      return ERR;
+    if (rsmi & SE_BIT_GEOCTR_NO_ECL_LAT)
+      xc[1] = 0;
+  }
+  curdist = xc[2];
+  if (rsmi & SE_BIT_FIXED_DISC_SIZE) {
+    if (rh->ipl == SE_SUN) {
+      curdist = 1.0;
+    } else if (rh->ipl == SE_MOON) {
+      curdist = 0.00257;
+    }
+  }
+  /* apparent radius of disc */
+  rdi = asin( rh->dd / 2 / AUNIT / curdist ) * RADTODEG;
+  /* true height of center of body */
+  azalt_armc(t, armc, rh->tohor_flag, rh->geopos, rh->atpress, rh->attemp, xc, xh);
+  if (rsmi & SE_BIT_DISC_BOTTOM) {
+    /* true height of bottom point of body */
+    xh[1] -= rdi;
+  } else {
+    /* true height of uppermost point of body */
+    xh[1] += rdi;
+  }
+  /* apparent height of uppermost point of body */
+  if (rsmi & SE_BIT_NO_REFRACTION) {
+    xh[1] -= rh->horhgt;
+    *h = xh[1];
+  } else {
+    azalt_rev_armc(t, armc, SE_HOR2EQU, rh->geopos, xh, xc);
+    azalt_armc(t, armc, SE_EQU2HOR, rh->geopos, rh->atpress, rh->attemp, xc, xh);
+    xh[1] -= rh->horhgt;
+    xh[2] -= rh->horhgt;
+    *h = xh[2];
+  }
+  return OK;
+}
+
+static int32 rise_hor_heights(struct rise_hor *rh, struct rise_epoch *re, char *serr)
+{
+  int i, j, k, ii, calc_culm, nculm = -1;
+  double tjd_ut = rh->tjd_ut;
+  double tjd_et = tjd_ut + swe_deltat_ex(tjd_ut, rh->epheflag, serr);
+  double xh[20][6], ah[6], armc;
+  double tculm[4], tcu, *tc = rh->tc, *h = rh->h, dc[6], dtint, dx, dd = 0;
+  int32 epheflag = rh->epheflag, iflag = rh->iflag, rsmi = rh->rsmi, ipl = rh->ipl;
+  int jmax = RISE_NSTEP - 1;
+  double t, te, tt, dt, twohrs = 1.0 / 12.0;
+  AS_BOOL use_steps = (re != NULL && tjd_ut == re->tjd_ut);
+  AS_BOOL do_fixstar = rh->do_fixstar;
+  xh[0][0] = 0; /* to shut up mint */
   /* find culmination points within 28 hours from t0 - twohrs.
    * culminations are required in case there are maxima or minima
    * in height slightly above or below the horizon.
@@ -4454,19 +5215,33 @@ int ncalc = 0;
    * western half of the sky for a short time. 
    */
   if (do_fixstar) {
-    if (swe_fixstar(starname, tjd_et, iflag, xc, serr) == ERR)
+    if (swe_fixstar(rh->starname, tjd_et, iflag, rh->xc, serr) == ERR)
       return ERR;
   } 
+  /* Delta T and sidereal time of the steps are the same for all
+   * bodies searched from this time and place */
+  if (use_steps && !re->have_steps) {
+    for (ii = 0, t = tjd_ut - twohrs; ii <= jmax; ii++, t += twohrs) {
+      re->te[ii] = t + swe_deltat_ex(t, epheflag, serr);
+      re->armc_step[ii] = swe_degnorm(swe_sidtime(t) * 15 + rh->geopos[0]);
+    }
+    re->have_steps = TRUE;
+  }
   for (ii = 0, t = tjd_ut - twohrs; ii <= jmax; ii++, t += twohrs) {
     tc[ii] = t;
-    if (!do_fixstar) {
+    if (use_steps) {
+      te = re->te[ii];
+      armc = re->armc_step[ii];
+    } else {
       te = t + swe_deltat_ex(t, epheflag, serr);
-      if (swe_calc(te, ipl, iflag, xc, serr) == ERR)
+      armc = swe_degnorm(swe_sidtime(t) * 15 + rh->geopos[0]);
+    }
+    if (!do_fixstar) {
+      if (swe_calc(te, ipl, iflag, rh->xc, serr) == ERR)
         return ERR;
-ncalc++;
     }
     if (rsmi & SE_BIT_GEOCTR_NO_ECL_LAT)
-      xc[1] = 0;
+      rh->xc[1] = 0;
     /* diameter of object in km */
     if (ii == 0) {
       if (do_fixstar) 
@@ -4479,40 +5254,10 @@ ncalc++;
         dd = swed.ast_diam * 1000;	/* km -> m */
       else
         dd = 0;
+      rh->dd = dd;
     }
-    curdist = xc[2];
-    if (rsmi & SE_BIT_FIXED_DISC_SIZE) {
-      if (ipl == SE_SUN) {
-        curdist = 1.0;
-      } else if (ipl == SE_MOON) {
-        curdist = 0.00257;
-      }
-    }
-    /* apparent radius of disc */
-    rdi = asin( dd / 2 / AUNIT / curdist ) * RADTODEG;
-    /* true height of center of body */
-    swe_azalt(t, tohor_flag, geopos, atpress, attemp, xc, xh[ii]);
-nazalt++;
-    if (rsmi & SE_BIT_DISC_BOTTOM) {
-      /* true height of bottom point of body */
-      xh[ii][1] -= rdi;
-    } else {
-      /* true height of uppermost point of body */
-      xh[ii][1] += rdi;
-    }
-    /* apparent height of uppermost point of body */
-    if (rsmi & SE_BIT_NO_REFRACTION) {
-      xh[ii][1] -= horhgt;
-      h[ii] = xh[ii][1];
-    } else {
-      swe_azalt_rev(t, SE_HOR2EQU, geopos, xh[ii], xc);
-nazalt++;
-      swe_azalt(t, SE_EQU2HOR, geopos, atpress, attemp, xc, xh[ii]);
-nazalt++;
-      xh[ii][1] -= horhgt;
-      xh[ii][2] -= horhgt;
-      h[ii] = xh[ii][2];
-    }
+    if (rise_hor_height(rh, t, te, armc, FALSE, xh[ii], &h[ii], serr) == ERR)
+      return ERR;
     calc_culm = 0;
     if (ii > 1) {
       dc[0] = xh[ii-2][1];
@@ -4533,15 +5278,13 @@ nazalt++;
         for (i = 0, tt = tcu - dt; i < 3; tt += dt, i++) {
           te = tt + swe_deltat_ex(tt, epheflag, serr);
           if (!do_fixstar) {
-            if (swe_calc(te, ipl, iflag, xc, serr) == ERR)
+            if (swe_calc(te, ipl, iflag, rh->xc, serr) == ERR)
               return ERR;
 	  }
 	  if (rsmi & SE_BIT_GEOCTR_NO_ECL_LAT)
-	    xc[1] = 0;
-	  ncalc++;
-          swe_azalt(tt, tohor_flag, geopos, atpress, attemp, xc, ah);
-	  nazalt++;
-	  ah[1] -= horhgt;
+	    rh->xc[1] = 0;
+          swe_azalt(tt, rh->tohor_flag, rh->geopos, rh->atpress, rh->attemp, rh->xc, ah);
+	  ah[1] -= rh->horhgt;
           dc[i] = ah[1];
         }
         find_maximum(dc[0], dc[1], dc[2], dt, &dtint, &dx);
@@ -4563,56 +5306,31 @@ nazalt++;
           h[k+1] = h[k];
         }
         tc[j] = tculm[i];
-        if (!do_fixstar) {
-          te = tc[j] + swe_deltat_ex(tc[j], epheflag, serr);
-          if (swe_calc(te, ipl, iflag, xc, serr) == ERR)
-            return ERR;
-	  if (rsmi & SE_BIT_GEOCTR_NO_ECL_LAT)
-	    xc[1] = 0;
-ncalc++;
-        }
-        curdist = xc[2];
-        if (rsmi & SE_BIT_FIXED_DISC_SIZE) {
-          if ( ipl == SE_SUN ) {
-            curdist = 1.0;
-          } else if (ipl == SE_MOON) {
-            curdist = 0.00257;
-          }
-        }
-        /* apparent radius of disc */
-        rdi = asin( dd / 2 / AUNIT / curdist ) * RADTODEG;
-        /* true height of center of body */
-        swe_azalt(tc[j], tohor_flag, geopos, atpress, attemp, xc, ah);
-nazalt++;
-        if (rsmi & SE_BIT_DISC_BOTTOM) {
-          /* true height of bottom point of body */
-          ah[1] -= rdi;
-        } else {
-	  /* true height of uppermost point of body */
-	  ah[1] += rdi;
-        }
-        /* apparent height of uppermost point of body */
-	if (rsmi & SE_BIT_NO_REFRACTION) {
-	  ah[1] -= horhgt;
-	  h[j] = ah[1];
-	} else {
-	  swe_azalt_rev(tc[j], SE_HOR2EQU, geopos, ah, xc);
-nazalt++;
-	  swe_azalt(tc[j], SE_EQU2HOR, geopos, atpress, attemp, xc, ah);
-nazalt++;
-	  ah[1] -= horhgt;
-	  ah[2] -= horhgt;
-	  h[j] = ah[2];
-	}
+        te = tc[j] + swe_deltat_ex(tc[j], epheflag, serr);
+        armc = swe_degnorm(swe_sidtime(tc[j]) * 15 + rh->geopos[0]);
+        if (rise_hor_height(rh, tc[j], te, armc, !do_fixstar, ah, &h[j], serr) == ERR)
+          return ERR;
         jmax++;
         break;
       }
     }
   }
+  rh->jmax = jmax;
+  return OK;
+}
+
+/* first rising or setting (rsmi & (SE_CALC_RISE|SE_CALC_SET)) after tjd_ut
+ * from the heights of rise_hor_heights();
+ * returns -2 if there is none */
+static int32 rise_hor_find(struct rise_hor *rh, int32 rsmi, double *tret, char *serr)
+{
+  int i, ii;
+  double ah[6], aha, dc[2], t2[2], t = 0, te = 0, armc;
+  double *tc = rh->tc, *h = rh->h;
   *tret = 0;
   /* find points with zero height. 
    * binary search */
-  for (ii = 1; ii <= jmax; ii++) {
+  for (ii = 1; ii <= rh->jmax; ii++) {
     if (h[ii-1] * h[ii] >= 0)
       continue;
     if (h[ii-1] < h[ii] && !(rsmi & SE_CALC_RISE))
@@ -4625,47 +5343,11 @@ nazalt++;
     t2[1] = tc[ii];
     for (i = 0; i < 20; i++) {
       t = (t2[0] + t2[1]) / 2;
-      if (!do_fixstar) {
-        te = t + swe_deltat_ex(t, epheflag, serr);
-        if (swe_calc(te, ipl, iflag, xc, serr) == ERR)
-          return ERR;
-	if (rsmi & SE_BIT_GEOCTR_NO_ECL_LAT)
-	  xc[1] = 0;
-ncalc++;
-      }
-      curdist = xc[2];
-      if (rsmi & SE_BIT_FIXED_DISC_SIZE) {
-        if (ipl == SE_SUN) {
-          curdist = 1.0;
-        } else if (ipl == SE_MOON) {
-          curdist = 0.00257;
-        }
-      }
-      /* apparent radius of disc */
-      rdi = asin( dd / 2 / AUNIT / curdist ) * RADTODEG;
-      /* true height of center of body */
-      swe_azalt(t, tohor_flag, geopos, atpress, attemp, xc, ah);
-nazalt++;
-      if (rsmi & SE_BIT_DISC_BOTTOM) {
-        /* true height of bottom point of body */
-        ah[1] -= rdi;
-      } else {
-	/* true height of uppermost point of body */
-	ah[1] += rdi;
-      }
-      /* apparent height of uppermost point of body */
-      if (rsmi & SE_BIT_NO_REFRACTION) {
-	ah[1] -= horhgt;
-	aha = ah[1];
-      } else {
-	swe_azalt_rev(t, SE_HOR2EQU, geopos, ah, xc);
-	nazalt++;
-	swe_azalt(t, SE_EQU2HOR, geopos, atpress, attemp, xc, ah);
-	nazalt++;
-	ah[1] -= horhgt;
-	ah[2] -= horhgt;
-	aha = ah[2];
-      }
+      if (!rh->do_fixstar)
+        te = t + swe_deltat_ex(t, rh->epheflag, serr);
+      armc = swe_degnorm(swe_sidtime(t) * 15 + rh->geopos[0]);
+      if (rise_hor_height(rh, t, te, armc, !rh->do_fixstar, ah, &aha, serr) == ERR)
+        return ERR;
       if (aha * dc[0] <= 0) {
         dc[1] = aha;
         t2[1] = t;
@@ -4674,15 +5356,13 @@ nazalt++;
         t2[0] = t;
       }
     }
-    if (t > tjd_ut) {
+    if (t > rh->tjd_ut) {
      *tret = t;
-//  fprintf(stderr, "nazalt=%d\n", nazalt);
-//  fprintf(stderr, "ncalc=%d\n", ncalc);
      return OK;
     }
   }
   if (serr)
-    sprintf(serr, "rise or set not found for planet %d", ipl);
+    sprintf(serr, "rise or set not found for planet %d", rh->ipl);
   return -2; /* no t of rise or set found */
 }
 
@@ -5062,11 +5742,121 @@ static const double plmass[9] = {
   136566000,        /* Pluto */
 };
 static const int ipl_to_elem[15] = {2, 0, 0, 1, 3, 4, 5, 6, 7, 0, 0, 0, 0, 0, 2,};
-int32 CALL_CONV swe_nod_aps(double tjd_et, int32 ipl, int32 iflag, 
+
+/* 
+ * State shared by the nodes and apsides of several planets at one date,
+ * see swe_nod_aps_arr(): ecliptic, nutation, barycentric earth and sun 
+ * and observer as the save area holds them for tjd, and the acceleration
+ * of earth and sun, from which the change of the observer's speed during
+ * the light-time of each point is found. swe_nod_aps() gets the latter
+ * from two more calls of swe_calc() per point.
+ */
+#define NODE_ABERR_INTV	0.1
+struct nod_aps_epoch {
+  double tjd;
+  struct epsilon oec;
+  struct nut nut, nutv;
+  struct topo_data topd;
+  double tear, tsun;
+  int32 iephe_ear, iephe_sun, xflgs_ear, xflgs_sun;
+  double xear[6], xsun[6];
+  double aear[3], asun[3];
+};
+
+static int32 nod_aps_epoch_init(double tjd_et, int32 iflag, struct nod_aps_epoch *ne, char *serr)
+{
+  int i;
+  double x[6];
+  struct plan_data *pedp = &swed.pldat[SEI_EARTH];
+  struct plan_data *psbdp = &swed.pldat[SEI_SUNBARY];
+  int32 iflg0 = (iflag & (SEFLG_EPHMASK|SEFLG_NONUT)) | SEFLG_SPEED | SEFLG_TRUEPOS | SEFLG_HELCTR;
+  /* to get control over the save area: */
+  swi_force_app_pos_etc();
+  if (swe_calc(tjd_et - NODE_ABERR_INTV, SE_EARTH, iflg0, x, serr) == ERR)
+    return ERR;
+  for (i = 0; i <= 2; i++) {
+    ne->aear[i] = pedp->x[i+3];
+    ne->asun[i] = psbdp->x[i+3];
+  }
+  if (swe_calc(tjd_et, SE_EARTH, iflg0, x, serr) == ERR)
+    return ERR;
+  if ((iflag & SEFLG_TOPOCTR) && swi_get_observer(tjd_et, iflag | SEFLG_NONUT, TRUE, x, serr) != OK)
+    return ERR;
+  for (i = 0; i <= 2; i++) {
+    ne->aear[i] = (pedp->x[i+3] - ne->aear[i]) / NODE_ABERR_INTV;
+    ne->asun[i] = (psbdp->x[i+3] - ne->asun[i]) / NODE_ABERR_INTV;
+  }
+  ne->tjd = tjd_et;
+  ne->oec = swed.oec;
+  ne->nut = swed.nut;
+  ne->nutv = swed.nutv;
+  ne->topd = swed.topd;
+  ne->tear = pedp->teval;
+  ne->iephe_ear = pedp->iephe;
+  ne->xflgs_ear = pedp->xflgs;
+  ne->tsun = psbdp->teval;
+  ne->iephe_sun = psbdp->iephe;
+  ne->xflgs_sun = psbdp->xflgs;
+  for (i = 0; i <= 5; i++) {
+    ne->xear[i] = pedp->x[i];
+    ne->xsun[i] = psbdp->x[i];
+  }
+  return OK;
+}
+
+/* puts the state of ne back into the save area, after the 
+ * computation of the osculating ellipse has changed it */
+static void nod_aps_epoch_restore(struct nod_aps_epoch *ne)
+{
+  int i;
+  struct plan_data *pedp = &swed.pldat[SEI_EARTH];
+  struct plan_data *psbdp = &swed.pldat[SEI_SUNBARY];
+  swed.oec = ne->oec;
+  swed.nut = ne->nut;
+  swed.nutv = ne->nutv;
+  swed.topd = ne->topd;
+  pedp->teval = ne->tear;
+  pedp->iephe = ne->iephe_ear;
+  pedp->xflgs = ne->xflgs_ear;
+  psbdp->teval = ne->tsun;
+  psbdp->iephe = ne->iephe_sun;
+  psbdp->xflgs = ne->xflgs_sun;
+  for (i = 0; i <= 5; i++) {
+    pedp->x[i] = ne->xear[i];
+    psbdp->x[i] = ne->xsun[i];
+  }
+}
+
+/* speed of the observer at tjd - dt, in xobs2[3..5] */
+static int32 nod_aps_observer_speed(struct nod_aps_epoch *ne, int32 ipl, int32 iflag, double dt, double *xobs2, char *serr)
+{
+  int i;
+  if (iflag & SEFLG_TOPOCTR) {
+    if (swi_get_observer(ne->tjd - dt, iflag | SEFLG_NONUT, FALSE, xobs2, serr) != OK)
+      return ERR;
+  } else {
+    for (i = 0; i <= 5; i++)
+      xobs2[i] = 0;
+  }
+  if (iflag & (SEFLG_HELCTR | SEFLG_BARYCTR)) {
+    if ((iflag & SEFLG_HELCTR) && !(iflag & SEFLG_MOSEPH))
+      for (i = 0; i <= 2; i++)
+        xobs2[i+3] = ne->xsun[i+3] - dt * ne->asun[i];
+  } else if (ipl == SE_SUN && !(iflag & SEFLG_MOSEPH)) {
+    for (i = 0; i <= 2; i++)
+      xobs2[i+3] = ne->xsun[i+3] - dt * ne->asun[i];
+  } else {
+    for (i = 0; i <= 2; i++)
+      xobs2[i+3] += ne->xear[i+3] - dt * ne->aear[i];
+  }
+  return OK;
+}
+
+static int32 nod_aps(double tjd_et, int32 ipl, int32 iflag, 
                       int32  method,
                       double *xnasc, double *xndsc, 
                       double *xperi, double *xaphe, 
-                      char *serr)
+                      struct nod_aps_epoch *ne, char *serr)
 {
   int ij, i, j;
   int32 iplx;
@@ -5111,7 +5901,8 @@ int32 CALL_CONV swe_nod_aps(double tjd_et, int32 ipl, int32 iflag,
   xap = xx+18;
   xpos[0][0] = 0; /* to shut up mint */
   /* to get control over the save area: */
-  swi_force_app_pos_etc();
+  if (ne == NULL)
+    swi_force_app_pos_etc();
   method %= SE_NODBIT_FOPOINT;
   ipli = ipl;
   if (ipl == SE_SUN) 
@@ -5391,12 +6182,14 @@ int32 CALL_CONV swe_nod_aps(double tjd_et, int32 ipl, int32 iflag,
   /* to set the variables required in the save area,
    * i.e. ecliptic, nutation, barycentric sun, earth
    * we compute the planet */
-  if (ipli == SE_MOON && (iflag & (SEFLG_HELCTR | SEFLG_BARYCTR))) {
+  if (ne != NULL) {
+    nod_aps_epoch_restore(ne);
+  } else if (ipli == SE_MOON && (iflag & (SEFLG_HELCTR | SEFLG_BARYCTR))) {
     swi_force_app_pos_etc();
-    if (swe_calc(tjd_et, SE_SUN, iflg0, x, serr) == ERR)
+    if (swi_calc_save_area(tjd_et, SE_SUN, iflg0, x, serr) == ERR)
       return ERR;
   } else {
-    if (swe_calc(tjd_et, ipli, iflg0 | (iflag & SEFLG_TOPOCTR), x, serr) == ERR)
+    if (swi_calc_save_area(tjd_et, ipli, iflg0, x, serr) == ERR)
       return ERR;
   }
   /***********************
@@ -5499,16 +6292,20 @@ int32 CALL_CONV swe_nod_aps(double tjd_et, int32 ipl, int32 iflag,
        * the difference of speed of the earth between t and t-dt. 
        * Neglecting this would result in an error of several 0.1"
        */
-      if (iflag & SEFLG_SPEED) {
+      if ((iflag & SEFLG_SPEED) && ne != NULL) {
+        if (nod_aps_observer_speed(ne, ipl, iflag, dt, xobs2, serr) != OK)
+          return ERR;
+        for (i = 3; i <= 5; i++) 
+          xp[i] += xobs[i] - xobs2[i];
+      } else if (iflag & SEFLG_SPEED) {
         /* get barycentric sun and earth for t-dt into save area */
-        if (swe_calc(tjd_et - dt, ipli, iflg0 | (iflag & SEFLG_TOPOCTR), x2, serr) == ERR)
+        if (swi_calc_save_area(tjd_et - dt, ipli, iflg0, x2, serr) == ERR)
           return ERR;
         if (iflag & SEFLG_TOPOCTR) {
-          /* geocentric position of observer */
-          /* if (swi_get_observer(tjd_et - dt, iflag, FALSE, xobs, serr) != OK)
-            return ERR;*/
-          for (i = 0; i <= 5; i++)
-            xobs2[i] = swed.topd.xobs[i];
+          /* geocentric position of observer; swed.topd is not 
+           * computed for heliocentric positions */
+          if (swi_get_observer(tjd_et - dt, iflag | SEFLG_NONUT, FALSE, xobs2, serr) != OK)
+            return ERR;
         } else {
           for (i = 0; i <= 5; i++)
             xobs2[i] = 0;
@@ -5530,9 +6327,9 @@ int32 CALL_CONV swe_nod_aps(double tjd_et, int32 ipl, int32 iflag,
         /* The above call of swe_calc() has destroyed the
          * parts of the save area 
          * (i.e. bary sun, earth nutation matrix!). 
-         * to restore it:
+         * to restore it (the heliocentric sun would not):
          */
-        if (swe_calc(tjd_et, SE_SUN, iflg0 | (iflag & SEFLG_TOPOCTR), x2, serr) == ERR)
+        if (swi_calc_save_area(tjd_et, ipli == SE_MOON ? SE_SUN : ipli, iflg0, x2, serr) == ERR)
           return ERR;
       }
     }
@@ -5643,6 +6440,84 @@ int32 CALL_CONV swe_nod_aps(double tjd_et, int32 ipl, int32 iflag,
   return OK;
 }
 
+int32 CALL_CONV swe_nod_aps(double tjd_et, int32 ipl, int32 iflag, 
+                      int32  method,
+                      double *xnasc, double *xndsc, 
+                      double *xperi, double *xaphe, 
+                      char *serr)
+{
+  return nod_aps(tjd_et, ipl, iflag, method, xnasc, xndsc, xperi, xaphe, NULL, serr);
+}
+
+/*
+ * Array versions of swe_nod_aps()
+ *
+ * swe_nod_aps_arr() computes the nodes and apsides of nipl planets ipl[i] 
+ * at one date; ecliptic, nutation, observer and the positions of earth and
+ * sun are computed only once.
+ * swe_nod_aps_times() computes the nodes and apsides of one planet at 
+ * n dates tjd_et[i].
+ * Both return 24 doubles per planet or date in xret:
+ *   xret[24 * i + 0 .. 5]    ascending node
+ *   xret[24 * i + 6 .. 11]   descending node
+ *   xret[24 * i + 12 .. 17]  perihelion
+ *   xret[24 * i + 18 .. 23]  aphelion (or second focal point)
+ * The positions are those of swe_nod_aps() without SEFLG_SPEED. For the
+ * change of the observer's speed during the light-time, which enters the
+ * apparent speeds, the acceleration of earth and sun is taken as constant
+ * over light-time. The speeds differ from swe_nod_aps() by about 1e-5 
+ * degrees per day, and by up to 5e-4 for the topocentric lunar apsides.
+ * (With SEFLG_SPEED, swe_nod_aps() leaves earth and sun at t - dt in the
+ * save area after the first aberration, so its later positions are off
+ * by up to some 1e-6 degrees.)
+ * The functions return the number of planets or dates that could not be
+ * computed; their results are 0, and serr contains the error message of 
+ * the first one.
+ */
+int32 CALL_CONV swe_nod_aps_arr(double tjd_et, int32 *ipl, int32 nipl, 
+                      int32 iflag, int32 method, double *xret, char *serr)
+{
+  int32 i, j, nerr = 0;
+  struct nod_aps_epoch ne;
+  char *sp = serr;
+  AS_BOOL epoch_ok;
+  if (serr != NULL)
+    *serr = '\0';
+  epoch_ok = (nod_aps_epoch_init(tjd_et, iflag, &ne, sp) == OK);
+  for (i = 0; i < nipl; i++) {
+    double *xp = xret + 24 * i;
+    if (!epoch_ok || nod_aps(tjd_et, ipl[i], iflag, method, xp, xp + 6, xp + 12, xp + 18, &ne, sp) == ERR) {
+      for (j = 0; j < 24; j++)
+        xp[j] = 0;
+      /* keep the first error message */
+      nerr++;
+      sp = NULL;
+    }
+  }
+  return nerr;
+}
+
+int32 CALL_CONV swe_nod_aps_times(double *tjd_et, int32 n, int32 ipl, 
+                      int32 iflag, int32 method, double *xret, char *serr)
+{
+  int32 i, j, nerr = 0;
+  struct nod_aps_epoch ne;
+  char *sp = serr;
+  double *xp;
+  if (serr != NULL)
+    *serr = '\0';
+  for (i = 0, xp = xret; i < n; i++, xp += 24) {
+    if (nod_aps_epoch_init(tjd_et[i], iflag, &ne, sp) == ERR
+      || nod_aps(tjd_et[i], ipl, iflag, method, xp, xp + 6, xp + 12, xp + 18, &ne, sp) == ERR) {
+      for (j = 0; j < 24; j++)
+        xp[j] = 0;
+      nerr++;
+      sp = NULL;
+    }
+  }
+  return nerr;
+}
+
 int32 CALL_CONV swe_nod_aps_ut(double tjd_ut, int32 ipl, int32 iflag, 
                       int32  method,
                       double *xnasc, double *xndsc, 
@@ -5674,13 +6549,33 @@ static const double Gmsm_factor_AA[] = {
 0.99866025, 	/* Pluto */
 };
 #endif
-static int32 get_gmsm(double tjd_et, int32 ipl, int32 iflag, double r, double *gmsm, char *serr)
+/* heliocentric (or barycentric) distances of Mercury .. Pluto and the Earth,
+ * rpl[SE_MERCURY .. SE_PLUTO] and rpl[SE_EARTH], for the sum of the
+ * masses inside an asteroid orbit with SEFLG_ORBEL_AA */
+static int32 get_planet_distances(double tjd_et, int32 iflag, double *rpl, char *serr)
 {
   int j;
-  double Gmsm = 0, plm = 0, x[6];
+  double x[6];
   int32 iflJ2000p = (iflag & (SEFLG_EPHMASK |SEFLG_HELCTR|SEFLG_BARYCTR))|SEFLG_J2000|SEFLG_TRUEPOS|SEFLG_NONUT;
   if (!(iflJ2000p & (SEFLG_HELCTR|SEFLG_BARYCTR)))
     iflJ2000p |= SEFLG_HELCTR;
+  for (j = SE_MERCURY; j <= SE_PLUTO; j++) {
+    if (swe_calc(tjd_et, j, iflJ2000p, x, serr) == ERR)
+      return ERR;
+    rpl[j] = x[2];
+  }
+  if (swe_calc(tjd_et, SE_EARTH, iflJ2000p, x, serr) == ERR)
+    return ERR;
+  rpl[SE_EARTH] = x[2];
+  return OK;
+}
+
+/* rpl: distances from get_planet_distances(), or NULL if they have 
+ * to be computed */
+static int32 get_gmsm(double tjd_et, int32 ipl, int32 iflag, double r, double *rpl, double *gmsm, char *serr)
+{
+  int j;
+  double Gmsm = 0, plm = 0, rpls[SE_EARTH + 1];
   if (ipl == SE_MOON) {
     Gmsm = GEOGCONST * (1 + 1 / EARTH_MOON_MRAT) /AUNIT/AUNIT/AUNIT*86400.0*86400.0;
   } else {
@@ -5713,15 +6608,16 @@ static int32 get_gmsm(double tjd_et, int32 ipl, int32 iflag, double r, double *g
     } else {
       plm = 0;
       if (iflag & SEFLG_ORBEL_AA) {
-	for (j = SE_MERCURY; j <= SE_PLUTO; j++) {
-	  if (swe_calc(tjd_et, j, iflJ2000p, x, serr) == ERR)
+	if (rpl == NULL) {
+	  if (get_planet_distances(tjd_et, iflag, rpls, serr) == ERR)
 	    return ERR;
-	  if (r > x[2])
+	  rpl = rpls;
+	}
+	for (j = SE_MERCURY; j <= SE_PLUTO; j++) {
+	  if (r > rpl[j])
 	    plm += 1.0 / plmass[ipl_to_elem[j]];
 	}
-	if (swe_calc(tjd_et, SE_EARTH, iflJ2000p, x, serr) == ERR)
-	  return ERR;
-	if (r > x[2])
+	if (r > rpl[SE_EARTH])
 	  plm += 1.0 / plmass[ipl_to_elem[SE_EARTH]];
       }
       Gmsm = HELGRAVCONST * (1 + plm) /AUNIT/AUNIT/AUNIT*86400.0*86400.0;
@@ -5775,6 +6671,11 @@ int32 CALL_CONV swe_get_orbital_elements(
   int32 ipl, int32 iflag, 
   double *dret,
   char *serr) 
+{
+  return get_orbital_elements(tjd_et, ipl, iflag, NULL, dret, serr);
+}
+
+static int32 get_orbital_elements(double tjd_et, int32 ipl, int32 iflag, double *rpl, double *dret, char *serr)
 {
   int j;
   double x[6], xpos[6], xposm[6], xn[6], xs[6], xnorm[6], xq[6], xa[6] ;
@@ -5808,7 +6709,7 @@ int32 CALL_CONV swe_get_orbital_elements(
       iflJ2000 |= SEFLG_HELCTR;
     }
   }
-  if (get_gmsm(tjd_et, ipl, iflag, r, &Gmsm, serr))
+  if (get_gmsm(tjd_et, ipl, iflag, r, rpl, &Gmsm, serr))
     return ERR;
   if (swe_calc(tjd_et, ipl, iflJ2000, xpos, serr) == ERR)
     return ERR;
@@ -6014,14 +6915,49 @@ static double get_dist_from_2_vectors(double *x1, double *x2)
   return sqrt(r0 * r0 + r1 * r1 + r2 * r2);
 }
 
-static void osc_iterate_max_dist(double ean, double *pqr, double *xa, double *xb, double *deanopt, double *drmax, AS_BOOL high_prec)
+/* 
+ * An osculating ellipse, with its positions at the integer eccentric
+ * anomalies OSC_TAB_MIN .. OSC_TAB_MAX (degrees). The rough search for 
+ * maximum and minimum distance and the first (1-degree) steps of the 
+ * iterations need nothing else, and look the positions up.
+ */
+#define OSC_TAB_MIN	(-90)
+#define OSC_TAB_MAX	450
+struct osc_orbit {
+  double dp[50];	/* Kepler elements from swe_get_orbital_elements() */
+  double pqr[20];
+  double xtab[OSC_TAB_MAX - OSC_TAB_MIN + 1][3];
+};
+
+static void osc_orbit_init(struct osc_orbit *orb)
+{
+  int i;
+  osc_get_orbit_constants(orb->dp, orb->pqr);
+  for (i = OSC_TAB_MIN; i <= OSC_TAB_MAX; i++)
+    osc_get_ecl_pos((double) i, orb->pqr, orb->xtab[i - OSC_TAB_MIN]);
+}
+
+static void osc_orbit_pos(struct osc_orbit *orb, double ean, double *xp)
+{
+  double *xt;
+  if (ean >= OSC_TAB_MIN && ean <= OSC_TAB_MAX && ean == floor(ean)) {
+    xt = orb->xtab[(int) ean - OSC_TAB_MIN];
+    xp[0] = xt[0];
+    xp[1] = xt[1];
+    xp[2] = xt[2];
+  } else {
+    osc_get_ecl_pos(ean, orb->pqr, xp);
+  }
+}
+
+static void osc_iterate_max_dist(double ean, struct osc_orbit *orb, double *xa, double *xb, double *deanopt, double *drmax, AS_BOOL high_prec)
 {
   int i;
   double r, rmax, eansv = 0, dstep, dstep_min = 1;
   if (high_prec)
     dstep_min = 0.000001;
   ean = 0;
-  osc_get_ecl_pos(ean, pqr, xa);
+  osc_orbit_pos(orb, ean, xa);
   r = get_dist_from_2_vectors(xb, xa);
   rmax = r;
   dstep = 1;
@@ -6034,7 +6970,7 @@ static void osc_iterate_max_dist(double ean, double *pqr, double *xa, double *xb
 	  ean += dstep;
 	else
 	  ean -= dstep;
-	osc_get_ecl_pos(ean, pqr, xa);
+	osc_orbit_pos(orb, ean, xa);
 	r = get_dist_from_2_vectors(xb, xa);
 	if (r > rmax)
 	  rmax = r;
@@ -6050,14 +6986,14 @@ static void osc_iterate_max_dist(double ean, double *pqr, double *xa, double *xb
   *deanopt = eansv;
 }
 
-static void osc_iterate_min_dist(double ean, double *pqr, double *xa, double *xb, double *deanopt, double *drmin, AS_BOOL high_prec)
+static void osc_iterate_min_dist(double ean, struct osc_orbit *orb, double *xa, double *xb, double *deanopt, double *drmin, AS_BOOL high_prec)
 {
   int i;
   double r, rmin, eansv = 0, dstep, dstep_min = 1;
   if (high_prec)
     dstep_min = 0.000001;
   ean = 0;
-  osc_get_ecl_pos(ean, pqr, xa);
+  osc_orbit_pos(orb, ean, xa);
   r = get_dist_from_2_vectors(xb, xa);
   rmin = r;
   dstep = 1;
@@ -6070,7 +7006,7 @@ static void osc_iterate_min_dist(double ean, double *pqr, double *xa, double *xb
 	  ean += dstep;
 	else
 	  ean -= dstep;
-	osc_get_ecl_pos(ean, pqr, xa);
+	osc_orbit_pos(orb, ean, xa);
 	r = get_dist_from_2_vectors(xb, xa);
 	if (r < rmin)
 	  rmin = r;
@@ -6160,113 +7096,103 @@ static int32 orbit_max_min_true_distance_helio(double tjd_et, int ipl, int32 ifl
  */
 int32 CALL_CONV swe_orbit_max_min_true_distance(double tjd_et, int32 ipl, int32 iflag, double *dmax, double *dmin, double *dtrue, char *serr)
 {
-  int i, j, k, retval;
   int32 iflagi = (iflag & (SEFLG_EPHMASK | SEFLG_HELCTR | SEFLG_BARYCTR));
-  double dp[50], de[50];
-  double xouter[3], xinner[3], max_xouter[3], max_xinner[3], min_xouter[3], min_xinner[3], pqro[20], pqri[20];
+  struct osc_orbit orbp, orbe;
+  /* separate handling for the Sun, Moon and heliocentric calculation */
+  if (ipl == SE_SUN || ipl == SE_MOON || (iflagi & (SEFLG_HELCTR | SEFLG_BARYCTR)))
+    return orbit_max_min_true_distance_helio(tjd_et, ipl, iflagi, dmax, dmin, dtrue, serr);
+  if (swe_get_orbital_elements(tjd_et, ipl, iflagi, orbp.dp, serr) == ERR)
+    return ERR;
+  if (swe_get_orbital_elements(tjd_et, SE_EARTH, iflagi, orbe.dp, serr) == ERR)
+    return ERR;
+  osc_orbit_init(&orbe);
+  orbit_max_min_true_distance_geo(&orbp, &orbe, dmax, dmin, dtrue);
+  return OK;
+}
+
+/* geocentric maximum, minimum and true distance, see above.
+ * orbp holds the elements of the planet, orbe the elements and the 
+ * positions of the EMB, from osc_orbit_init() */
+static void orbit_max_min_true_distance_geo(struct osc_orbit *orbp, struct osc_orbit *orbe, double *dmax, double *dmin, double *dtrue)
+{
+  int i, j, k;
+  struct osc_orbit *outer, *inner;
+  double xouter[3], xinner[3], *xo, *xi;
   double eano, eani;
-  double *douter, *dinner;
   double r, rtrue, rmax = 0, rmin = 100000000, rminsv = 0, rmaxsv = 0;
-  double min_eanisv = 0, min_eanosv = 0, max_eanisv = 0, max_eanosv = 0;
+  int min_i = 0, min_j = 0, max_i = 0, max_j = 0;
   int ncnt;
-  double dstep;
+  int istep;
   double nitermax = 300;
-  /* separate handling for the Sun, Moon and heliocentric calculation */
-  if (ipl == SE_SUN || ipl == SE_MOON || (iflagi & (SEFLG_HELCTR | SEFLG_BARYCTR))) {
-    retval = orbit_max_min_true_distance_helio(tjd_et, ipl, iflagi, dmax, dmin, dtrue, serr);
-    return retval;
-  }
-  if ((retval = swe_get_orbital_elements(tjd_et, ipl, iflagi, dp, serr)) == ERR)
-    return ERR;
-  if ((retval = swe_get_orbital_elements(tjd_et, SE_EARTH, iflagi, de, serr)) == ERR)
-    return ERR;
-  if (de[0] > dp[0]) {
-    douter = de;
-    dinner = dp;
+  osc_orbit_init(orbp);
+  if (orbe->dp[0] > orbp->dp[0]) {
+    outer = orbe;
+    inner = orbp;
   } else {
-    douter = dp;
-    dinner = de;
-  }
-  osc_get_orbit_constants(douter, pqro);
-  osc_get_orbit_constants(dinner, pqri);
-  eano = douter[8]; // ecc. anomaly outer planet
-  eani = dinner[8]; // ecc. anomaly inner planet
-  osc_get_ecl_pos(eano, pqro, xouter); // coordinates outer planet J2000
-  osc_get_ecl_pos(eani, pqri, xinner); // coordinates inner planet J2000
+    outer = orbp;
+    inner = orbe;
+  }
+  eano = outer->dp[8]; // ecc. anomaly outer planet
+  eani = inner->dp[8]; // ecc. anomaly inner planet
+  osc_get_ecl_pos(eano, outer->pqr, xouter); // coordinates outer planet J2000
+  osc_get_ecl_pos(eani, inner->pqr, xinner); // coordinates inner planet J2000
   rtrue = get_dist_from_2_vectors(xouter, xinner); // true distance between them
-//  printf("rtrue=%.17f\n", rtrue);
   /* search rough maximum and minimum distance for objects on the two ellipses.
    * Attention, there may be two minima or maxima, and we need the smaller 
    * minimum and the greate maximum. 
    * To find minima and maxima, we start with a rough calculation: We move the
-   * one planet through the whole orbit in two-degree steps. For each step, 
-   * we move the other planet through its own whole orbit at two-degree steps.
+   * outer planet through the whole orbit in two-degree steps. For each step, 
+   * we move the inner planet through half its orbit at one-degree steps.
    * In vary rare cases we may get the wrong minimum. To avoid that, we would
    * have to make smaller steps, but that would considerably reduce 
    * performance. A faster algorithm without this problem would require 
    * considerably higher sophistication.
+   * The positions come from the tables of the two ellipses, and squares of
+   * distances are compared.
    * */
   ncnt = 182;
-  dstep = 2;
-  for (i = 0; i < 3; i++) { /* initialisation */
-    max_xouter[i] = 0;
-    max_xinner[i] = 0;
-    min_xouter[i] = 0;
-    min_xinner[i] = 0;
-  }
+  istep = 2;
   for (j = 0; j < ncnt; j++) {
-    eano = (double) j * dstep;
-    osc_get_ecl_pos(eano, pqro, xouter);
+    xo = outer->xtab[j * istep - OSC_TAB_MIN];
     for (i = 0; i < ncnt; i++) {
-      eani = (double) i;
-      osc_get_ecl_pos(eani, pqri, xinner);
-      r = get_dist_from_2_vectors(xouter, xinner);
-      /* maximum/minimum found; save positions and ecc. anomalies */
+      xi = inner->xtab[i - OSC_TAB_MIN];
+      r = (xo[0] - xi[0]) * (xo[0] - xi[0]) 
+        + (xo[1] - xi[1]) * (xo[1] - xi[1]) 
+        + (xo[2] - xi[2]) * (xo[2] - xi[2]);
+      /* maximum/minimum found; save ecc. anomalies */
       if (r > rmax) {
         rmax = r;
-        max_eanisv = eani;
-        max_eanosv = eano;
-	for (k = 0; k < 3; k++) {
-	  max_xouter[k] = xouter[k];
-	  max_xinner[k] = xinner[k];
-	}
+        max_i = i;
+        max_j = j;
       }
       if (r < rmin) {
         rmin = r;
-        min_eanisv = eani;
-        min_eanosv = eano;
-	for (k = 0; k < 3; k++) {
-	  min_xouter[k] = xouter[k];
-	  min_xinner[k] = xinner[k];
-	}
+        min_i = i;
+        min_j = j;
       }
     }
   }
   /* find accurate values, starting iterations from above-calculated rough values; 
    * maximum distance: */
-  eani = max_eanisv;
-  eano = max_eanosv;
-  for (k = 0; k < 3; k++) {
-    xouter[k] = max_xouter[k];
-    xinner[k] = max_xinner[k];
-  }
+  eani = (double) max_i;
+  eano = (double) (max_j * istep);
+  osc_orbit_pos(outer, eano, xouter);
+  osc_orbit_pos(inner, eani, xinner);
   for (k = 0; k <= nitermax; k++) {
-    osc_iterate_max_dist(eani, pqri, xinner, xouter, &eani, &rmax, TRUE);
-    osc_iterate_max_dist(eano, pqro, xouter, xinner, &eano, &rmax, TRUE);
+    osc_iterate_max_dist(eani, inner, xinner, xouter, &eani, &rmax, TRUE);
+    osc_iterate_max_dist(eano, outer, xouter, xinner, &eano, &rmax, TRUE);
     if (k > 0 && fabs(rmax - rmaxsv) < 0.00000001)
       break;
     rmaxsv = rmax;
   }
   /* minimum distance: */
-  eani = min_eanisv;
-  eano = min_eanosv;
-  for (k = 0; k < 3; k++) {
-    xouter[k] = min_xouter[k];
-    xinner[k] = min_xinner[k];
-  }
+  eani = (double) min_i;
+  eano = (double) (min_j * istep);
+  osc_orbit_pos(outer, eano, xouter);
+  osc_orbit_pos(inner, eani, xinner);
   for (k = 0; k <= nitermax; k++) {
-    osc_iterate_min_dist(eani, pqri, xinner, xouter, &eani, &rmin, TRUE);
-    osc_iterate_min_dist(eano, pqro, xouter, xinner, &eano, &rmin, TRUE);
+    osc_iterate_min_dist(eani, inner, xinner, xouter, &eani, &rmin, TRUE);
+    osc_iterate_min_dist(eano, outer, xouter, xinner, &eano, &rmin, TRUE);
     if (k > 0 && fabs(rmin - rminsv) < 0.00000001)
       break;
     rminsv = rmin;
@@ -6274,7 +7200,83 @@ int32 CALL_CONV swe_orbit_max_min_true_distance(double tjd_et, int32 ipl, int32
   *dmax = rmax;
   *dmin = rmin;
   *dtrue = rtrue;
-  return retval;
+}
+
+/*
+ * Array versions of swe_get_orbital_elements() and 
+ * swe_orbit_max_min_true_distance() for nipl bodies ipl[i] at one epoch.
+ * swe_get_orbital_elements_arr() returns 17 doubles per body in dret, 
+ * dret[17 * i + 0 .. 16] as dret[0 .. 16] of swe_get_orbital_elements().
+ * The distances of the planets, which SEFLG_ORBEL_AA needs for the masses 
+ * inside the orbit of an asteroid, are computed once.
+ * swe_orbit_max_min_true_distance_arr() returns 3 doubles per body:
+ *   dret[3 * i + 0]   maximum distance
+ *   dret[3 * i + 1]   minimum distance
+ *   dret[3 * i + 2]   true distance
+ * The elements of the EMB and their positions on the ellipse are computed
+ * once.
+ * Both functions return the number of bodies that could not be computed;
+ * their results are 0, and serr contains the error message of the first one.
+ */
+int32 CALL_CONV swe_get_orbital_elements_arr(double tjd_et, int32 *ipl, int32 nipl, 
+                      int32 iflag, double *dret, char *serr)
+{
+  int32 i, j, nerr = 0;
+  double rpl[SE_EARTH + 1], *prpl = NULL;
+  char *sp = serr;
+  AS_BOOL epoch_ok = TRUE;
+  if (serr != NULL)
+    *serr = '\0';
+  if (iflag & SEFLG_ORBEL_AA) {
+    epoch_ok = (get_planet_distances(tjd_et, iflag, rpl, sp) == OK);
+    prpl = rpl;
+  }
+  for (i = 0; i < nipl; i++) {
+    double *dp = dret + 17 * i;
+    if (!epoch_ok || get_orbital_elements(tjd_et, ipl[i], iflag, prpl, dp, sp) == ERR) {
+      for (j = 0; j < 17; j++)
+        dp[j] = 0;
+      /* keep the first error message */
+      nerr++;
+      sp = NULL;
+    }
+  }
+  return nerr;
+}
+
+int32 CALL_CONV swe_orbit_max_min_true_distance_arr(double tjd_et, int32 *ipl, int32 nipl, 
+                      int32 iflag, double *dret, char *serr)
+{
+  int32 i, nerr = 0;
+  int32 iflagi = (iflag & (SEFLG_EPHMASK | SEFLG_HELCTR | SEFLG_BARYCTR));
+  struct osc_orbit orbp, orbe;
+  char *sp = serr;
+  int32 retc;
+  AS_BOOL have_emb = FALSE;
+  if (serr != NULL)
+    *serr = '\0';
+  for (i = 0; i < nipl; i++) {
+    double *dp = dret + 3 * i;
+    if (ipl[i] == SE_SUN || ipl[i] == SE_MOON || (iflagi & (SEFLG_HELCTR | SEFLG_BARYCTR))) {
+      retc = orbit_max_min_true_distance_helio(tjd_et, ipl[i], iflagi, dp, dp + 1, dp + 2, sp);
+    } else if ((retc = swe_get_orbital_elements(tjd_et, ipl[i], iflagi, orbp.dp, sp)) != ERR) {
+      if (!have_emb) {
+        if ((retc = swe_get_orbital_elements(tjd_et, SE_EARTH, iflagi, orbe.dp, sp)) != ERR) {
+          osc_orbit_init(&orbe);
+          have_emb = TRUE;
+        }
+      }
+      if (have_emb)
+        orbit_max_min_true_distance_geo(&orbp, &orbe, dp, dp + 1, dp + 2);
+    }
+    if (retc == ERR) {
+      dp[0] = dp[1] = dp[2] = 0;
+      /* keep the first error message */
+      nerr++;
+      sp = NULL;
+    }
+  }
+  return nerr;
 }
 
 /* function finds the gauquelin sector position of a planet or fixed star
@@ -6313,10 +7315,67 @@ int32 CALL_CONV swe_gauquelin_sector(
                    *only useful with imeth=3 */
   double *dgsect, /* return address for gauquelin sector position */
   char *serr)     /* return address for error message */
+{
+  return gauquelin_sector(t_ut, ipl, starname, iflag, imeth, geopos, atpress, attemp, NULL, dgsect, serr);
+}
+
+/*
+ * setup of a time and place that is shared by the bodies of
+ * swe_gauquelin_sector_arr() 
+ */
+struct gauq_epoch {
+  double t_et, eps, armc;	/* for imeth 0 and 1 */
+  struct rise_epoch re;		/* for imeth 2 - 5 */
+};
+
+static void gauq_epoch_init(struct gauq_epoch *ge, double t_ut, int32 iflag, int32 imeth,
+  double *geopos, double atpress, double attemp, char *serr)
+{
+  double nutlo[2];
+  if (imeth == 0 || imeth == 1) {
+    ge->t_et = t_ut + swe_deltat_ex(t_ut, iflag, serr);
+    ge->eps = swi_epsiln(ge->t_et, iflag) * RADTODEG;
+    swi_nutation(ge->t_et, iflag, nutlo);
+    nutlo[0] *= RADTODEG;
+    nutlo[1] *= RADTODEG;
+    ge->armc = swe_degnorm(swe_sidtime0(t_ut, ge->eps + nutlo[1], nutlo[0]) * 15 + geopos[0]);
+    ge->eps += nutlo[1];
+  } else {
+    rise_epoch_init(&ge->re, t_ut, geopos, atpress, attemp);
+  }
+}
+
+/* next rising tret[0] and setting tret[1] after tjd_ut, as swe_rise_trans()
+ * finds them, with its return values in retc[0] and retc[1]; with the slow
+ * method, the heights of a planet are computed once for both */
+static int32 rise_set_next(double tjd_ut, int32 ipl, char *starname, int32 epheflag, int32 risemeth,
+  double *geopos, double atpress, double attemp, struct rise_epoch *re, 
+  double *tret, int32 *retc, char *serr)
+{
+  struct rise_hor rh;
+  AS_BOOL do_fixstar = (starname != NULL && *starname != '\0');
+  if (do_fixstar || rise_use_fast(ipl, starname, SE_CALC_RISE|risemeth, geopos)) {
+    if ((retc[0] = rise_trans(tjd_ut, ipl, starname, epheflag, SE_CALC_RISE|risemeth, geopos, atpress, attemp, re, &tret[0], serr)) == ERR
+      || (retc[1] = rise_trans(tjd_ut, ipl, starname, epheflag, SE_CALC_SET|risemeth, geopos, atpress, attemp, re, &tret[1], serr)) == ERR)
+      return ERR;
+    return OK;
+  }
+  tret[0] = tret[1] = 0;
+  if (rise_hor_init(&rh, tjd_ut, ipl, NULL, epheflag, SE_CALC_RISE|SE_CALC_SET|risemeth, geopos, atpress, attemp, 0, serr) == ERR
+    || rise_hor_heights(&rh, re, serr) == ERR
+    || (retc[0] = rise_hor_find(&rh, SE_CALC_RISE, &tret[0], serr)) == ERR
+    || (retc[1] = rise_hor_find(&rh, SE_CALC_SET, &tret[1], serr)) == ERR)
+    return ERR;
+  return OK;
+}
+
+/* swe_gauquelin_sector() with an optional epoch ge of t_ut and geopos */
+static int32 gauquelin_sector(double t_ut, int32 ipl, char *starname, int32 iflag, int32 imeth,
+  double *geopos, double atpress, double attemp, struct gauq_epoch *ge, double *dgsect, char *serr)
 {
   AS_BOOL rise_found = TRUE;
   AS_BOOL set_found = TRUE;
-  int32 retval;
+  int32 retval, retc[2];
   double tret[3];
   double t_et, t;
   double x0[6];
@@ -6325,6 +7384,7 @@ int32 CALL_CONV swe_gauquelin_sector(
   AS_BOOL do_fixstar = (starname != NULL && *starname != '\0');
   int32 risemeth = 0;
   AS_BOOL above_horizon = FALSE;
+  struct rise_epoch *re = (ge != NULL) ? &ge->re : NULL;
   if (imeth < 0 || imeth > 5) {
     if (serr)
           sprintf(serr, "invalid method: %d", imeth);
@@ -6338,12 +7398,19 @@ int32 CALL_CONV swe_gauquelin_sector(
    * geometrically from ecl. longitude and latitude 
    */
   if (imeth == 0 || imeth == 1) {
-    t_et = t_ut + swe_deltat_ex(t_ut, iflag, serr);
-    eps = swi_epsiln(t_et, iflag) * RADTODEG;
-    swi_nutation(t_et, iflag, nutlo);
-    nutlo[0] *= RADTODEG;
-    nutlo[1] *= RADTODEG;
-    armc = swe_degnorm(swe_sidtime0(t_ut, eps + nutlo[1], nutlo[0]) * 15 + geopos[0]);
+    if (ge != NULL) {
+      t_et = ge->t_et;
+      eps = ge->eps;
+      armc = ge->armc;
+    } else {
+      t_et = t_ut + swe_deltat_ex(t_ut, iflag, serr);
+      eps = swi_epsiln(t_et, iflag) * RADTODEG;
+      swi_nutation(t_et, iflag, nutlo);
+      nutlo[0] *= RADTODEG;
+      nutlo[1] *= RADTODEG;
+      armc = swe_degnorm(swe_sidtime0(t_ut, eps + nutlo[1], nutlo[0]) * 15 + geopos[0]);
+      eps += nutlo[1];
+    }
     if (do_fixstar) {
       if (swe_fixstar(starname, t_et, iflag, x0, serr) == ERR)
 	return ERR;
@@ -6353,7 +7420,7 @@ int32 CALL_CONV swe_gauquelin_sector(
     }
     if (imeth == 1) 
       x0[1] = 0;
-    *dgsect = swe_house_pos(armc, geopos[1], eps + nutlo[1], 'G', x0, NULL);
+    *dgsect = swe_house_pos(armc, geopos[1], eps, 'G', x0, NULL);
     return OK;
   }
   /* 
@@ -6363,11 +7430,10 @@ int32 CALL_CONV swe_gauquelin_sector(
     risemeth |= SE_BIT_NO_REFRACTION;
   if (imeth == 2 || imeth == 3)
     risemeth |= SE_BIT_DISC_CENTER;
-  /* find the next rising time of the planet or star */
-  retval = swe_rise_trans(t_ut, ipl, starname, epheflag, SE_CALC_RISE|risemeth, geopos, atpress, attemp, &(tret[0]), serr);
-  if (retval == ERR) {
+  /* find the next rising and setting times of the planet or star */
+  if (rise_set_next(t_ut, ipl, starname, epheflag, risemeth, geopos, atpress, attemp, re, tret, retc, serr) == ERR)
     return ERR; 
-  } else if (retval == -2) {
+  if (retc[0] == -2) {
     /* actually, we could return ERR here. However, we
      * keep this variable, in case we implement an algorithm
      * for Gauquelin sector positions of circumpolar bodies.
@@ -6382,11 +7448,7 @@ int32 CALL_CONV swe_gauquelin_sector(
      */
     rise_found = FALSE;    
   }
-  /* find the next setting time of the planet or star */
-  retval = swe_rise_trans(t_ut, ipl, starname, epheflag, SE_CALC_SET|risemeth, geopos, atpress, attemp, &(tret[1]), serr);
-  if (retval == ERR) {
-    return ERR; 
-  } else if (retval == -2) {
+  if (retc[1] == -2) {
     set_found = FALSE;
   }
   if (tret[0] < tret[1] && rise_found == TRUE) {
@@ -6395,7 +7457,7 @@ int32 CALL_CONV swe_gauquelin_sector(
     t = t_ut - 1.2;
     if (set_found) t = tret[1] - 1.2;
     set_found = TRUE;
-    retval = swe_rise_trans(t, ipl, starname, epheflag, SE_CALC_SET|risemeth, geopos, atpress, attemp, &(tret[1]), serr);
+    retval = rise_trans(t, ipl, starname, epheflag, SE_CALC_SET|risemeth, geopos, atpress, attemp, re, &(tret[1]), serr);
     if (retval == ERR) {
       return ERR; 
     } else if (retval == -2) {
@@ -6407,7 +7469,7 @@ int32 CALL_CONV swe_gauquelin_sector(
     t = t_ut - 1.2;
     if (rise_found) t = tret[0] - 1.2;
     rise_found = TRUE;
-    retval = swe_rise_trans(t, ipl, starname, epheflag, SE_CALC_RISE|risemeth, geopos, atpress, attemp, &(tret[0]), serr);
+    retval = rise_trans(t, ipl, starname, epheflag, SE_CALC_RISE|risemeth, geopos, atpress, attemp, re, &(tret[0]), serr);
     if (retval == ERR) {
       return ERR; 
     } else if (retval == -2) {
@@ -6428,3 +7490,879 @@ int32 CALL_CONV swe_gauquelin_sector(
     return ERR;
   }
 }
+
+/*
+ * Gauquelin sectors of the bodies ipl[0 .. nipl - 1] for nrec records 
+ * of time tjd_ut[i] and place geopos[3 * i .. 3 * i + 2]; the sector 
+ * of body j in record i is returned in dgsect[i * nipl + j]. Iflag, 
+ * imeth, atpress and attemp are as with swe_gauquelin_sector(), and 
+ * so are the results. 
+ * Delta T, sidereal time and refraction at the horizon of a record are 
+ * shared by its bodies, and with imeth = 2 - 5 the slow method (near the
+ * poles) finds rising and setting from one series of heights of a body.
+ * The records are computed by nthreads threads. 
+ * Sectors that cannot be computed, e.g. of circumpolar bodies, are 0.
+ * Returns the number of these; serr gets the first error message.
+ */
+#define GAUQ_BLOCK	16	/* records per work item of a thread */
+struct gauq_range {
+  double *tjd_ut, *geopos, atpress, attemp, *dgsect;
+  int32 nrec, *ipl, nipl, iflag, imeth;
+  int32 *nerr;
+  char (*serr)[AS_MAXCH];
+};
+
+static void gauq_range_block(int32 iblk, void *arg)
+{
+  struct gauq_range *r = (struct gauq_range *) arg;
+  struct gauq_epoch ge;
+  int32 i, j, iend = (iblk + 1) * GAUQ_BLOCK;
+  char *sp = r->serr[iblk];
+  if (iend > r->nrec)
+    iend = r->nrec;
+  *sp = '\0';
+  r->nerr[iblk] = 0;
+  for (i = iblk * GAUQ_BLOCK; i < iend; i++) {
+    double *geopos = &r->geopos[i * 3];
+    gauq_epoch_init(&ge, r->tjd_ut[i], r->iflag, r->imeth, geopos, r->atpress, r->attemp, NULL);
+    for (j = 0; j < r->nipl; j++) {
+      double *dp = &r->dgsect[i * r->nipl + j];
+      if (gauquelin_sector(r->tjd_ut[i], r->ipl[j], NULL, r->iflag, r->imeth, geopos, 
+            r->atpress, r->attemp, &ge, dp, sp) == ERR) {
+        *dp = 0;
+        /* keep the first error message */
+        r->nerr[iblk]++;
+        sp = NULL;
+      }
+    }
+  }
+}
+
+int32 CALL_CONV swe_gauquelin_sector_arr(double *tjd_ut, double *geopos, int32 nrec, 
+  int32 *ipl, int32 nipl, int32 iflag, int32 imeth, double atpress, double attemp, 
+  int32 nthreads, double *dgsect, char *serr)
+{
+  struct gauq_range r;
+  int32 i, nblk, nerr = 0;
+  if (serr != NULL)
+    *serr = '\0';
+  if (nrec <= 0 || nipl <= 0)
+    return 0;
+  nblk = (nrec + GAUQ_BLOCK - 1) / GAUQ_BLOCK;
+  r.tjd_ut = tjd_ut;
+  r.geopos = geopos;
+  r.atpress = atpress;
+  r.attemp = attemp;
+  r.dgsect = dgsect;
+  r.nrec = nrec;
+  r.ipl = ipl;
+  r.nipl = nipl;
+  r.iflag = iflag;
+  r.imeth = imeth;
+  r.nerr = (int32 *) calloc(nblk, sizeof(int32));
+  r.serr = (char (*)[AS_MAXCH]) calloc(nblk, AS_MAXCH);
+  if (r.nerr == NULL || r.serr == NULL) {
+    for (i = 0; i < nrec * nipl; i++)
+      dgsect[i] = 0;
+    if (serr != NULL)
+      strcpy(serr, "swe_gauquelin_sector_arr: out of memory");
+    nerr = nrec * nipl;
+  } else {
+    swi_parallel_for(nthreads, nblk, gauq_range_block, &r);
+    for (i = 0; i < nblk; i++) {
+      /* blocks are in order of records */
+      if (r.nerr[i] > 0 && nerr == 0 && serr != NULL)
+        strcpy(serr, r.serr[i]);
+      nerr += r.nerr[i];
+    }
+  }
+  if (r.nerr != NULL)
+    free(r.nerr);
+  if (r.serr != NULL)
+    free(r.serr);
+  return nerr;
+}
+
+/*
+ * Eclipse and occultation catalog.
+ *
+ * swe_ecl_catalog_make() runs the global search functions over a range
+ * of dates and stores the maximum time, type, magnitude and saros of
+ * every event found in the file SE_ECLCATFILE, sorted by time. 
+ * swe_ecl_catalog_when() answers the same questions as
+ * swe_sol_eclipse_when_glob(), swe_lun_eclipse_when() and 
+ * swe_lun_occult_when_glob() by binary search in this file and 
+ * falls back to these functions outside the range of the catalog.
+ *
+ * The body number ipl selects the kind of event:
+ * SE_SUN:	solar eclipses
+ * SE_MOON:	lunar eclipses
+ * other:	occultations of planet or asteroid ipl by the moon
+ *
+ * The file consists of a header, the body numbers of the catalog and 
+ * an array of records, in the byte order of the machine that made it.
+ * Bodies that are not in the catalog and other ephemerides than the
+ * one of the catalog are searched live.
+ */
+#define ECLCAT_MAGIC	"SECL"
+#define ECLCAT_VERSION	2
+#define ECLCAT_TYPES	(SE_ECL_ALLTYPES_SOLAR | SE_ECL_PENUMBRAL)
+
+struct eclcat_head {
+  char magic[4];
+  int32 version;
+  double tjd_start;	/* events with maximum in tjd_start .. tjd_end, UT */
+  double tjd_end;
+  int32 iflag;		/* ephemeris flag used */
+  int32 nipl;		/* number of bodies, followed by their numbers */
+  int32 nrec;
+};
+
+struct eclcat_rec {
+  double tjd;		/* time of maximum, UT */
+  float mag;		/* attr[0] of the _where()/_how() functions */
+  int32 type;		/* SE_ECL_TOTAL etc. */
+  int32 ipl;
+  int16 saros;		/* saros series, 0 if unknown */
+  int16 saros_member;
+};
+
+static TLS struct {
+  AS_BOOL is_loaded;
+  struct eclcat_head head;
+  int32 *ipl;
+  struct eclcat_rec *rec;	/* NULL if there is no catalog */
+} eclcat;
+
+void swi_close_ecl_catalog(void)
+{
+  if (eclcat.ipl != NULL)
+    free(eclcat.ipl);
+  if (eclcat.rec != NULL)
+    free(eclcat.rec);
+  memset((void *) &eclcat, 0, sizeof(eclcat));
+}
+
+static void eclcat_load(void)
+{
+  FILE *fp;
+  struct eclcat_head h;
+  eclcat.is_loaded = TRUE;
+  if (!swed.ephe_path_is_set)
+    swe_set_ephe_path(NULL);
+  if ((fp = swi_fopen(-1, SE_ECLCATFILE, swed.ephepath, NULL)) == NULL)
+    return;
+  if (fread(&h, sizeof(h), 1, fp) == 1
+    && strncmp(h.magic, ECLCAT_MAGIC, 4) == 0
+    && h.version == ECLCAT_VERSION && h.nrec >= 0 && h.nipl >= 0
+    && (eclcat.ipl = (int32 *) malloc((h.nipl + 1) * sizeof(int32))) != NULL
+    && (eclcat.rec = (struct eclcat_rec *) malloc((h.nrec + 1) * sizeof(struct eclcat_rec))) != NULL) {
+    if (fread(eclcat.ipl, sizeof(int32), (size_t) h.nipl, fp) == (size_t) h.nipl
+      && fread(eclcat.rec, sizeof(struct eclcat_rec), (size_t) h.nrec, fp) == (size_t) h.nrec) {
+      eclcat.head = h;
+    } else {
+      free(eclcat.rec);
+      eclcat.rec = NULL;
+    }
+  }
+  if (eclcat.rec == NULL && eclcat.ipl != NULL) {
+    free(eclcat.ipl);
+    eclcat.ipl = NULL;
+  }
+  fclose(fp);
+}
+
+/* ephemeris bits of ifl, with the default made explicit */
+static int32 eclcat_ephe(int32 ifl)
+{
+  ifl &= SEFLG_EPHMASK;
+  if (ifl == 0)
+    ifl = SEFLG_DEFAULTEPH;
+  return ifl;
+}
+
+/* whether the catalog has the events of body ipl with ephemeris ifl */
+static AS_BOOL eclcat_has(int32 ipl, int32 ifl)
+{
+  int32 i;
+  if (eclcat.rec == NULL || eclcat_ephe(ifl) != eclcat.head.iflag)
+    return FALSE;
+  for (i = 0; i < eclcat.head.nipl; i++)
+    if (eclcat.ipl[i] == ipl)
+      return TRUE;
+  return FALSE;
+}
+
+/* 
+ * Normalises ifltype as the search functions do. Returns ERR for 
+ * combinations they reject, which are then left to them to report.
+ */
+static int32 eclcat_norm_type(int32 ipl, int32 ifltype)
+{
+  if (ipl == SE_MOON) {
+    ifltype &= ~(SE_ECL_CENTRAL|SE_ECL_NONCENTRAL);
+    if (ifltype & (SE_ECL_ANNULAR|SE_ECL_ANNULAR_TOTAL)) {
+      ifltype &= ~(SE_ECL_ANNULAR|SE_ECL_ANNULAR_TOTAL);
+      if (ifltype == 0)
+        return ERR;
+    }
+    if (ifltype == 0)
+      ifltype = SE_ECL_ALLTYPES_LUNAR;
+    return ifltype;
+  }
+  if (ifltype == (SE_ECL_PARTIAL | SE_ECL_CENTRAL))
+    return ERR;
+  if (ipl == SE_SUN) {
+    if (ifltype == (SE_ECL_ANNULAR_TOTAL | SE_ECL_NONCENTRAL))
+      return ERR;
+    if (ifltype == 0)
+      ifltype = SE_ECL_ALLTYPES_SOLAR;
+    if (ifltype == SE_ECL_TOTAL || ifltype == SE_ECL_ANNULAR || ifltype == SE_ECL_ANNULAR_TOTAL)
+      ifltype |= (SE_ECL_NONCENTRAL | SE_ECL_CENTRAL);
+    if (ifltype == SE_ECL_PARTIAL)
+      ifltype |= SE_ECL_NONCENTRAL;
+    return ifltype;
+  }
+  if ((ifltype & ~(SE_ECL_NONCENTRAL | SE_ECL_CENTRAL)) == SE_ECL_ANNULAR 
+    || ifltype == SE_ECL_ANNULAR_TOTAL)
+    return ERR;
+  ifltype &= ~(SE_ECL_ANNULAR|SE_ECL_ANNULAR_TOTAL);
+  if (ifltype == 0)
+    ifltype = SE_ECL_TOTAL | SE_ECL_PARTIAL | SE_ECL_NONCENTRAL | SE_ECL_CENTRAL;
+  if (ifltype & SE_ECL_TOTAL)
+    ifltype |= (SE_ECL_NONCENTRAL | SE_ECL_CENTRAL);
+  if (ifltype & SE_ECL_PARTIAL)
+    ifltype |= SE_ECL_NONCENTRAL;
+  return ifltype;
+}
+
+/* live search for the next event of body ipl, see swe_ecl_catalog_when() */
+static int32 eclcat_search(double tjd_start, int32 ipl, int32 ifl, int32 ifltype, 
+     double *tret, int32 backward, char *serr)
+{
+  if (ipl == SE_SUN)
+    return swe_sol_eclipse_when_glob(tjd_start, ifl, ifltype, tret, backward, serr);
+  if (ipl == SE_MOON)
+    return swe_lun_eclipse_when(tjd_start, ifl, ifltype, tret, backward, serr);
+  return swe_lun_occult_when_glob(tjd_start, ipl, NULL, ifl, ifltype, tret, backward, serr);
+}
+
+/* magnitude and saros of the event of body ipl with maximum at tjd */
+static int32 eclcat_attr(double tjd, int32 ipl, int32 ifl, double *attr, char *serr)
+{
+  double geopos[20];
+  int i;
+  for (i = 0; i < 20; i++)
+    attr[i] = geopos[i] = 0;
+  if (ipl == SE_SUN)
+    return swe_sol_eclipse_where(tjd, ifl, geopos, attr, serr);
+  if (ipl == SE_MOON)
+    return swe_lun_eclipse_how(tjd, ifl, geopos, attr, serr);
+  return swe_lun_occult_where(tjd, ipl, NULL, ifl, geopos, attr, serr);
+}
+
+static int eclcat_compare(const void *a, const void *b)
+{
+  const struct eclcat_rec *r1 = (const struct eclcat_rec *) a;
+  const struct eclcat_rec *r2 = (const struct eclcat_rec *) b;
+  if (r1->tjd != r2->tjd)
+    return r1->tjd < r2->tjd ? -1 : 1;
+  return (r1->ipl > r2->ipl) - (r1->ipl < r2->ipl);
+}
+
+/* events found by eclcat_scan() */
+struct ecl_event {
+  double tret[10];
+  int32 retflag;
+};
+
+struct ecl_event_list {
+  struct ecl_event *ev;
+  int32 n, nalloc;
+};
+
+/*
+ * Appends to el all events of type ifltype of body ipl (SE_SUN: solar
+ * eclipses, SE_MOON: lunar eclipses, other: occultations) with maximum 
+ * from tjd_start to before tjd_end, in order of time.
+ */
+static int32 eclcat_scan(double tjd_start, double tjd_end, int32 ipl, int32 ifl, int32 ifltype,
+     struct ecl_event_list *el, char *serr)
+{
+  int32 retflag;
+  double t = tjd_start, tret[10];
+  struct ecl_event *ev;
+  for (;;) {
+    if (ipl == SE_SUN || ipl == SE_MOON)
+      retflag = eclcat_search(t, ipl, ifl, ifltype, tret, 0, serr);
+    else
+      retflag = eclcat_search(t, ipl, ifl, ifltype, tret, SE_ECL_ONE_TRY, serr);
+    if (retflag == ERR)
+      return ERR;
+    /* with SE_ECL_ONE_TRY, 0 means no occultation at this conjunction */
+    if (tret[0] >= tjd_end)
+      return OK;
+    t = (tret[0] > t ? tret[0] : t) + 1;
+    if (retflag == 0)
+      continue;
+    if (el->n == el->nalloc) {
+      el->nalloc = el->nalloc * 2 + 64;
+      if ((ev = (struct ecl_event *) realloc(el->ev, el->nalloc * sizeof(struct ecl_event))) == NULL) {
+        if (serr != NULL)
+          strcpy(serr, "eclipse search: out of memory");
+        return ERR;
+      }
+      el->ev = ev;
+    }
+    ev = &el->ev[el->n++];
+    memcpy(ev->tret, tret, 10 * sizeof(double));
+    ev->retflag = retflag;
+  }
+}
+
+/*
+ * Computes the catalog of all solar eclipses, lunar eclipses and
+ * occultations of the bodies ipl[0..nipl-1] (SE_SUN and SE_MOON for 
+ * eclipses) with maximum between tjd_start and tjd_end (UT) and 
+ * writes it to the file SE_ECLCATFILE in directory dir. If dir is 
+ * NULL or "", the first directory of the ephemeris path is used.
+ */
+int32 CALL_CONV swe_ecl_catalog_make(double tjd_start, double tjd_end, 
+     int32 *ipl, int32 nipl, int32 ifl, char *dir, char *serr)
+{
+  struct eclcat_head h;
+  struct eclcat_rec *rec = NULL, *rp;
+  struct ecl_event_list el;
+  int32 nrec = 0, i, j, retc = OK;
+  double attr[20];
+  char fname[AS_MAXCH], ftmp[AS_MAXCH + 4], s[AS_MAXCH];
+  const char *wdir;
+  FILE *fp;
+  ifl &= SEFLG_EPHMASK;
+  wdir = swi_ephe_write_dir(dir, s);
+  if (strlen(wdir) + strlen(SE_ECLCATFILE) + 2 >= AS_MAXCH) {
+    if (serr != NULL)
+      strcpy(serr, "swe_ecl_catalog_make: directory name too long");
+    return ERR;
+  }
+  memset((void *) &el, 0, sizeof(el));
+  for (i = 0; i < nipl && retc == OK; i++) {
+    j = el.n;
+    if ((retc = eclcat_scan(tjd_start, tjd_end, ipl[i], ifl, 0, &el, serr)) != OK)
+      break;
+    if ((rp = (struct eclcat_rec *) realloc(rec, (el.n + 1) * sizeof(struct eclcat_rec))) == NULL) {
+      if (serr != NULL)
+        strcpy(serr, "swe_ecl_catalog_make: out of memory");
+      retc = ERR;
+      break;
+    }
+    rec = rp;
+    for (; j < el.n; j++) {
+      if (eclcat_attr(el.ev[j].tret[0], ipl[i], ifl, attr, serr) == ERR) {
+        retc = ERR;
+        break;
+      }
+      rp = &rec[nrec++];
+      memset((void *) rp, 0, sizeof(struct eclcat_rec));
+      rp->tjd = el.ev[j].tret[0];
+      rp->mag = (float) attr[0];
+      rp->type = el.ev[j].retflag & ECLCAT_TYPES;
+      rp->ipl = ipl[i];
+      if (ipl[i] == SE_SUN || ipl[i] == SE_MOON) {
+        if (attr[9] > 0 && attr[9] < 32768 && attr[10] > 0 && attr[10] < 32768) {
+          rp->saros = (int16) attr[9];
+          rp->saros_member = (int16) attr[10];
+        }
+      }
+    }
+  }
+  if (el.ev != NULL)
+    free(el.ev);
+  if (retc == OK) {
+    if (nrec > 0)
+      qsort((void *) rec, (size_t) nrec, sizeof(struct eclcat_rec), eclcat_compare);
+    memset((void *) &h, 0, sizeof(h));
+    memcpy(h.magic, ECLCAT_MAGIC, 4);
+    h.version = ECLCAT_VERSION;
+    h.tjd_start = tjd_start;
+    h.tjd_end = tjd_end;
+    h.iflag = eclcat_ephe(ifl);
+    h.nipl = nipl;
+    h.nrec = nrec;
+    strcpy(fname, wdir);
+    if (fname[strlen(fname) - 1] != *DIR_GLUE)
+      strcat(fname, DIR_GLUE);
+    strcat(fname, SE_ECLCATFILE);
+    sprintf(ftmp, "%s.tmp", fname);
+    if ((fp = fopen(ftmp, BFILE_W_CREATE)) == NULL) {
+      if (serr != NULL)
+        sprintf(serr, "swe_ecl_catalog_make: could not create file %s", ftmp);
+      retc = ERR;
+    } else {
+      if (fwrite(&h, sizeof(h), 1, fp) != 1
+        || (nipl > 0 && fwrite(ipl, sizeof(int32), (size_t) nipl, fp) != (size_t) nipl)
+        || (nrec > 0 && fwrite(rec, sizeof(struct eclcat_rec), (size_t) nrec, fp) != (size_t) nrec))
+        retc = ERR;
+      if (fclose(fp) != 0)
+        retc = ERR;
+      if (retc == OK) {
+#if !HPUNIX
+        remove(fname);	/* rename() does not replace files on Windows */
+#endif
+        if (rename(ftmp, fname) != 0)
+          retc = ERR;
+      }
+      if (retc != OK) {
+        remove(ftmp);
+        if (serr != NULL)
+          sprintf(serr, "swe_ecl_catalog_make: could not write file %s", fname);
+      }
+    }
+  }
+  if (rec != NULL)
+    free(rec);
+  swi_fopen_cache_clear();	/* the file may have been cached as missing */
+  swi_close_ecl_catalog();
+  return retc;
+}
+
+/* 
+ * swe_ecl_when_range() cuts the range into blocks of time, which
+ * are searched independently by worker threads. 
+ */
+struct ecl_range {
+  double tjd_start, dt;
+  int32 ipl, ifl, ifltype;
+  struct ecl_event_list *blk;
+  int32 *retc;
+  char (*serr)[AS_MAXCH];
+};
+
+static void ecl_range_block(int32 i, void *arg)
+{
+  struct ecl_range *r = (struct ecl_range *) arg;
+  double t0 = r->tjd_start + i * r->dt;
+  r->retc[i] = eclcat_scan(t0, t0 + r->dt, r->ipl, r->ifl, r->ifltype, &r->blk[i], r->serr[i]);
+}
+
+/*
+ * All events of type ifltype of body ipl (SE_SUN: solar eclipses, 
+ * SE_MOON: lunar eclipses, other: occultations) with maximum between
+ * tjd_start and tjd_end (UT), searched with nthreads threads.
+ * For event i, the return flag of the search function is written to
+ * retflag[i], its times to tret[i * 10] .. tret[i * 10 + 9], in order 
+ * of time, for at most nmax events. Occultations of a body by the moon
+ * can follow each other after less than 25 days. Returns the number of 
+ * events found, which may be larger than nmax, or ERR.
+ */
+int32 CALL_CONV swe_ecl_when_range(double tjd_start, double tjd_end, int32 ipl, int32 ifl, 
+     int32 ifltype, int32 nthreads, int32 *retflag, double *tret, int32 nmax, char *serr)
+{
+  struct ecl_range r;
+  int32 nblk, i, j, n = 0, retc = OK;
+  ifl &= SEFLG_EPHMASK;
+  if (ipl == SE_AST_OFFSET + 134340)
+    ipl = SE_PLUTO;
+  if (tjd_end <= tjd_start)
+    return 0;
+  if (nthreads < 1)
+    nthreads = 1;
+  /* several blocks per thread, for balance, but not shorter than a year */
+  nblk = nthreads * 4;
+  if (nblk > (tjd_end - tjd_start) / 365.25)
+    nblk = (int32) ((tjd_end - tjd_start) / 365.25);
+  if (nblk < 1)
+    nblk = 1;
+  r.tjd_start = tjd_start;
+  r.dt = (tjd_end - tjd_start) / nblk;
+  r.ipl = ipl;
+  r.ifl = ifl;
+  r.ifltype = ifltype;
+  r.blk = (struct ecl_event_list *) calloc(nblk, sizeof(struct ecl_event_list));
+  r.retc = (int32 *) calloc(nblk, sizeof(int32));
+  r.serr = (char (*)[AS_MAXCH]) calloc(nblk, AS_MAXCH);
+  if (r.blk == NULL || r.retc == NULL || r.serr == NULL) {
+    if (serr != NULL)
+      strcpy(serr, "swe_ecl_when_range: out of memory");
+    retc = ERR;
+  } else {
+    swi_parallel_for(nthreads, nblk, ecl_range_block, &r);
+    for (i = 0; i < nblk && retc == OK; i++) {
+      if (r.retc[i] == ERR) {
+        if (serr != NULL)
+          strcpy(serr, r.serr[i]);
+        retc = ERR;
+        break;
+      }
+      /* blocks are in order of time */
+      for (j = 0; j < r.blk[i].n; j++, n++) {
+        if (n >= nmax)
+          continue;
+        retflag[n] = r.blk[i].ev[j].retflag;
+        memcpy(&tret[n * 10], r.blk[i].ev[j].tret, 10 * sizeof(double));
+      }
+    }
+  }
+  if (r.blk != NULL) {
+    for (i = 0; i < nblk; i++)
+      if (r.blk[i].ev != NULL)
+        free(r.blk[i].ev);
+    free(r.blk);
+  }
+  if (r.retc != NULL)
+    free(r.retc);
+  if (r.serr != NULL)
+    free(r.serr);
+  if (retc == ERR)
+    return ERR;
+  return n;
+}
+
+/*
+ * Next (or, if backward, previous) event of the kind selected by ipl
+ * and of type ifltype after (before) tjd_start, UT.
+ * Returns the eclipse type as the search functions do, 
+ * tret[0]	time of maximum eclipse
+ * attr[0]	magnitude, as of swe_sol_eclipse_where(), 
+ *		swe_lun_eclipse_how() or swe_lun_occult_where()
+ * attr[9]	saros series number (eclipses only, 0 if unknown)
+ * attr[10]	saros series member number
+ * If the event is taken from the catalog, tret[1..9] are 0 and
+ * attr[1..8] are not set. Outside the range of the catalog and for
+ * bodies or ephemerides that are not in it, the search functions are
+ * called and return all times.
+ * tret must hold 10 doubles, attr 20 doubles.
+ */
+int32 CALL_CONV swe_ecl_catalog_when(double tjd_start, int32 ipl, int32 ifl, int32 ifltype, 
+     double *tret, double *attr, int32 backward, char *serr)
+{
+  int32 lo, hi, mid, i, j, wanted, retflag;
+  struct eclcat_rec *rp;
+  if (ipl == SE_AST_OFFSET + 134340)
+    ipl = SE_PLUTO;
+  if (!eclcat.is_loaded)
+    eclcat_load();
+  for (i = 0; i < 10; i++)
+    tret[i] = 0;
+  wanted = eclcat_norm_type(ipl, ifltype);
+  if (!eclcat_has(ipl, ifl) || wanted == ERR || (backward & SE_ECL_ONE_TRY)
+    || tjd_start < eclcat.head.tjd_start || tjd_start > eclcat.head.tjd_end)
+    goto live_search;
+  /* first record after tjd_start */
+  lo = 0; hi = eclcat.head.nrec;
+  while (lo < hi) {
+    mid = (lo + hi) / 2;
+    if (eclcat.rec[mid].tjd <= tjd_start + 0.0001)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  if (backward) {
+    for (i = lo - 1; i >= 0 && eclcat.rec[i].tjd >= tjd_start - 0.0001; i--)
+      ;
+  } else {
+    i = lo;
+  }
+  for (; i >= 0 && i < eclcat.head.nrec; i += (backward ? -1 : 1)) {
+    rp = &eclcat.rec[i];
+    if (rp->ipl != ipl || (rp->type & ~wanted & ECLCAT_TYPES) != 0)
+      continue;
+    tret[0] = rp->tjd;
+    for (j = 0; j < 20; j++)
+      attr[j] = 0;
+    attr[0] = rp->mag;
+    attr[9] = rp->saros;
+    attr[10] = rp->saros_member;
+    return rp->type;
+  }
+  /* no such event until the end of the catalog */
+  tjd_start = backward ? eclcat.head.tjd_start : eclcat.head.tjd_end;
+live_search:
+  if ((retflag = eclcat_search(tjd_start, ipl, ifl, ifltype, tret, backward, serr)) <= 0)
+    return retflag;
+  if (eclcat_attr(tret[0], ipl, ifl, attr, serr) == ERR)
+    return ERR;
+  if (ipl != SE_SUN && ipl != SE_MOON)
+    attr[9] = attr[10] = 0;
+  else if (attr[9] < 0)
+    attr[9] = attr[10] = 0;
+  return retflag;
+}
+
+/*
+ * Local circumstances of a solar eclipse for many observers.
+ *
+ * The apparent geocentric positions of sun and moon and the sidereal
+ * time are computed once per time step; each observer only adds its
+ * own parallax. The observers are processed in blocks, with the steps
+ * in the outer loop and the observers of a block in the inner loop,
+ * which has no calls of library functions and can be vectorised.
+ * Contacts and maximum found between the steps are then refined with
+ * positions interpolated from the steps.
+ */
+#define ECL_LOC_BLOCK	256
+#define ECL_LOC_NRET	10
+
+struct ecl_loc_steps {
+  int32 n;
+  double tjd0, dt;	/* UT */
+  double *xs, *xm;	/* geocentric sun and moon, equatorial of date, AU */
+  double *sidt;		/* apparent sidereal time, radians */
+};
+
+/* geocentric position of observer: distance from axis and from equator (AU) */
+static void ecl_loc_observer(double *geopos, double *rho)
+{
+  double f = EARTH_OBLATENESS;
+  double cosfi = cos(geopos[1] * DEGTORAD), sinfi = sin(geopos[1] * DEGTORAD);
+  double cc = 1 / sqrt(cosfi * cosfi + (1-f) * (1-f) * sinfi * sinfi);
+  double ss = (1-f) * (1-f) * cc;
+  rho[0] = (EARTH_RADIUS * cc + geopos[2]) * cosfi / AUNIT;
+  rho[1] = (EARTH_RADIUS * ss + geopos[2]) * sinfi / AUNIT;
+}
+
+/* 
+ * separation of the centres minus the sum (fo) and minus the difference 
+ * (fi) of the radii of sun and moon, in radians, seen from xo, 
+ * and the radii rs and rm. For fi, the lunar radius is reduced as in
+ * eclipse_when_loc() for 2nd and 3rd contacts. The separation is approximated by a series 
+ * of the arc sine, which is exact where it matters, i.e. within a few
+ * degrees, and larger than 0.1 beyond.
+ */
+#define ECL_LOC_EVAL(xs, xm, xo0, xo1, xo2, fo, fi, sep, rs, rm) { \
+  double s0 = xs[0] - xo0, s1 = xs[1] - xo1, s2 = xs[2] - xo2; \
+  double m0 = xm[0] - xo0, m1 = xm[1] - xo1, m2 = xm[2] - xo2; \
+  double ds = sqrt(s0 * s0 + s1 * s1 + s2 * s2); \
+  double dm = sqrt(m0 * m0 + m1 * m1 + m2 * m2); \
+  double c0 = s1 * m2 - s2 * m1, c1 = s2 * m0 - s0 * m2, c2 = s0 * m1 - s1 * m0; \
+  double sn = sqrt(c0 * c0 + c1 * c1 + c2 * c2) / ds / dm; \
+  double xr; \
+  sep = sn * (1 + sn * sn * (1.0 / 6 + sn * sn * 3.0 / 40)); \
+  xr = RSUN / ds; rs = xr * (1 + xr * xr / 6); \
+  xr = RMOON / dm; rm = xr * (1 + xr * xr / 6); \
+  fo = sep - (rs + rm); \
+  fi = sep - fabs(rs - rm * 0.99916); \
+}
+
+/* sun, moon and sidereal time at step u (fractional), 
+ * by 3-point interpolation */
+static void ecl_loc_interp(const struct ecl_loc_steps *st, double u, double *xs, double *xm, double *sidt)
+{
+  int32 k = (int32) floor(u + 0.5), j;
+  double x, c0, c1, c2;
+  if (k < 1) k = 1;
+  if (k > st->n - 2) k = st->n - 2;
+  x = u - k;
+  c0 = x * (x - 1) / 2;
+  c1 = 1 - x * x;
+  c2 = x * (x + 1) / 2;
+  for (j = 0; j < 3; j++) {
+    xs[j] = c0 * st->xs[(k - 1) * 3 + j] + c1 * st->xs[k * 3 + j] + c2 * st->xs[(k + 1) * 3 + j];
+    xm[j] = c0 * st->xm[(k - 1) * 3 + j] + c1 * st->xm[k * 3 + j] + c2 * st->xm[(k + 1) * 3 + j];
+  }
+  *sidt = c0 * st->sidt[k - 1] + c1 * st->sidt[k] + c2 * st->sidt[k + 1];
+}
+
+/* fo or fi (which = 0 or 1) and details for observer at time step u */
+static double ecl_loc_at(const struct ecl_loc_steps *st, double u, double lon, double *rho,
+    int which, double *sep, double *rs, double *rm, double *alt)
+{
+  double xs[3], xm[3], sidt, xo[3], fo, fi, sep1, rs1, rm1, n, ds;
+  ecl_loc_interp(st, u, xs, xm, &sidt);
+  xo[0] = rho[0] * cos(sidt + lon);
+  xo[1] = rho[0] * sin(sidt + lon);
+  xo[2] = rho[1];
+  ECL_LOC_EVAL(xs, xm, xo[0], xo[1], xo[2], fo, fi, sep1, rs1, rm1);
+  if (sep != NULL) {
+    *sep = sep1; *rs = rs1; *rm = rm1;
+    /* true altitude of sun, from the direction of the ellipsoid normal */
+    n = rho[1] / (1 - EARTH_OBLATENESS) / (1 - EARTH_OBLATENESS);
+    n = sqrt(rho[0] * rho[0] + n * n);
+    ds = sqrt((xs[0] - xo[0]) * (xs[0] - xo[0]) + (xs[1] - xo[1]) * (xs[1] - xo[1]) + (xs[2] - xo[2]) * (xs[2] - xo[2]));
+    *alt = asin(((xs[0] - xo[0]) * xo[0] + (xs[1] - xo[1]) * xo[1] 
+      + (xs[2] - xo[2]) * xo[2] / (1 - EARTH_OBLATENESS) / (1 - EARTH_OBLATENESS)) / ds / n) * RADTODEG;
+  }
+  return which == 0 ? fo : fi;
+}
+
+/* time step, at which fo or fi is zero, between steps k and k + 1 */
+static double ecl_loc_contact(const struct ecl_loc_steps *st, int32 k, double f0, double f1,
+    double lon, double *rho, int which)
+{
+  double u0 = k, u1 = k + 1, u = k, f;
+  int i;
+  /* secant steps with interpolated positions, keeping the zero bracketed */
+  for (i = 0; i < 6 && f1 != f0; i++) {
+    u = u0 - f0 * (u1 - u0) / (f1 - f0);
+    f = ecl_loc_at(st, u, lon, rho, which, NULL, NULL, NULL, NULL);
+    if (fabs(f) < 1e-12)
+      break;
+    if ((f < 0) == (f0 < 0)) {
+      u0 = u; f0 = f;
+    } else {
+      u1 = u; f1 = f;
+    }
+  }
+  return u;
+}
+
+/*
+ * Local circumstances of the solar eclipse between tjd_start and 
+ * tjd_end (UT; e.g. begin and end of the eclipse, tret[2] and tret[3]
+ * of swe_sol_eclipse_when_glob()) for n observers.
+ * geopos[i * 3 .. i * 3 + 2] geographic longitude, latitude and height
+ *		above sea of observer i
+ * dt		time step in days; contacts shorter than dt may be missed. 
+ *		If dt <= 0, 1 minute.
+ * dret[i * 10 + 0]	time of maximum eclipse, 0 if there is no eclipse
+ *	      + 1	time of first contact, 0 if not within tjd_start .. tjd_end
+ *	      + 2	time of second contact, 0 if none
+ *	      + 3	time of third contact, 0 if none
+ *	      + 4	time of fourth contact, 0 if not within tjd_start .. tjd_end
+ *	      + 5	magnitude at maximum (fraction of solar diameter covered)
+ *	      + 6	obscuration at maximum (fraction of solar disc covered)
+ *	      + 7	ratio of lunar diameter to solar one
+ *	      + 8	true altitude of sun at maximum (without refraction)
+ *	      + 9	eclipse type SE_ECL_TOTAL, SE_ECL_ANNULAR, SE_ECL_PARTIAL, or 0
+ * The horizon is not considered: the circumstances are those of an
+ * observer who could see the sun below the horizon. 
+ * Returns OK or ERR.
+ */
+int32 CALL_CONV swe_sol_eclipse_loc_arr(double tjd_start, double tjd_end, double dt, int32 ifl,
+    double *geopos, int32 n, double *dret, char *serr)
+{
+  struct ecl_loc_steps st;
+  int32 k, i, i0, nb, kmin, iflag, retc = OK;
+  double te, x[6], *fo = NULL, *fi = NULL, *rho = NULL, *clon = NULL, *slon = NULL, *cs = NULL, *ss = NULL;
+  double u, fmin, fmin1, sep, rs, rm, alt, *dr;
+  ifl &= SEFLG_EPHMASK;
+  iflag = SEFLG_EQUATORIAL | SEFLG_XYZ | ifl;
+  if (dt <= 0)
+    dt = 1.0 / 1440;
+  memset((void *) &st, 0, sizeof(st));
+  st.tjd0 = tjd_start;
+  st.dt = dt;
+  st.n = (int32) ceil((tjd_end - tjd_start) / dt) + 1;
+  if (st.n < 3)
+    st.n = 3;
+  st.xs = (double *) malloc(st.n * 3 * sizeof(double));
+  st.xm = (double *) malloc(st.n * 3 * sizeof(double));
+  st.sidt = (double *) malloc(st.n * sizeof(double));
+  fo = (double *) malloc(st.n * ECL_LOC_BLOCK * sizeof(double));
+  fi = (double *) malloc(st.n * ECL_LOC_BLOCK * sizeof(double));
+  rho = (double *) malloc(ECL_LOC_BLOCK * 2 * sizeof(double));
+  clon = (double *) malloc(ECL_LOC_BLOCK * 4 * sizeof(double));
+  if (st.xs == NULL || st.xm == NULL || st.sidt == NULL || fo == NULL || fi == NULL 
+    || rho == NULL || clon == NULL) {
+    if (serr != NULL)
+      strcpy(serr, "swe_sol_eclipse_loc_arr: out of memory");
+    retc = ERR;
+    goto end_loc_arr;
+  }
+  slon = clon + ECL_LOC_BLOCK;
+  cs = clon + 2 * ECL_LOC_BLOCK;
+  ss = clon + 3 * ECL_LOC_BLOCK;
+  /* geometry of sun and moon, once per time step */
+  for (k = 0; k < st.n; k++) {
+    double t = tjd_start + k * dt;
+    te = t + swe_deltat_ex(t, ifl, serr);
+    if (swe_calc(te, SE_SUN, iflag, x, serr) == ERR) {
+      retc = ERR;
+      goto end_loc_arr;
+    }
+    memcpy(&st.xs[k * 3], x, 3 * sizeof(double));
+    if (swe_calc(te, SE_MOON, iflag, x, serr) == ERR) {
+      retc = ERR;
+      goto end_loc_arr;
+    }
+    memcpy(&st.xm[k * 3], x, 3 * sizeof(double));
+    st.sidt[k] = swe_sidtime(t) * 15 * DEGTORAD;
+    /* keep the sidereal time continuous for interpolation */
+    if (k > 0)
+      while (st.sidt[k] < st.sidt[k - 1])
+        st.sidt[k] += TWOPI;
+  }
+  for (i0 = 0; i0 < n; i0 += ECL_LOC_BLOCK) {
+    nb = (n - i0 < ECL_LOC_BLOCK) ? n - i0 : ECL_LOC_BLOCK;
+    for (i = 0; i < nb; i++) {
+      ecl_loc_observer(&geopos[(i0 + i) * 3], &rho[i * 2]);
+      clon[i] = cos(geopos[(i0 + i) * 3] * DEGTORAD);
+      slon[i] = sin(geopos[(i0 + i) * 3] * DEGTORAD);
+    }
+    for (k = 0; k < st.n; k++) {
+      double cg = cos(st.sidt[k]), sg = sin(st.sidt[k]);
+      double *xs = &st.xs[k * 3], *xm = &st.xm[k * 3];
+      double *fok = &fo[k * ECL_LOC_BLOCK], *fik = &fi[k * ECL_LOC_BLOCK];
+      for (i = 0; i < nb; i++) {
+        cs[i] = rho[i * 2] * (cg * clon[i] - sg * slon[i]);
+        ss[i] = rho[i * 2] * (sg * clon[i] + cg * slon[i]);
+      }
+      for (i = 0; i < nb; i++) {
+        double fo1, fi1, sep1, rs1, rm1;
+        ECL_LOC_EVAL(xs, xm, cs[i], ss[i], rho[i * 2 + 1], fo1, fi1, sep1, rs1, rm1);
+        fok[i] = fo1;
+        fik[i] = fi1;
+      }
+    }
+    /* per observer: maximum and contacts */
+    for (i = 0; i < nb; i++) {
+      double lon = geopos[(i0 + i) * 3] * DEGTORAD;
+      dr = &dret[(i0 + i) * ECL_LOC_NRET];
+      memset((void *) dr, 0, ECL_LOC_NRET * sizeof(double));
+      kmin = 0;
+      for (k = 1; k < st.n; k++)
+        if (fo[k * ECL_LOC_BLOCK + i] < fo[kmin * ECL_LOC_BLOCK + i])
+          kmin = k;
+      u = kmin;
+      if (kmin > 0 && kmin < st.n - 1) {
+        find_maximum(fo[(kmin - 1) * ECL_LOC_BLOCK + i], fo[kmin * ECL_LOC_BLOCK + i], 
+          fo[(kmin + 1) * ECL_LOC_BLOCK + i], 1, &u, &fmin);
+        u += kmin + 1;
+        /* refine with interpolated positions */
+        fmin = ecl_loc_at(&st, u - 0.1, lon, &rho[i * 2], 0, NULL, NULL, NULL, NULL);
+        fmin1 = ecl_loc_at(&st, u + 0.1, lon, &rho[i * 2], 0, NULL, NULL, NULL, NULL);
+        find_maximum(fmin, ecl_loc_at(&st, u, lon, &rho[i * 2], 0, NULL, NULL, NULL, NULL), fmin1, 0.1, &x[0], NULL);
+        x[0] += 0.1;
+        if (fabs(x[0]) < 0.1)
+          u += x[0];
+      }
+      if (ecl_loc_at(&st, u, lon, &rho[i * 2], 0, &sep, &rs, &rm, &alt) >= 0)
+        continue;	/* no eclipse */
+      dr[0] = tjd_start + u * dt;
+      if (sep < rs - rm)
+        dr[9] = SE_ECL_ANNULAR;
+      else if (sep < rm - rs)
+        dr[9] = SE_ECL_TOTAL;
+      else 
+        dr[9] = SE_ECL_PARTIAL;
+      dr[5] = (rs + rm - sep) / rs / 2;
+      dr[6] = ecl_obscuration(rs, rm, sep, (int32) dr[9]);
+      dr[7] = rm / rs;
+      dr[8] = alt;
+      /* contacts */
+      for (k = 0; k < st.n - 1; k++) {
+        double *f = fo;
+        int which;
+        for (which = 0; which <= 1; which++, f = fi) {
+          double f0 = f[k * ECL_LOC_BLOCK + i], f1 = f[(k + 1) * ECL_LOC_BLOCK + i];
+          if ((f0 < 0) == (f1 < 0))
+            continue;
+          u = ecl_loc_contact(&st, k, f0, f1, lon, &rho[i * 2], which);
+          if (f0 >= 0)
+            dr[which == 0 ? 1 : 2] = tjd_start + u * dt;
+          else
+            dr[which == 0 ? 4 : 3] = tjd_start + u * dt;
+        }
+      }
+    }
+  }
+end_loc_arr:
+  if (st.xs != NULL) free(st.xs);
+  if (st.xm != NULL) free(st.xm);
+  if (st.sidt != NULL) free(st.sidt);
+  if (fo != NULL) free(fo);
+  if (fi != NULL) free(fi);
+  if (rho != NULL) free(rho);
+  if (clon != NULL) free(clon);
+  return retc;
+}
@@ -83,8 +83,15 @@
 
 # include "swephexp.h"
 # include "sweph.h"
+#ifdef SE_BUILTIN_TABLES
+# include "seleapsec.h"
+#endif
 
 static TLS AS_BOOL init_leapseconds_done = FALSE;
+static TLS int leapsec_tabsiz = 0;
+
+static int32 utc_to_jd(int32 iyear, int32 imonth, int32 iday, int32 ihour, int32 imin, double dsec, int32 gregflag, double *dret, int tabsiz_nleap, char *serr);
+static void jdet_to_utc(double tjd_et, int32 gregflag, int32 *iyear, int32 *imonth, int32 *iday, int32 *ihour, int32 *imin, double *dsec, int tabsiz_nleap);
 
 
 int CALL_CONV swe_date_conversion(int y,
@@ -307,6 +314,7 @@ static TLS int leap_seconds[NLEAP_SECONDS_SPACE] = {
 #define NLEAP_INIT 10
 
 /* Read additional leap second dates from external file, if given.
+ * The table size is computed only once and then kept in leapsec_tabsiz.
  */
 static int init_leapsec(void)
 {
@@ -316,13 +324,28 @@ static int init_leapsec(void)
   int i;
   char s[AS_MAXCH];
   char *sp;
+  if (init_leapseconds_done && leapsec_tabsiz > 0)
+    return leapsec_tabsiz;
   if (!init_leapseconds_done) {
     init_leapseconds_done = TRUE;
     tabsiz = NLEAP_SECONDS;
     ndat_last = leap_seconds[NLEAP_SECONDS - 1];
+#ifdef SE_BUILTIN_TABLES
+    /* leap seconds compiled in from seleapsec.txt by gen_tables.rb */
+    for (i = 0; i < SWI_BUILTIN_NLEAPSEC && tabsiz < NLEAP_SECONDS_SPACE - 1; i++) {
+      if (swi_builtin_leapsec[i] > ndat_last) 
+        leap_seconds[tabsiz++] = ndat_last = swi_builtin_leapsec[i];
+    }
+#endif
+    leap_seconds[tabsiz] = 0; /* end mark */
+#ifdef SE_BUILTIN_TABLES
+    /* the file is only read if swe_set_read_table_files(TRUE) was called */
+    if (!swed.read_table_files)
+      return (leapsec_tabsiz = tabsiz);
+#endif
     /* no error message if file is missing */
     if ((fp = swi_fopen(-1, "seleapsec.txt", swed.ephepath, NULL)) == NULL)
-      return NLEAP_SECONDS; 
+      return (leapsec_tabsiz = tabsiz); 
     while(fgets(s, AS_MAXCH, fp) != NULL) {
       sp = s;
       while (*sp == ' ' || *sp == '\t') sp++;
@@ -333,14 +356,17 @@ static int init_leapsec(void)
       if (ndat <= ndat_last)
         continue;
       /* table space is limited. no error msg, if exceeded */
-      if (tabsiz >= NLEAP_SECONDS_SPACE)
-        return tabsiz;
+      if (tabsiz >= NLEAP_SECONDS_SPACE) {
+        fclose(fp);
+        return (leapsec_tabsiz = tabsiz);
+      }
       leap_seconds[tabsiz] = ndat;
       tabsiz++;
     }
-    if (tabsiz > NLEAP_SECONDS) leap_seconds[tabsiz] = 0; /* end mark */
+    if (tabsiz > NLEAP_SECONDS && tabsiz < NLEAP_SECONDS_SPACE) 
+      leap_seconds[tabsiz] = 0; /* end mark */
     fclose(fp);
-    return tabsiz;
+    return (leapsec_tabsiz = tabsiz);
   }
   /* find table size */
   tabsiz = 0;
@@ -350,7 +376,39 @@ static int init_leapsec(void)
     else
       tabsiz++;
   }
-  return tabsiz;
+  return (leapsec_tabsiz = tabsiz);
+}
+
+/* With built-in tables (SE_BUILTIN_TABLES, defined by extconf.rb, see 
+ * gen_tables.rb), the files seleapsec.txt and swe_deltat.txt/sedeltat.txt
+ * are not read by default, so the first leap second or Delta T lookup 
+ * of a thread does no file I/O.
+ * swe_set_read_table_files(TRUE) makes the next lookup read them from the
+ * ephemeris path, and entries from the files override or extend the 
+ * built-in ones. FALSE restores the built-in tables.
+ * Without built-in tables, the files are always read.
+ */
+void CALL_CONV swe_set_read_table_files(AS_BOOL do_read)
+{
+  swed.read_table_files = do_read;
+  init_leapseconds_done = FALSE;
+  leapsec_tabsiz = 0;
+  swed.init_dt_done = FALSE;
+}
+
+/* Number of leap seconds inserted before date ndat (yyyymmdd), 
+ * i.e. index of the first table entry >= ndat. Binary search. */
+static int count_leapsec(int ndat, int tabsiz)
+{
+  int lo = 0, hi = tabsiz, mid;
+  while (lo < hi) {
+    mid = (lo + hi) >> 1;
+    if (leap_seconds[mid] < ndat)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
 }
 
 /*
@@ -373,10 +431,15 @@ static int init_leapsec(void)
  *   for a long time.
 */
 int32 CALL_CONV swe_utc_to_jd(int32 iyear, int32 imonth, int32 iday, int32 ihour, int32 imin, double dsec, int32 gregflag, double *dret, char *serr)
+{
+  return utc_to_jd(iyear, imonth, iday, ihour, imin, dsec, gregflag, dret, init_leapsec(), serr);
+}
+
+static int32 utc_to_jd(int32 iyear, int32 imonth, int32 iday, int32 ihour, int32 imin, double dsec, int32 gregflag, double *dret, int tabsiz_nleap, char *serr)
 {
   double tjd_ut1, tjd_et, tjd_et_1972, dhour, d;
   int iyear2, imonth2, iday2;
-  int i, j, ndat, nleap, tabsiz_nleap;
+  int i, ndat, nleap;
   /* 
    * error handling: invalid iyear etc. 
    */
@@ -414,14 +477,10 @@ int32 CALL_CONV swe_utc_to_jd(int32 iyear, int32 imonth, int32 iday, int32 ihour
   /* 
    * number of leap seconds since 1972: 
    */
-  tabsiz_nleap = init_leapsec();
-  nleap = NLEAP_INIT; /* initial difference between UTC and TAI in 1972 */
   ndat = iyear * 10000 + imonth * 100 + iday;
-  for (i = 0; i < tabsiz_nleap; i++) {
-    if (ndat <= leap_seconds[i])
-      break;
-    nleap++;
-  }
+  i = count_leapsec(ndat, tabsiz_nleap);
+  /* initial difference between UTC and TAI in 1972 */
+  nleap = NLEAP_INIT + i; 
   /*
    * For input dates > today:
    * If leap seconds table is not up to date, we'd better interpret the
@@ -438,14 +497,7 @@ int32 CALL_CONV swe_utc_to_jd(int32 iyear, int32 imonth, int32 iday, int32 ihour
    * if input second is 60: is it a valid leap second ? 
    */
   if (dsec >= 60) {
-    j = 0;
-    for (i = 0; i < tabsiz_nleap; i++) {
-      if (ndat == leap_seconds[i]) {
-	j = 1;
-	break;
-      }
-    }
-    if (j != 1) {
+    if (i >= tabsiz_nleap || ndat != leap_seconds[i]) {
       if (serr != NULL)
 	sprintf(serr, "invalid time (no leap second!): %d:%d:%.2f", ihour, imin, dsec);
       return ERR;
@@ -484,10 +536,15 @@ int32 CALL_CONV swe_utc_to_jd(int32 iyear, int32 imonth, int32 iday, int32 ihour
  *   updated for a long time.
  */
 void CALL_CONV swe_jdet_to_utc(double tjd_et, int32 gregflag, int32 *iyear, int32 *imonth, int32 *iday, int32 *ihour, int32 *imin, double *dsec) 
+{
+  jdet_to_utc(tjd_et, gregflag, iyear, imonth, iday, ihour, imin, dsec, init_leapsec());
+}
+
+static void jdet_to_utc(double tjd_et, int32 gregflag, int32 *iyear, int32 *imonth, int32 *iday, int32 *ihour, int32 *imin, double *dsec, int tabsiz_nleap) 
 {
   int i;
   int second_60 = 0;
-  int iyear2, imonth2, iday2, nleap, ndat, tabsiz_nleap;
+  int iyear2, imonth2, iday2, nleap, ndat;
   double d, tjd, tjd_et_1972, tjd_ut, dret[10];
   /* 
    * if tjd_et is before 1 jan 1972 UTC, return UT1
@@ -509,15 +566,9 @@ void CALL_CONV swe_jdet_to_utc(double tjd_et, int32 gregflag, int32 *iyear, int3
    * minimum number of leap seconds since 1972; we may be missing one leap
    * second
    */
-  tabsiz_nleap = init_leapsec();
   swe_revjul(tjd_ut-1, SE_GREG_CAL, &iyear2, &imonth2, &iday2, &d);
   ndat = iyear2 * 10000 + imonth2 * 100 + iday2;
-  nleap = 0; 
-  for (i = 0; i < tabsiz_nleap; i++) {
-    if (ndat <= leap_seconds[i])
-      break;
-    nleap++;
-  }
+  nleap = count_leapsec(ndat, tabsiz_nleap);
   /* date of potentially missing leapsecond */
   if (nleap < tabsiz_nleap) {
     i = leap_seconds[nleap];
@@ -526,7 +577,7 @@ void CALL_CONV swe_jdet_to_utc(double tjd_et, int32 gregflag, int32 *iyear, int3
     iday2 = i % 100;
     tjd = swe_julday(iyear2, imonth2, iday2, 0, SE_GREG_CAL);
     swe_revjul(tjd+1, SE_GREG_CAL, &iyear2, &imonth2, &iday2, &d);
-    swe_utc_to_jd(iyear2,imonth2,iday2, 0, 0, 0, SE_GREG_CAL, dret, NULL);
+    utc_to_jd(iyear2,imonth2,iday2, 0, 0, 0, SE_GREG_CAL, dret, tabsiz_nleap, NULL);
     d = tjd_et - dret[0];
     if (d >= 0) {
       nleap++;
@@ -586,3 +637,92 @@ void CALL_CONV swe_jdut1_to_utc(double tjd_ut, int32 gregflag, int32 *iyear, int
   swe_jdet_to_utc(tjd_et, gregflag, iyear, imonth, iday, ihour, imin, dsec);
 }
 
+
+/*
+ * Array versions of swe_julday(), swe_revjul(), swe_utc_to_jd() and
+ * swe_jdet_to_utc(), for the conversion of many dates in one call.
+ * Dates are passed as records of doubles: 
+ *   date[4 * i + 0 .. 3]  year, month, day, hour (decimal)
+ *   utc[6 * i + 0 .. 5]   year, month, day, hour, minute, second (decimal)
+ * The results are identical to those of the single date functions.
+ */
+
+/* tjd[i] = Julian day number of date record i */
+void CALL_CONV swe_julday_arr(double *date, int32 n, int gregflag, double *tjd)
+{
+  int32 i;
+  double u, u0, u1, u2, *dp;
+  for (i = 0, dp = date; i < n; i++, dp += 4) {
+    u = dp[0] - (dp[1] < 3);
+    u0 = u + 4712.0;
+    u1 = dp[1] + 1.0 + (dp[1] < 3) * 12.0;
+    tjd[i] = floor(u0*365.25)
+       + floor(30.6*u1+0.000001)
+       + dp[2] + dp[3]/24.0 - 63.5;
+  }
+  if (gregflag != SE_GREG_CAL)
+    return;
+  for (i = 0, dp = date; i < n; i++, dp += 4) {
+    u = dp[0] - (dp[1] < 3);
+    u2 = floor(fabs(u) / 100) - floor(fabs(u) / 400);
+    if (u < 0.0) u2 = -u2;
+    tjd[i] = tjd[i] - u2 + 2;            
+    if ((u < 0.0) && (u/100 == floor(u/100)) && (u/400 != floor(u/400)))
+      tjd[i] -= 1;
+  }
+}
+
+/* date record i = calendar date of tjd[i] */
+void CALL_CONV swe_revjul_arr(double *tjd, int32 n, int gregflag, double *date)
+{
+  int32 i;
+  int jyear, jmon, jday;
+  double *dp;
+  for (i = 0, dp = date; i < n; i++, dp += 4) {
+    swe_revjul(tjd[i], gregflag, &jyear, &jmon, &jday, &dp[3]);
+    dp[0] = (double) jyear;
+    dp[1] = (double) jmon;
+    dp[2] = (double) jday;
+  }
+}
+
+/* dret[2 * i + 0] = Julian day number TT (ET) of utc record i
+ * dret[2 * i + 1] = Julian day number UT1 
+ * For invalid dates, both are set to 0. 
+ * Returns the number of invalid dates; serr contains the error message
+ * of the first one. */
+int32 CALL_CONV swe_utc_to_jd_arr(double *utc, int32 n, int32 gregflag, double *dret, char *serr)
+{
+  int32 i, nerr = 0;
+  int tabsiz_nleap = init_leapsec();
+  double *up;
+  char *sp = serr;
+  if (serr != NULL)
+    *serr = '\0';
+  for (i = 0, up = utc; i < n; i++, up += 6) {
+    if (utc_to_jd((int32) up[0], (int32) up[1], (int32) up[2], (int32) up[3], (int32) up[4], up[5], gregflag, &dret[2 * i], tabsiz_nleap, sp) == ERR) {
+      dret[2 * i] = dret[2 * i + 1] = 0;
+      /* keep the first error message */
+      nerr++;
+      sp = NULL;
+    }
+  }
+  return nerr;
+}
+
+/* utc record i = UTC of tjd_et[i] */
+void CALL_CONV swe_jdet_to_utc_arr(double *tjd_et, int32 n, int32 gregflag, double *utc)
+{
+  int32 i;
+  int32 iyear, imonth, iday, ihour, imin;
+  int tabsiz_nleap = init_leapsec();
+  double *up;
+  for (i = 0, up = utc; i < n; i++, up += 6) {
+    jdet_to_utc(tjd_et[i], gregflag, &iyear, &imonth, &iday, &ihour, &imin, &up[5], tabsiz_nleap);
+    up[0] = (double) iyear;
+    up[1] = (double) imonth;
+    up[2] = (double) iday;
+    up[3] = (double) ihour;
+    up[4] = (double) imin;
+  }
+}
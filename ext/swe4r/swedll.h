@@ -92,6 +92,8 @@ extern "C" {
 DllImport int32 CALL_CONV_IMP swe_heliacal_ut(double JDNDaysUTStart, double *geopos, double *datm, double *dobs, char *ObjectName, int32 TypeEvent, int32 iflag, double *dret, char *serr);
 DllImport int32 CALL_CONV_IMP swe_heliacal_pheno_ut(double JDNDaysUT, double *geopos, double *datm, double *dobs, char *ObjectName, int32 TypeEvent, int32 helflag, double *darr, char *serr);
 DllImport int32 CALL_CONV_IMP swe_vis_limit_mag(double tjdut, double *geopos, double *datm, double *dobs, char *ObjectName, int32 helflag, double *dret, char *serr);
+DllImport int32 CALL_CONV_IMP swe_heliacal_stats(double *dstat, int32 nstat);
+DllImport int32 CALL_CONV_IMP swe_heliacal_range(double tjd_start, double tjd_end, double *geopos, double *datm, double *dobs, char *ObjectNames, int32 nobj, int32 *TypeEvents, int32 ntypes, int32 helflag, double *dret, int32 nret, char *serr);
 /* the following are secret, for Victor Reijs' */
 DllImport int32 CALL_CONV_IMP swe_heliacal_angle(double tjdut, double *dgeo, double *datm, double *dobs, int32 helflag, double mag, double azi_obj, double azi_sun, double azi_moon, double alt_moon, double *dret, char *serr);
 DllImport int32 CALL_CONV_IMP swe_topo_arcus_visionis(double tjdut, double *dgeo, double *datm, double *dobs, int32 helflag, double mag, double azi_obj, double alt_obj, double azi_sun, double azi_moon, double alt_moon, double *dret, char *serr);
@@ -192,6 +194,9 @@ DllImport const char * CALL_CONV_IMP swe_house_name(int hsys);
 DllImport int32  CALL_CONV_IMP swe_gauquelin_sector(
 	double t_ut, int32 ipl, char *starname, int32 iflag, int32 imeth, double *geopos, double atpress, double attemp, double *dgsect, char *serr);
 
+DllImport int32  CALL_CONV_IMP swe_gauquelin_sector_arr(
+	double *tjd_ut, double *geopos, int32 nrec, int32 *ipl, int32 nipl, int32 iflag, int32 imeth, double atpress, double attemp, int32 nthreads, double *dgsect, char *serr);
+
 DllImport void  CALL_CONV_IMP swe_set_sid_mode(
         int32 sid_mode, double t0, double ayan_t0);
 
@@ -220,6 +225,12 @@ DllImport void  CALL_CONV_IMP swe_revjul(
         int *year, int *mon, int *mday,
         double *hour);
 
+DllImport void CALL_CONV_IMP swe_julday_arr(double *date, int32 n, int gregflag, double *tjd);
+DllImport void CALL_CONV_IMP swe_revjul_arr(double *tjd, int32 n, int gregflag, double *date);
+DllImport int32 CALL_CONV_IMP swe_utc_to_jd_arr(double *utc, int32 n, int32 gregflag, double *dret, char *serr);
+DllImport void CALL_CONV_IMP swe_jdet_to_utc_arr(double *tjd_et, int32 n, int32 gregflag, double *utc);
+DllImport void CALL_CONV_IMP swe_set_read_table_files(AS_BOOL do_read);
+
 DllImport void  CALL_CONV_IMP swe_utc_time_zone(
         int32 iyear, int32 imonth, int32 iday,
 	int32 ihour, int32 imin, double dsec,
@@ -250,10 +261,16 @@ DllImport int  CALL_CONV_IMP swe_lat_to_lmt(double tjd_lat, double geolon, doubl
 DllImport double  CALL_CONV_IMP swe_get_tid_acc(void);
 DllImport void  CALL_CONV_IMP swe_set_tid_acc(double tidacc);
 DllImport void  CALL_CONV_IMP swe_set_delta_t_userdef(double dt);
+DllImport void CALL_CONV_IMP swe_set_interpolate_deltat(AS_BOOL do_interpolate);
+DllImport void CALL_CONV_IMP swe_set_interpolate_ecl(AS_BOOL do_interpolate);
 DllImport void  CALL_CONV_IMP swe_set_ephe_path(const char *path);
+DllImport int32 CALL_CONV_IMP swe_get_cache_stats(int64 *stats, int32 nstats);
+DllImport void CALL_CONV_IMP swe_reset_cache_stats(void);
+DllImport void CALL_CONV_IMP swe_set_calc_cache(int32 nentries);
 DllImport void  CALL_CONV_IMP swe_set_jpl_file(const char *fname);
 DllImport void  CALL_CONV_IMP swe_close(void);
 DllImport char * CALL_CONV_IMP swe_get_planet_name(int ipl, char *spname);
+DllImport void CALL_CONV_IMP swe_get_planet_name_arr(int *ipl, int32 n, char *spname);
 DllImport void  CALL_CONV_IMP swe_cotrans(double *xpo, double *xpn, double eps);
 DllImport void  CALL_CONV_IMP swe_cotrans_sp(double *xpo, double *xpn, double eps);
 
@@ -295,11 +312,19 @@ DllImport int32  CALL_CONV_IMP swe_lun_eclipse_how(
           char *serr);
 DllImport int32  CALL_CONV_IMP swe_lun_eclipse_when(double tjd_start, int32 ifl, int32 ifltype, double *tret, int32 backward, char *serr);
 DllImport int32  CALL_CONV_IMP swe_lun_eclipse_when_loc(double tjd_start, int32 ifl, double *geopos, double *tret, double *attr, int32 backward, char *serr);
+DllImport int32  CALL_CONV_IMP swe_ecl_catalog_make(double tjd_start, double tjd_end, int32 *ipl, int32 nipl, int32 ifl, char *dir, char *serr);
+DllImport int32  CALL_CONV_IMP swe_ecl_catalog_when(double tjd_start, int32 ipl, int32 ifl, int32 ifltype, double *tret, double *attr, int32 backward, char *serr);
+DllImport int32  CALL_CONV_IMP swe_ecl_when_range(double tjd_start, double tjd_end, int32 ipl, int32 ifl, int32 ifltype, int32 nthreads, int32 *retflag, double *tret, int32 nmax, char *serr);
+DllImport int32  CALL_CONV_IMP swe_sol_eclipse_loc_arr(double tjd_start, double tjd_end, double dt, int32 ifl, double *geopos, int32 n, double *dret, char *serr);
 /* planetary phenomena */
 DllImport int32  CALL_CONV_IMP swe_pheno(double tjd, int32 ipl, int32 iflag, double *attr, char *serr);
 
 DllImport int32  CALL_CONV_IMP swe_pheno_ut(double tjd_ut, int32 ipl, int32 iflag, double *attr, char *serr);
 
+DllImport int32  CALL_CONV_IMP swe_pheno_arr(double tjd, int32 *ipl, int32 nipl, int32 iflag, double *attr, char *serr);
+
+DllImport int32  CALL_CONV_IMP swe_pheno_ut_arr(double tjd_ut, int32 *ipl, int32 nipl, int32 iflag, double *attr, char *serr);
+
 DllImport double  CALL_CONV_IMP swe_refrac(double inalt, double atpress, double attemp, int32 calc_flag);
 DllImport double  CALL_CONV_IMP swe_refrac_extended(double inalt, double geoalt, double atpress, double attemp, double lapse_rate, int32 calc_flag, double *dret);
 DllImport void  CALL_CONV_IMP swe_set_lapse_rate(double lapse_rate);
@@ -320,6 +345,26 @@ DllImport void  CALL_CONV_IMP swe_azalt_rev(
       double *xin, 
       double *xout); 
 
+DllImport void  CALL_CONV_IMP swe_azalt_arr(
+      double tjd_ut,
+      int32 calc_flag,
+      double *geopos,
+      double atpress,
+      double attemp,
+      double *xin, 
+      int32 n,
+      double *xaz); 
+
+DllImport void  CALL_CONV_IMP swe_azalt_times(
+      double *tjd_ut,
+      int32 n,
+      int32 calc_flag,
+      double *geopos,
+      double atpress,
+      double attemp,
+      double *xin, 
+      double *xaz); 
+
 DllImport int32  CALL_CONV_IMP swe_rise_trans(
                double tjd_ut, int32 ipl, char *starname, 
 	       int32 epheflag, int32 rsmi,
@@ -349,10 +394,20 @@ DllImport int32  CALL_CONV_IMP swe_nod_aps_ut(double tjd_ut, int32 ipl, int32 if
                       double *xperi, double *xaphe, 
                       char *serr);
 
+DllImport int32  CALL_CONV_IMP swe_nod_aps_arr(double tjd_et, int32 *ipl, int32 nipl, 
+                      int32 iflag, int32 method, double *xret, char *serr);
+
+DllImport int32  CALL_CONV_IMP swe_nod_aps_times(double *tjd_et, int32 n, int32 ipl, 
+                      int32 iflag, int32 method, double *xret, char *serr);
+
 DllImport int32 CALL_CONV_IMP swe_get_orbital_elements(double tjd_et, int32 ipl, int32 iflag, double *dret, char *serr);
 
 DllImport int32 CALL_CONV_IMP swe_orbit_max_min_true_distance(double tjd_et, int32 ipl, int32 iflag, double *dmax, double *dmin, double *dtrue, char *serr);
 
+DllImport int32 CALL_CONV_IMP swe_get_orbital_elements_arr(double tjd_et, int32 *ipl, int32 nipl, int32 iflag, double *dret, char *serr);
+
+DllImport int32 CALL_CONV_IMP swe_orbit_max_min_true_distance_arr(double tjd_et, int32 *ipl, int32 nipl, int32 iflag, double *dret, char *serr);
+
 /******************************************************* 
  * other functions from swephlib.c;
  * they are not needed for Swiss Ephemeris,
@@ -59,17 +59,38 @@ a fast precomputed ephemeris
 
 
 # include "swephexp.h"
+# include "sweph.h"
+# include "swephlib.h"
 # include "sweephe4.h"
 # include <string.h>
+# if HPUNIX
+#  include <sys/mman.h>
+# endif
 
 # define INVALID_BASE	2000000000L
 # define EPBS	(2 * NDB)	/* buffer size is 20 days */
 # define EP_MIN_IX	2	/* load buffer when index below this */
 # define EP_MAX_IX	(EPBS - 4)	/* load buffer when index above this */
 
-FILE *ephfp = NULL;
+# define EP4_NOFILE	-10000
+
 const int qod[EP_NP] = {5,5,5,5,5,3,3,3,3,3,3,5,3,3,3};
 
+/*
+ * All state of this module is thread local, like swed in sweph.c, so that
+ * ephread() and dephread2() can be called from several threads at the
+ * same time. Each thread maps at most one ep4 file into memory.
+ */
+struct ep4_map {
+  int filenr;			/* file number, EP4_NOFILE if none */
+  UCHAR *base;			/* file contents, NULL if file is missing */
+  size_t size;			/* file size in bytes */
+  char ephepath[AS_MAXCH];	/* ephemeris path the file was searched in */
+};
+static TLS struct ep4_map ep4map = {EP4_NOFILE, NULL, 0, ""};
+static TLS int jdbase_l = INVALID_BASE;	/* buffer base of ephread() */
+static TLS int jdbase_d = INVALID_BASE;	/* buffer base of dephread2() */
+
 static void inpolq_l(int n, int o, double p, centisec *x,
 		      centisec *axu, centisec *adxu);
 static int inpolq(int n, int o, double p, double *x,
@@ -78,7 +99,9 @@ static int ephe4_unpack(int jdl, int pflag, centisec lon[][EPBS], int i0,
 			 char *errs);
 static int ephe4_unpack_d(int jdl, int pflag, double lon[][EPBS], int i0,
 			 char *errs);
-static char *my_makepath(char *d, char *s);
+static int ep4_map_file(int filenr, char *errtext);
+static void ep4_unmap(void);
+static int ep4_pack(int jlong, int32 iflag, struct ep4 *e, char *errtext);
 
 # ifdef INTEL_BYTE_ORDER
 /********************************************************************/
@@ -111,10 +134,9 @@ void shortreorder (UCHAR *p, int n)
 ****************************************************/
 centisec *ephread(double jd, int plalist, int flag, char *errtext)
 {
-  static int jdbase =  INVALID_BASE;
-  static int lastplalist = 0;
-  static centisec lon[EP_NP][EPBS];	/* buffer for 20 days unpacked ephe */
-  static centisec out[2 * EP_NP];	/* buffer for return longitude
+  static TLS int lastplalist = 0;
+  static TLS centisec lon[EP_NP][EPBS];	/* buffer for 20 days unpacked ephe */
+  static TLS centisec out[2 * EP_NP];	/* buffer for return longitude
 					   and return speed */
   int p, pf;
   int ix, jdlong, iflagret;
@@ -131,27 +153,27 @@ centisec *ephread(double jd, int plalist, int flag, char *errtext)
    * changed since the last call.
    */
   if ((plalist & lastplalist) != plalist) {	/* new set is not contained in old */
-    jdbase = INVALID_BASE;
+    jdbase_l = INVALID_BASE;
   }
   lastplalist = plalist;
   jdlong = floor(jd - 0.5);
-  ix = jdlong - jdbase;
+  ix = jdlong - jdbase_l;
   if (ix < EP_MIN_IX || ix >= EPBS) {	/* must reload full buffer */
-    jdbase = ((jdlong - EP_MIN_IX) / NDB) * NDB;		/* new base */
-    if (jdbase > jdlong - EP_MIN_IX) jdbase -= NDB;	/* fix bug for neg. */
-    if (ephe4_unpack (jdbase, plalist, lon, 0, errtext) != OK)
+    jdbase_l = ((jdlong - EP_MIN_IX) / NDB) * NDB;		/* new base */
+    if (jdbase_l > jdlong - EP_MIN_IX) jdbase_l -= NDB;	/* fix bug for neg. */
+    if (ephe4_unpack (jdbase_l, plalist, lon, 0, errtext) != OK)
       goto err_exit;
-    if (ephe4_unpack (jdbase + NDB, plalist, lon, 0 + NDB, errtext) != OK)
+    if (ephe4_unpack (jdbase_l + NDB, plalist, lon, 0 + NDB, errtext) != OK)
       goto err_exit;
-    ix = jdlong - jdbase;
+    ix = jdlong - jdbase_l;
   } else if (ix > EP_MAX_IX) {		/* must shift upper half down
 					   and reload upper half of buffer */
-    jdbase +=  NDB;		/* new base */
+    jdbase_l +=  NDB;		/* new base */
     for (p = 0; p < EP_NP; p++)
       memcpy (&lon[p][0], &lon[p][NDB], NDB * sizeof(centisec));
-    if (ephe4_unpack (jdbase + NDB, plalist, lon, 0 + NDB, errtext) != OK)
+    if (ephe4_unpack (jdbase_l + NDB, plalist, lon, 0 + NDB, errtext) != OK)
       goto err_exit;
-    ix = jdlong - jdbase;
+    ix = jdlong - jdbase_l;
   }
   jfract = jd - 0.5 - jdlong;        
   /*
@@ -176,7 +198,7 @@ centisec *ephread(double jd, int plalist, int flag, char *errtext)
     }
   return out;
 err_exit:
-  jdbase = INVALID_BASE;
+  jdbase_l = INVALID_BASE;
   lastplalist = 0;
   if ((flag & EP_BIT_MUST_USE_EPHE) == 0) {	/* try using calc */
     int sweflag = 0;
@@ -205,7 +227,8 @@ err_exit:
     }
     if ((iflagret = swe_calc(jd, SE_ECL_NUT, 0, x, serr)) == ERR) {
       swe_close();
-      sprintf(errtext, "error in swe_calc() %s\n", serr);
+      if (errtext != NULL)
+        sprintf(errtext, "error in swe_calc() %s\n", serr);
       return NULL;
     }
     out[EP_ECL_INDEX] = swe_d2l(x[0] * DEG);	/* true ecliptic */
@@ -220,10 +243,9 @@ err_exit:
 // same in double
 double *dephread2(double jd, int plalist, int flag, char *errtext)
 {
-  static int jdbase =  INVALID_BASE;
-  static int lastplalist = 0;
-  static double lon[EP_NP][EPBS]; // buffer for 20 days unpacked ephe 
-  static double out[2 * EP_NP];	 // buffer for return longitude and return speed 
+  static TLS int lastplalist = 0;
+  static TLS double lon[EP_NP][EPBS]; // buffer for 20 days unpacked ephe 
+  static TLS double out[2 * EP_NP];	 // buffer for return longitude and return speed 
   int p, pf;
   int ix, jdlong, iflagret;
   double lp;
@@ -239,27 +261,27 @@ double *dephread2(double jd, int plalist, int flag, char *errtext)
    * changed since the last call.
    */
   if ((plalist & lastplalist) != plalist) {	/* new set is not contained in old */
-    jdbase = INVALID_BASE;
+    jdbase_d = INVALID_BASE;
   }
   lastplalist = plalist;
   jdlong = floor(jd - 0.5);
-  ix = jdlong - jdbase;
+  ix = jdlong - jdbase_d;
   if (ix < EP_MIN_IX || ix >= EPBS) {	/* must reload full buffer */
-    jdbase = ((jdlong - EP_MIN_IX) / NDB) * NDB;		/* new base */
-    if (jdbase > jdlong - EP_MIN_IX) jdbase -= NDB;	/* fix bug for neg. */
-    if (ephe4_unpack_d(jdbase, plalist, lon, 0, errtext) != OK)
+    jdbase_d = ((jdlong - EP_MIN_IX) / NDB) * NDB;		/* new base */
+    if (jdbase_d > jdlong - EP_MIN_IX) jdbase_d -= NDB;	/* fix bug for neg. */
+    if (ephe4_unpack_d(jdbase_d, plalist, lon, 0, errtext) != OK)
       goto err_exit;
-    if (ephe4_unpack_d(jdbase + NDB, plalist, lon, 0 + NDB, errtext) != OK)
+    if (ephe4_unpack_d(jdbase_d + NDB, plalist, lon, 0 + NDB, errtext) != OK)
       goto err_exit;
-    ix = jdlong - jdbase;
+    ix = jdlong - jdbase_d;
   } else if (ix > EP_MAX_IX) {		/* must shift upper half down
 					   and reload upper half of buffer */
-    jdbase +=  NDB;		/* new base */
+    jdbase_d +=  NDB;		/* new base */
     for (p = 0; p < EP_NP; p++)
       memcpy(&lon[p][0], &lon[p][NDB], NDB * sizeof(double));
-    if (ephe4_unpack_d(jdbase + NDB, plalist, lon, 0 + NDB, errtext) != OK)
+    if (ephe4_unpack_d(jdbase_d + NDB, plalist, lon, 0 + NDB, errtext) != OK)
       goto err_exit;
-    ix = jdlong - jdbase;
+    ix = jdlong - jdbase_d;
   }
   jfract = jd - 0.5 - jdlong;        
   /*
@@ -284,7 +306,7 @@ double *dephread2(double jd, int plalist, int flag, char *errtext)
     }
   return out;
 err_exit:
-  jdbase = INVALID_BASE;
+  jdbase_d = INVALID_BASE;
   lastplalist = 0;
   if ((flag & EP_BIT_MUST_USE_EPHE) == 0) {	/* try using calc */
     int sweflag = 0;
@@ -313,7 +335,8 @@ err_exit:
     }
     if ((iflagret = swe_calc(jd, SE_ECL_NUT, 0, x, serr)) == ERR) {
       swe_close();
-      sprintf(errtext, "error in swe_calc() %s\n", serr);
+      if (errtext != NULL)
+        sprintf(errtext, "error in swe_calc() %s\n", serr);
       return NULL;
     }
     out[EP_ECL_INDEX] = x[0];	/* true ecliptic */
@@ -337,14 +360,11 @@ static int ephe4_unpack(int jdl, int plalist, centisec lon[][EPBS], int i0,char
 {
   int p, i, pf;
   centisec l_ret, d_ret;
+  const struct ep4 *ep;
   struct ep4 e;
-  if (eph4_posit (jdl, FALSE, errs) != OK)
-    return (ERR);
-  if (fread (&e, sizeof(struct ep4), 1, ephfp) != 1) {
-    if (errs != NULL)
-      sprintf (errs, "ephe4_unpack: fread for jd=%d failed", jdl);
+  if ((ep = eph4_posit (jdl, errs)) == NULL)
     return (ERR);
-  }
+  memcpy(&e, ep, sizeof(struct ep4));
 #ifdef INTEL_BYTE_ORDER
   shortreorder((UCHAR *) &e, sizeof(struct ep4));
 #endif
@@ -394,14 +414,11 @@ static int ephe4_unpack_d(int jdl, int plalist, double lon[][EPBS], int i0,char
 {
   int p, i, pf;
   double l_ret, d_ret;
+  const struct ep4 *ep;
   struct ep4 e;
-  if (eph4_posit (jdl, FALSE, errs) != OK)
+  if ((ep = eph4_posit (jdl, errs)) == NULL)
     return (ERR);
-  if (fread (&e, sizeof(struct ep4), 1, ephfp) != 1) {
-    if (errs != NULL)
-      sprintf (errs, "ephe4_unpack: fread for jd=%d failed", jdl);
-    return (ERR);
-  }
+  memcpy(&e, ep, sizeof(struct ep4));
 #ifdef INTEL_BYTE_ORDER
   shortreorder((UCHAR *) &e, sizeof(struct ep4));
 #endif
@@ -447,57 +464,109 @@ static int ephe4_unpack_d(int jdl, int plalist, double lon[][EPBS], int i0,char
 }	
 
 /****************************************************
-  position ephe file at proper position for julian 
-  date jd; if writeflag = TRUE (write mode), create file
-  if required. Return OK or ERR.
-  globals used: ephfp.
+  return a pointer to the block of the ephe file for
+  julian day jlong. The file is searched in the ephemeris path
+  and mapped into memory when it is first needed; a missing file
+  is remembered until the file number or the ephemeris path changes.
+  Return NULL on error.
 *****************************************************/
-int eph4_posit (int jlong, AS_BOOL writeflag, char *errtext)
+const struct ep4 *eph4_posit (int jlong, char *errtext)
 {
   int filenr;
-  long posit;
-  static int open_filenr = -10000;
-  char fname[AS_MAXCH], s[80], *sp;
+  size_t posit;
   filenr = jlong / EP4_NDAYS;   
   if (jlong < 0 && filenr * EP4_NDAYS != jlong) filenr--;
-  posit = jlong - filenr * EP4_NDAYS;
-  posit = posit / NDB * sizeof(struct ep4);
-  if (open_filenr  != filenr) {
-    if (ephfp != NULL) {
-      fclose(ephfp);
-      open_filenr = -10000;
-    }
-    if (filenr >= 0)
-      sprintf (s, "%s%s%d", EP4_PATH, EP4_FILE, filenr);
-    else
-      sprintf (s, "%s%sM%d", EP4_PATH, EP4_FILE, -filenr);
-    my_makepath(fname, s);
-    if (writeflag)
-      sp = BFILE_W_CREATE;
-    else
-      sp = BFILE_R_ACCESS;
-    ephfp = fopen (fname, sp);
-    if (ephfp == NULL) {
-      if (errtext != NULL) {
-	if (! writeflag)  {
-	  sprintf (errtext,"eph4_posit: file %s does not exist\n",  fname);
-	} else {
-	  sprintf (errtext,"eph4_posit: could not create file %s\n",  fname);
-	}
+  posit = (jlong - filenr * EP4_NDAYS) / NDB * sizeof(struct ep4);
+  if (!swed.ephe_path_is_set)
+    swe_set_ephe_path(NULL);
+  if (ep4map.filenr != filenr || strcmp(ep4map.ephepath, swed.ephepath) != 0) {
+    if (ep4_map_file(filenr, errtext) != OK)
+      return NULL;
+  } else if (ep4map.base == NULL) {
+    if (errtext != NULL)
+      sprintf (errtext, "eph4_posit: file nr %d does not exist", filenr);
+    return NULL;
+  }
+  if (posit + sizeof(struct ep4) > ep4map.size) {
+    if (errtext != NULL)
+      sprintf (errtext, "eph4_posit: jd=%d is beyond end of file nr %d", 
+	      jlong, filenr);
+    return NULL;
+  }
+  return (const struct ep4 *) (ep4map.base + posit);
+}	/* end eph4_posit */
+
+static void ep4_filename(int filenr, char *fname)
+{
+  if (filenr >= 0)
+    sprintf (fname, "%s%d", EP4_FILE, filenr);
+  else
+    sprintf (fname, "%sM%d", EP4_FILE, -filenr);
+}
+
+/* map file number filenr into memory, replacing the file mapped before */
+static int ep4_map_file(int filenr, char *errtext)
+{
+  FILE *fp;
+  long size;
+  UCHAR *base = NULL;
+  char fname[AS_MAXCH];
+  ep4_unmap();
+  ep4map.filenr = filenr;
+  strcpy(ep4map.ephepath, swed.ephepath);
+  ep4_filename(filenr, fname);
+  if ((fp = swi_fopen(-1, fname, swed.ephepath, errtext)) == NULL)
+    return ERR;
+  if (fseek(fp, 0L, SEEK_END) == 0 && (size = ftell(fp)) > 0) {
+# if HPUNIX
+    base = mmap(NULL, (size_t) size, PROT_READ, MAP_SHARED, fileno(fp), 0);
+    if (base == MAP_FAILED)
+      base = NULL;
+# else
+    if ((base = malloc((size_t) size)) != NULL) {
+      rewind(fp);
+      if (fread(base, (size_t) size, 1, fp) != 1) {
+	free(base);
+	base = NULL;
       }
-      return (ERR);	
     }
-    open_filenr = filenr;
+# endif
   }
-  if  (fseek (ephfp, posit, 0) == 0 && ftell(ephfp) == posit) {
-    return (OK);
-  } else {
+  fclose(fp);
+  if (base == NULL) {
     if (errtext != NULL)
-      sprintf (errtext,"eph4_posit: fseek(%ld) of file nr %d failed\n",  
-	      posit, open_filenr);
-    return (ERR);
+      sprintf (errtext, "eph4_posit: could not map file %s", fname);
+    return ERR;
   }
-}	/* end eph4_posit */
+  ep4map.base = base;
+  ep4map.size = (size_t) size;
+  return OK;
+}
+
+static void ep4_unmap(void)
+{
+  if (ep4map.base != NULL) {
+# if HPUNIX
+    munmap(ep4map.base, ep4map.size);
+# else
+    free(ep4map.base);
+# endif
+  }
+  ep4map.base = NULL;
+  ep4map.size = 0;
+  ep4map.filenr = EP4_NOFILE;
+  *ep4map.ephepath = '\0';
+}
+
+/****************************************************
+  release the mapped ephe file and the buffers of the calling thread.
+****************************************************/
+void ep4_close(void)
+{
+  ep4_unmap();
+  jdbase_l = INVALID_BASE;
+  jdbase_d = INVALID_BASE;
+}
 
 /*****************************************************
 quicker Everett interpolation, after Pottenger
@@ -513,10 +582,10 @@ static void inpolq_l(int n, int o, double p, centisec *x, centisec *axu, centise
  * adxu pointer for storage of dx/dt  
  */
 {
-  static double	q,q2,q3,q4,q5,
+  static TLS double	q,q2,q3,q4,q5,
 	  p2,p3,p4,p5,
 	  u,u0,u1,u2;
-  static double lastp = 9999;
+  static TLS double lastp = 9999;
   double rl, rlp;
   centisec	dm2,dm1,d0,dp1,dp2,
 	  d2m1,d20,d2p1,d2p2,
@@ -603,8 +672,8 @@ static int inpolq(int n, int o, double p, double *x, double *axu, double *adxu)
 // *axu	pointer for storage of result 
 // *adxu pointer for storage of dx/dt  
 {
-  static double	q,q2,q3,q4,q5,p2,p3,p4,p5, u,u0,u1,u2;
-  static double lastp = 9999.0;
+  static TLS double	q,q2,q3,q4,q5,p2,p3,p4,p5, u,u0,u1,u2;
+  static TLS double lastp = 9999.0;
   double	dm2,dm1,d0,dp1,dp2,
 	  d2m1,d20,d2p1,d2p2,
 	  d30,d3p1,d3p2,
@@ -668,18 +737,6 @@ static int inpolq(int n, int o, double p, double *x, double *axu, double *adxu)
 }	/* end inpolq() */
 
 
-static char *my_makepath(char *d, char *s)
-{
-  char *getenv();
-  if (*s == *DIR_GLUE || *s == '/' || strchr (s, ':') != NULL) {
-    strcpy (d, s);	/* s is absolute path name */
-  }
-# if MSDOS
-  while ((p = strchr(d, '/')) != NULL) *p = '\\';
-# endif
-  return (d);
-}
-
 int ephe_plac2swe(int p)
 {
   if (p >= PLACALC_SUN && p <= PLACALC_TRUE_NODE) return p;
@@ -692,3 +749,197 @@ int ephe_plac2swe(int p)
   if (p == PLACALC_EARTHHEL) return SE_EARTH;
   return -1;
 }
+
+int ephe_swe2plac(int ipl)
+{
+  if (ipl >= SE_SUN && ipl <= SE_TRUE_NODE) return ipl;
+  if (ipl == SE_CHIRON) return PLACALC_CHIRON;
+  if (ipl == SE_MEAN_APOG) return PLACALC_LILITH;
+  if (ipl == SE_CERES) return PLACALC_CERES;
+  if (ipl == SE_PALLAS) return PLACALC_PALLAS;
+  if (ipl == SE_JUNO) return PLACALC_JUNO;
+  if (ipl == SE_VESTA) return PLACALC_VESTA;
+  if (ipl == SE_EARTH) return PLACALC_EARTHHEL;
+  return -1;
+}
+
+/****************************************************
+  fast longitude of planet ipl (SE_SUN .. SE_TRUE_NODE, SE_CHIRON)
+  at julian day tjd_et from the ep4 files, with dephread2().
+  xx[0] = longitude, xx[1] = speed in degrees/day.
+  The file stores daily positions to 0.01"; between the days, the
+  interpolated longitudes agree with swe_calc() to about 0.01" for the
+  Sun and the planets, 0.1" for Mercury, 0.5" for the Moon and 1" for
+  the true node. Planets within 2 degrees of the Sun can be off by
+  several arcseconds, because the light deflection changes too fast
+  for the interpolation. A call takes a small fraction of swe_calc().
+  If the ep4 file is missing, swe_calc() is used.
+  Return OK or ERR.
+****************************************************/
+int ep4_calc(double tjd_et, int ipl, double *xx, char *serr)
+{
+  int p = ephe_swe2plac(ipl);
+  double *dp;
+  if (p < 0 || p > PLACALC_CHIRON) {
+    if (serr != NULL)
+      sprintf(serr, "ep4_calc: planet %d is not in the ep4 ephemeris", ipl);
+    return ERR;
+  }
+  if ((dp = dephread2(tjd_et, 1 << p, EP_BIT_SPEED, serr)) == NULL)
+    return ERR;
+  xx[0] = dp[p];
+  xx[1] = dp[p + EP_NP];
+  return OK;
+}
+
+/****************************************************
+  ep4_calc() for n dates tjd_et[i], for scans over time.
+  xx[2*i] = longitude, xx[2*i+1] = speed.
+  Return OK or ERR.
+****************************************************/
+int ep4_calc_arr(double *tjd_et, int32 n, int ipl, double *xx, char *serr)
+{
+  int32 i;
+  for (i = 0; i < n; i++) {
+    if (ep4_calc(tjd_et[i], ipl, xx + 2 * i, serr) != OK)
+      return ERR;
+  }
+  return OK;
+}
+
+/****************************************************
+  pack the positions of the 10 days from julian day jlong
+  (jd = jlong + 0.5) into the ep4 block e. Positions are
+  computed with swe_calc(), using ephemeris flag iflag.
+  Rounding errors of the second differences are carried forward, 
+  so that they do not accumulate over the block.
+****************************************************/
+static int ep4_pack(int jlong, int32 iflag, struct ep4 *e, char *errtext)
+{
+  int p, i, scale;
+  double x[6];
+  centisec l[NDB], ecl0, d, rl, rd, q;
+  char serr[AS_MAXCH];
+  memset(e, 0, sizeof(struct ep4));
+  e->j_10000 = (short) (jlong / 10000L);
+  if (jlong < 0 && e->j_10000 * 10000L != jlong) e->j_10000--;
+  e->j_rest = (short) (jlong - e->j_10000 * 10000L);
+  for (p = PLACALC_SUN; p <= PLACALC_CHIRON; p++) {
+    for (i = 0; i < NDB; i++) {
+      if (swe_calc(jlong + i + 0.5, ephe_plac2swe(p), iflag, x, serr) == ERR) {
+	if (errtext != NULL)
+	  sprintf(errtext, "ep4_pack: %s", serr);
+	return ERR;
+      }
+      l[i] = swe_d2l(x[0] * DEG);
+      if (l[i] >= DEG360) l[i] -= DEG360;
+    }
+    e->elo[p].p0m = (short) (l[0] / 6000);
+    e->elo[p].p0s = (short) (l[0] - e->elo[p].p0m * 6000);
+    d = l[1] - l[0];
+    if (d >= DEG180) d -= DEG360;
+    else if (d < -DEG180) d += DEG360;
+    e->elo[p].pd1m = (short) (d / 6000);
+    e->elo[p].pd1s = (short) (d - e->elo[p].pd1m * 6000);
+    scale = (p == PLACALC_MOON || p == PLACALC_MERCURY) ? 10 : 1;
+    rl = l[0] + d;		/* longitude and daily motion as unpacked */
+    rd = d;
+    for (i = 2; i < NDB; i++) {
+      d = l[i] - rl;
+      d -= (d / DEG360) * DEG360;
+      if (d >= DEG180) d -= DEG360;
+      else if (d < -DEG180) d += DEG360;
+      q = swe_d2l((double) (d - rd) / scale);
+      if (q > 32767) q = 32767;
+      else if (q < -32767) q = -32767;
+      e->elo[p].pd2[i-2] = (short) q;
+      rd += q * scale;
+      rl += rd;
+    }
+  }
+  for (i = 0; i < NDB; i++) {
+    if (swe_calc(jlong + i + 0.5, SE_ECL_NUT, iflag, x, serr) == ERR) {
+      if (errtext != NULL)
+	sprintf(errtext, "ep4_pack: %s", serr);
+      return ERR;
+    }
+    if (i == 0) {
+      ecl0 = swe_d2l(x[0] * DEG);
+      e->ecl0m = (short) (ecl0 / 6000);
+      e->ecl0s = (short) (ecl0 - e->ecl0m * 6000);
+    } else {
+      e->ecld1[i-1] = (short) (swe_d2l(x[0] * DEG) - ecl0);
+    }
+    e->nuts[i] = (short) swe_d2l(x[2] * DEG);
+  }
+#ifdef INTEL_BYTE_ORDER
+  shortreorder((UCHAR *) e, sizeof(struct ep4));
+#endif
+  return OK;
+}
+
+/****************************************************
+  generate the ep4 file number filenr, which covers the EP4_NDAYS
+  days from julian day filenr * EP4_NDAYS, with swe_calc().
+  iflag selects the ephemeris (SEFLG_SWIEPH, SEFLG_JPLEPH, SEFLG_MOSEPH),
+  other bits are ignored.
+  The file is written into directory dir, or into the first directory
+  of the ephemeris path, if dir is NULL or empty. It is written under
+  a temporary name first, so that threads which have mapped the old 
+  file can go on reading it.
+  Return OK or ERR.
+****************************************************/
+int ep4_make_file(int filenr, int32 iflag, char *dir, char *errtext)
+{
+  FILE *fp;
+  struct ep4 e;
+  int jlong, retc = OK;
+  char fname[AS_MAXCH], ftmp[AS_MAXCH + 4], s[AS_MAXCH];
+  const char *wdir;
+  iflag &= (SEFLG_JPLEPH | SEFLG_SWIEPH | SEFLG_MOSEPH);
+  wdir = swi_ephe_write_dir(dir, s);
+  if (strlen(wdir) + 20 >= AS_MAXCH) {
+    if (errtext != NULL)
+      sprintf(errtext, "ep4_make_file: directory name too long");
+    return ERR;
+  }
+  strcpy(fname, wdir);
+  if (fname[strlen(fname) - 1] != *DIR_GLUE)
+    strcat(fname, DIR_GLUE);
+  ep4_filename(filenr, fname + strlen(fname));
+  sprintf(ftmp, "%s.tmp", fname);
+  if ((fp = fopen(ftmp, BFILE_W_CREATE)) == NULL) {
+    if (errtext != NULL)
+      sprintf(errtext, "ep4_make_file: could not create file %s", ftmp);
+    return ERR;
+  }
+  for (jlong = filenr * EP4_NDAYS; jlong < (filenr + 1) * EP4_NDAYS; jlong += NDB) {
+    if ((retc = ep4_pack(jlong, iflag, &e, errtext)) != OK)
+      break;
+    if (fwrite(&e, sizeof(struct ep4), 1, fp) != 1) {
+      if (errtext != NULL)
+	sprintf(errtext, "ep4_make_file: could not write file %s", ftmp);
+      retc = ERR;
+      break;
+    }
+  }
+  if (fclose(fp) != 0 && retc == OK) {
+    if (errtext != NULL)
+      sprintf(errtext, "ep4_make_file: could not write file %s", ftmp);
+    retc = ERR;
+  }
+# if !HPUNIX
+  if (retc == OK)
+    remove(fname);	/* rename() does not replace files on Windows */
+# endif
+  if (retc == OK && rename(ftmp, fname) != 0) {
+    if (errtext != NULL)
+      sprintf(errtext, "ep4_make_file: could not rename %s", ftmp);
+    retc = ERR;
+  }
+  if (retc != OK)
+    remove(ftmp);
+  swi_fopen_cache_clear();	/* the file may have been cached as missing */
+  ep4_close();
+  return retc;
+}
@@ -138,12 +138,7 @@ extern "C" {
 # define PLACALC_CALC_N_MC  22	/* number of normal natal factors */
 
 # define EP4_BLOCKSIZE  sizeof(struct ep4)
-# if HPUNIX
-#   define EP4_PATH "/home/ephe/"
-# else
-#   define EP4_PATH  "ephe\\"
-# endif
-# define EP4_FILE	"sep4_"		/* packed ephemeris */
+# define EP4_FILE	"sep4_"		/* packed ephemeris, in the ephemeris path */
 # define EP4_NDAYS	10000L		/* days  per EP4_ file */
 # define NDB		10L		/* 10 days per block */
 
@@ -196,11 +191,6 @@ struct ep4  {
 };
 
 
-/******************************************
- globals exported by module ephe.c
-********************************************/
-extern FILE *ephfp;
-
 /******************************************
  functions exported by module ephe.c
 ********************************************/
@@ -226,10 +216,30 @@ extern centisec *ephread(double jd, int plalist, int flag, char *errtext);
  */
 extern double *dephread2(double jd, int plalist, int flag, char *errtext);
 
-extern int eph4_posit (int jlong, AS_BOOL writeflag, char *errtext);
+extern const struct ep4 *eph4_posit (int jlong, char *errtext);
+
+extern void ep4_close(void);
+
+extern int ep4_calc(double tjd_et, int ipl, double *xx, char *serr);
+/*
+ * Fast longitude mode: longitude xx[0] and speed xx[1] of planet ipl 
+ * (SE_SUN .. SE_TRUE_NODE, SE_CHIRON), from the ep4 files.
+ * All buffers are thread local; each thread maps one ep4 file.
+ */
+
+extern int ep4_calc_arr(double *tjd_et, int32 n, int ipl, double *xx, char *serr);
+
+extern int ep4_make_file(int filenr, int32 iflag, char *dir, char *errtext);
+/*
+ * Generates the ep4 file filenr (days filenr * EP4_NDAYS ..) with swe_calc()
+ * in directory dir or, if dir is NULL, in the first directory of the
+ * ephemeris path.
+ */
 
 extern int ephe_plac2swe(int p);
 
+extern int ephe_swe2plac(int ipl);
+
 extern void shortreorder (UCHAR *p, int n);
 
 #ifdef __cplusplus
@@ -72,6 +72,7 @@
 #include "sweph.h"
 #include "swephlib.h"
 #include <sys/stat.h>
+#include <time.h>
 
 #define PLSV   0 /*if Planet, Lunar and Stellar Visibility formula is needed PLSV=1*/
 #define criticalangle   0.0 /*[deg]*/
@@ -405,6 +406,220 @@ static int32 call_swe_rise_trans(double tjd, int32 ipl, char *star, int32 helfla
   return retval;
 }
 
+/*###################################################################
+ * Memory of the sub-computations of one heliacal event search.
+ * The searches of swe_heliacal_ut() evaluate the visibility of the object 
+ * many times at the same moments (e.g. when they return to a day with
+ * a smaller step), and the positions of sun, moon and object, their 
+ * magnitude and the sky brightness and extinction at each of them. 
+ * While a search is running (helmemo.active > 0), the results of
+ * swe_vis_limit_mag(), ObjectLoc(), Magnitude(), VisLimMagn() and 
+ * calc_rise_and_set() are remembered together with all their input 
+ * (time, location, atmosphere, observer, flags) and are reused, if the
+ * same input comes again.
+ * Outside a search nothing is remembered, because the ephemeris
+ * may change between calls.
+ */
+#define HEL_MEMO_N	16
+struct hel_memo_vis {
+  double tjd, dgeo[3], datm[4], dobs[6], dret[8];
+  int32 helflag, retval;
+  char name[AS_MAXCH];
+};
+/* positions of planets are kept in a larger hash table, because the
+ * same moments return often in a search and the positions of sun and
+ * moon are needed at each of them; it is allocated with the first 
+ * search and freed by swe_close() */
+#define HEL_MEMO_LOC_N	1024
+struct hel_memo_loc {
+  double tjd, dgeo[3], datm[2], x[2], xaz[2];
+  int32 iflag, ipl;
+  int gen;	/* valid if equal to helmemo.gen */
+  char *name;	/* fixed stars only */
+};
+struct hel_memo_mag {
+  double tjd, dgeo[3], dmag;
+  int32 helflag;
+  char name[AS_MAXCH];
+};
+/* risings and settings are kept in a hash table by day, so that in
+ * swe_heliacal_range() the sunrise and sunset of a day are computed 
+ * once for all objects; allocated and freed with the position table */
+#define HEL_MEMO_RISE_N	2048
+struct hel_memo_rise {
+  double tjdnoon, dgeo[3], datm[2], trise;
+  int32 ipl, eventflag, helflag;
+  int gen;	/* valid if equal to helmemo.gen */
+};
+struct hel_memo_sky {
+  double in[10], datm[4], dobs[6], vlim;
+  int32 helflag, scotopic_flag;
+};
+static TLS struct {
+  int active;
+  struct hel_memo_vis vis[HEL_MEMO_N];
+  struct hel_memo_loc *loc;	/* HEL_MEMO_LOC_N entries, or NULL */
+  struct hel_memo_loc star[HEL_MEMO_N];
+  char starname[HEL_MEMO_N][AS_MAXCH];
+  int gen;	/* number of the search */
+  struct hel_memo_mag mag[HEL_MEMO_N];
+  struct hel_memo_sky sky[HEL_MEMO_N];
+  struct hel_memo_rise *rise;	/* HEL_MEMO_RISE_N entries, or NULL */
+  int nvis, nstar, nmag, nsky;	/* number of entries used */
+  int ivis, istar, imag, isky;	/* next entry to be replaced */
+  double stat[SE_NHELSTATS];
+} helmemo;
+
+/* index of the entry to be written next */
+static int hel_memo_next(int *n, int *i)
+{
+  if (*n < HEL_MEMO_N)
+    return (*n)++;
+  *i = (*i + 1) % HEL_MEMO_N;
+  return *i;
+}
+
+static AS_BOOL hel_memo_same(const double *a, const double *b, int n)
+{
+  int i;
+  for (i = 0; i < n; i++)
+    if (a[i] != b[i])
+      return FALSE;
+  return TRUE;
+}
+
+/* entry of the position memory for a planet at tjd, or for a star */
+static struct hel_memo_loc *hel_memo_loc_entry(double tjd, int32 ipl, int32 iflag, char *name, AS_BOOL for_store)
+{
+  int i;
+  uint32 h;
+  unsigned char b[sizeof(double)];
+  struct hel_memo_loc *m;
+  if (ipl == -1) {
+    if (for_store) {
+      i = hel_memo_next(&helmemo.nstar, &helmemo.istar);
+      helmemo.star[i].name = helmemo.starname[i];
+      strcpy(helmemo.star[i].name, name);
+      return &helmemo.star[i];
+    }
+    for (i = 0; i < helmemo.nstar; i++) {
+      m = &helmemo.star[i];
+      if (m->tjd == tjd && m->iflag == iflag && strcmp(m->name, name) == 0)
+        return m;
+    }
+    return NULL;
+  }
+  if (helmemo.loc == NULL)
+    return NULL;
+  memcpy(b, &tjd, sizeof(double));
+  h = (uint32) ipl * 2654435761u ^ (uint32) iflag;
+  for (i = 0; i < (int) sizeof(double); i++)
+    h = (h ^ b[i]) * 16777619u;
+  m = &helmemo.loc[h % HEL_MEMO_LOC_N];
+  if (for_store) {
+    m->gen = helmemo.gen;
+    return m;
+  }
+  if (m->gen == helmemo.gen && m->tjd == tjd && m->ipl == ipl && m->iflag == iflag)
+    return m;
+  return NULL;
+}
+
+/* processor time of the calling thread in seconds; clock() would count 
+ * all threads of the process. Where there is no thread clock, the 
+ * monotonic wall clock is used. */
+static double hel_clock(void)
+{
+#if MSDOS
+  FILETIME tcreate, texit, tkernel, tuser;
+  if (GetThreadTimes(GetCurrentThread(), &tcreate, &texit, &tkernel, &tuser))
+    return ((double) tkernel.dwHighDateTime + tuser.dwHighDateTime) * 429.4967296
+      + ((double) tkernel.dwLowDateTime + tuser.dwLowDateTime) * 1e-7;
+  return (double) GetTickCount64() / 1000.0;
+#else
+  struct timespec ts;
+# ifdef CLOCK_THREAD_CPUTIME_ID
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+# endif
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+/* slot of the rising or setting memory for a body on the day of tjdnoon */
+static struct hel_memo_rise *hel_memo_rise_entry(double tjdnoon, int32 ipl, int32 eventflag)
+{
+  int i;
+  uint32 h;
+  unsigned char b[sizeof(double)];
+  if (helmemo.rise == NULL)
+    return NULL;
+  memcpy(b, &tjdnoon, sizeof(double));
+  h = (uint32) ipl * 2654435761u ^ (uint32) eventflag;
+  for (i = 0; i < (int) sizeof(double); i++)
+    h = (h ^ b[i]) * 16777619u;
+  return &helmemo.rise[h % HEL_MEMO_RISE_N];
+}
+
+/* starts a search; searches may be nested */
+static void hel_memo_begin(void)
+{
+  if (helmemo.active++ > 0)
+    return;
+  if (helmemo.loc == NULL)
+    helmemo.loc = (struct hel_memo_loc *) calloc(HEL_MEMO_LOC_N, sizeof(struct hel_memo_loc));
+  if (helmemo.rise == NULL)
+    helmemo.rise = (struct hel_memo_rise *) calloc(HEL_MEMO_RISE_N, sizeof(struct hel_memo_rise));
+  helmemo.nvis = helmemo.nstar = helmemo.nmag = helmemo.nsky = 0;
+  helmemo.ivis = helmemo.istar = helmemo.imag = helmemo.isky = 0;
+  helmemo.gen++;
+  memset((void *) helmemo.stat, 0, sizeof(helmemo.stat));
+  helmemo.stat[SE_HELSTAT_TIME] = hel_clock();
+}
+
+static void hel_memo_end(void)
+{
+  if (--helmemo.active > 0)
+    return;
+  helmemo.stat[SE_HELSTAT_TIME] = hel_clock() - helmemo.stat[SE_HELSTAT_TIME];
+}
+
+void swi_hel_memo_close(void)
+{
+  if (helmemo.loc != NULL) {
+    free(helmemo.loc);
+    helmemo.loc = NULL;
+  }
+  if (helmemo.rise != NULL) {
+    free(helmemo.rise);
+    helmemo.rise = NULL;
+  }
+}
+
+/* adds the processor time since *t to stat[istat] and restarts *t */
+static void hel_memo_time(int istat, double *t)
+{
+  double t2 = hel_clock();
+  helmemo.stat[istat] += t2 - *t;
+  *t = t2;
+}
+
+/* 
+ * Breakdown of the processor time and counts of the sub-computations
+ * of the last call of swe_heliacal_ut() in this thread, see SE_HELSTAT_*.
+ * The times are the processor time of the calling thread, see hel_clock(),
+ * so other threads do not count.
+ * Writes at most nstat values to dstat and returns SE_NHELSTATS.
+ */
+int32 CALL_CONV swe_heliacal_stats(double *dstat, int32 nstat)
+{
+  int32 i;
+  for (i = 0; i < nstat && i < SE_NHELSTATS; i++)
+    dstat[i] = helmemo.stat[i];
+  return SE_NHELSTATS;
+}
+
 /* 
  * Written by Dieter Koch:
  * Fast function for risings and settings of planets, can be used instead of 
@@ -419,6 +634,7 @@ static int32 calc_rise_and_set(double tjd_start, int32 ipl, double *dgeo, double
   double sda, xs[6], xx[6], xaz[6], xaz2[6], dfac = 1/365.25;
   double rdi, rh;
   double tjd0 = tjd_start, tjdrise;
+  struct hel_memo_rise *m;
   double tjdnoon = (int) tjd0 - dgeo[0] / 15.0 / 24.0;
   int32 iflag = helflag & (SEFLG_JPLEPH|SEFLG_SWIEPH|SEFLG_MOSEPH);
   int32 epheflag = iflag;
@@ -430,7 +646,10 @@ static int32 calc_rise_and_set(double tjd_start, int32 ipl, double *dgeo, double
       strcpy(serr, "error in calc_rise_and_set(): calc(sun) failed ");
     return ERR;
   }
-  if (swe_calc_ut(tjd0, ipl, iflag, xx, serr) == 0) {
+  if (ipl == SE_SUN) {
+    for (i = 0; i < 6; i++)
+      xx[i] = xs[i];
+  } else if (swe_calc_ut(tjd0, ipl, iflag, xx, serr) == 0) {
     if (serr != NULL)
       strcpy(serr, "error in calc_rise_and_set(): calc(sun) failed ");
     return ERR;
@@ -455,6 +674,19 @@ if (eventflag & SE_CALC_RISE) {
     while (tjd0 - tjdnoon < -1.0) {/*printf("d");*/ tjdnoon -= 1;}
   }
 }
+  /* the rest depends only on the day of the event */
+  if (helmemo.active) {
+    helmemo.stat[SE_HELSTAT_NRISE]++;
+    m = hel_memo_rise_entry(tjdnoon, ipl, eventflag);
+    if (m != NULL && m->gen == helmemo.gen && m->tjdnoon == tjdnoon 
+      && m->ipl == ipl && m->eventflag == eventflag
+      && m->helflag == helflag && hel_memo_same(m->dgeo, dgeo, 3)
+      && hel_memo_same(m->datm, datm, 2)) {
+      helmemo.stat[SE_HELSTAT_NRISE_MEMO]++;
+      *trise = m->trise;
+      return OK;
+    }
+  }
   /* position of planet */
   if (swe_calc_ut(tjdnoon, ipl, iflag, xx, serr) == ERR) {
     if (serr != NULL)
@@ -501,6 +733,17 @@ if (eventflag & SE_CALC_RISE) {
     tjdrise -= (xaz[1] - rh) / (xaz[1] - xaz2[1]) *  dfac;
     /*fprintf(stderr, "%f\n", ph->trise);*/
   }
+  if (helmemo.active && (m = hel_memo_rise_entry(tjdnoon, ipl, eventflag)) != NULL) {
+    m->gen = helmemo.gen;
+    m->tjdnoon = tjdnoon;
+    m->ipl = ipl;
+    m->eventflag = eventflag;
+    m->helflag = helflag;
+    for (i = 0; i < 3; i++)
+      m->dgeo[i] = dgeo[i];
+    m->datm[0] = datm[0]; m->datm[1] = datm[1];
+    m->trise = tjdrise;
+  }
   *trise = tjdrise;
   return retc;
 }
@@ -622,6 +865,8 @@ static double TopoAltfromAppAlt(double AppAlt, double TempE, double PresE)
 ' AppAltfromTopoAlt [deg]
 ' call this instead of swe_azalt(), because it is faster (lower precision
 ' is required)
+' with SE_HELFLAG_REFRAC_TABLE, the refraction is interpolated in a table
+' of the fully converged iteration
 */
 static double AppAltfromTopoAlt(double TopoAlt, double TempE, double PresE, int32 helflag)
 {
@@ -632,6 +877,12 @@ static double AppAltfromTopoAlt(double TopoAlt, double TempE, double PresE, int3
   double oudAppAlt = newAppAlt;
   double oudTopoAlt = newTopoAlt;
   double verschil, retalt;
+  if (helflag & SE_HELFLAG_REFRAC_TABLE) {
+    retalt = TopoAlt + swi_refrac_table(TopoAlt, PresE, TempE, SE_TRUE_TO_APP);
+    if (retalt < LowestAppAlt)
+      retalt = TopoAlt;
+    return retalt;
+  }
   if (helflag & SE_HELFLAG_HIGH_PRECISION)
     nloop = 5;
   for (i = 0; i <= nloop; i++) {
@@ -686,14 +937,26 @@ static int32 ObjectLoc(double JDNDaysUT, double *dgeo, double *datm, char *Objec
   int32 Planet;
   int32 epheflag;
   int32 iflag = SEFLG_EQUATORIAL;
+  int i;
+  struct hel_memo_loc *m = NULL;
   epheflag = helflag & (SEFLG_JPLEPH|SEFLG_SWIEPH|SEFLG_MOSEPH);
   iflag |= epheflag;
   if (!(helflag & SE_HELFLAG_HIGH_PRECISION))
     iflag |= SEFLG_NONUT | SEFLG_TRUEPOS;
   if (Angle < 5) iflag = iflag | SEFLG_TOPOCTR;
   if (Angle == 7) Angle = 0;
-  tjd_tt = JDNDaysUT + swe_deltat_ex(JDNDaysUT, epheflag, serr);
   Planet = DeterObject(ObjectName);
+  if (helmemo.active) {
+    helmemo.stat[SE_HELSTAT_NLOC]++;
+    m = hel_memo_loc_entry(JDNDaysUT, Planet, iflag, ObjectName, FALSE);
+    if (m != NULL && hel_memo_same(m->dgeo, dgeo, 3) && hel_memo_same(m->datm, datm, 2)) {
+      helmemo.stat[SE_HELSTAT_NLOC_MEMO]++;
+      x[0] = m->x[0]; x[1] = m->x[1];
+      xaz[0] = m->xaz[0]; xaz[1] = m->xaz[1];
+      goto object_loc_found;
+    }
+  }
+  tjd_tt = JDNDaysUT + swe_deltat_ex(JDNDaysUT, epheflag, serr);
   if (Planet != -1) {
     if (swe_calc(tjd_tt, Planet, iflag, x, serr) == ERR)
       return ERR;
@@ -701,15 +964,31 @@ static int32 ObjectLoc(double JDNDaysUT, double *dgeo, double *datm, char *Objec
     if (call_swe_fixstar(ObjectName, tjd_tt, iflag, x, serr) == ERR)
       return ERR;
   }
+  /* azimuth and altitude, for Angle 0, 1 and 4 */
+  xaz[0] = xaz[1] = 0;
+  if (iflag & SEFLG_TOPOCTR) {
+    xin[0] = x[0];
+    xin[1] = x[1];
+    swe_azalt(JDNDaysUT, SE_EQU2HOR, dgeo, datm[0], datm[1], xin, xaz);
+  }
+  if (helmemo.active 
+    && (m = hel_memo_loc_entry(JDNDaysUT, Planet, iflag, ObjectName, TRUE)) != NULL) {
+    m->tjd = JDNDaysUT;
+    m->ipl = Planet;
+    m->iflag = iflag;
+    for (i = 0; i < 3; i++)
+      m->dgeo[i] = dgeo[i];
+    m->datm[0] = datm[0]; m->datm[1] = datm[1];
+    m->x[0] = x[0]; m->x[1] = x[1];
+    m->xaz[0] = xaz[0]; m->xaz[1] = xaz[1];
+  }
+object_loc_found:
   if (Angle == 2 ||  Angle == 5) {
     *dret = x[1];
   } else {
     if (Angle == 3 || Angle == 6) {
       *dret = x[0];
     } else {
-      xin[0] = x[0];
-      xin[1] = x[1];
-      swe_azalt(JDNDaysUT, SE_EQU2HOR, dgeo, datm[0], datm[1], xin, xaz);
       if (Angle == 0)
 	*dret = xaz[1];
       if (Angle == 4)
@@ -1103,12 +1382,26 @@ static double Bn(double AltO, double JDNDayUT, double AltS, double sunra, double
 ' ObjectName [-]
 ' Magnitude [-]
 */
-static int32 Magnitude(double JDNDaysUT, double *dgeo, char *ObjectName, int32 helflag, double *dmag, char *serr)
+static int32 magnitude_at(double JDNDaysUT, double *dgeo, char *ObjectName, int32 helflag, double *dmag, char *serr)
 {
   double x[20];
   int32 Planet, iflag, epheflag;
+  int i;
+  struct hel_memo_mag *m = NULL;
   epheflag = helflag & (SEFLG_JPLEPH|SEFLG_SWIEPH|SEFLG_MOSEPH);
   *dmag = -99.0;
+  if (helmemo.active) {
+    helmemo.stat[SE_HELSTAT_NMAG]++;
+    for (i = 0; i < helmemo.nmag; i++) {
+      m = &helmemo.mag[i];
+      if (m->tjd == JDNDaysUT && m->helflag == helflag && hel_memo_same(m->dgeo, dgeo, 3)
+        && strcmp(m->name, ObjectName) == 0) {
+        helmemo.stat[SE_HELSTAT_NMAG_MEMO]++;
+        *dmag = m->dmag;
+        return OK;
+      }
+    }
+  }
   Planet = DeterObject(ObjectName);
   iflag = SEFLG_TOPOCTR | SEFLG_EQUATORIAL | epheflag;
   if (!(helflag & SE_HELFLAG_HIGH_PRECISION))
@@ -1123,6 +1416,39 @@ static int32 Magnitude(double JDNDaysUT, double *dgeo, char *ObjectName, int32 h
     if (call_swe_fixstar_mag(ObjectName, dmag, serr) == ERR)
       return ERR;
   }
+  if (helmemo.active) {
+    m = &helmemo.mag[hel_memo_next(&helmemo.nmag, &helmemo.imag)];
+    m->tjd = JDNDaysUT;
+    m->helflag = helflag;
+    for (i = 0; i < 3; i++)
+      m->dgeo[i] = dgeo[i];
+    strcpy(m->name, ObjectName);
+    m->dmag = *dmag;
+  }
+  return OK;
+}
+
+/* 
+ * During a search, the magnitude of a planet is interpolated between 
+ * hourly values, unless SE_HELFLAG_HIGH_PRECISION is set. The error 
+ * of the interpolation is below 0.0001 magnitudes.
+ */
+#define HEL_MAG_STEP	(1.0 / 24.0)
+static int32 Magnitude(double JDNDaysUT, double *dgeo, char *ObjectName, int32 helflag, double *dmag, char *serr)
+{
+  double t0, m0, m1;
+  int32 Planet;
+  if (!helmemo.active || (helflag & SE_HELFLAG_HIGH_PRECISION))
+    return magnitude_at(JDNDaysUT, dgeo, ObjectName, helflag, dmag, serr);
+  Planet = DeterObject(ObjectName);
+  if (Planet <= SE_MOON)
+    return magnitude_at(JDNDaysUT, dgeo, ObjectName, helflag, dmag, serr);
+  t0 = floor(JDNDaysUT / HEL_MAG_STEP) * HEL_MAG_STEP;
+  if (magnitude_at(t0, dgeo, ObjectName, helflag, &m0, serr) == ERR)
+    return ERR;
+  if (magnitude_at(t0 + HEL_MAG_STEP, dgeo, ObjectName, helflag, &m1, serr) == ERR)
+    return ERR;
+  *dmag = m0 + (m1 - m0) * (JDNDaysUT - t0) / HEL_MAG_STEP;
   return OK;
 }
 
@@ -1384,8 +1710,27 @@ static double VisLimMagn(double *dobs, double AltO, double AziO, double AltM, do
   double C1, C2, Th, kX, Bsk, CorrFactor1, CorrFactor2;
   double log10 = 2.302585092994;
   AS_BOOL is_scotopic = FALSE;
+  double in[10], vlim;
+  int i;
+  int32 sflag;
+  struct hel_memo_sky *m = NULL;
   /*double Age = dobs[0];*/
   /*double SN = dobs[1];*/
+  if (helmemo.active) {
+    in[0] = AltO; in[1] = AziO; in[2] = AltM; in[3] = AziM; in[4] = JDNDaysUT;
+    in[5] = AltS; in[6] = AziS; in[7] = sunra; in[8] = Lat; in[9] = HeightEye;
+    helmemo.stat[SE_HELSTAT_NSKY]++;
+    for (i = 0; i < helmemo.nsky; i++) {
+      m = &helmemo.sky[i];
+      if (m->helflag == helflag && hel_memo_same(m->in, in, 10) 
+        && hel_memo_same(m->datm, datm, 4) && hel_memo_same(m->dobs, dobs, 6)) {
+        helmemo.stat[SE_HELSTAT_NSKY_MEMO]++;
+        if (scotopic_flag != NULL)
+          *scotopic_flag = m->scotopic_flag;
+        return m->vlim;
+      }
+    }
+  }
   Bsk = Bsky(AltO, AziO, AltM, AziM, JDNDaysUT, AltS, AziS, sunra, Lat, HeightEye, datm, helflag, serr);
   /* Schaefer, Astronomy and the limits of vision, Archaeoastronomy, 1993 Verder:*/
   kX = Deltam(AltO, AltS, sunra, Lat, HeightEye, datm, helflag, serr);
@@ -1410,18 +1755,16 @@ if ((0)) {
   if (is_scotopic) {
     C1 = 1.5848931924611e-10; /*pow(10, -9.8);*/ /* C1 = 10 ^ (-9.8);*/
     C2 = 0.012589254117942; /*pow(10, -1.9);*/ /* C2 = 10 ^ (-1.9);*/
-    if (scotopic_flag != NULL) 
-      *scotopic_flag = 1;
+    sflag = 1;
   } else {
     C1 = 4.4668359215096e-9; /*pow(10, -8.35);*/ /* C1 = 10 ^ (-8.35);*/
     C2 = 1.2589254117942e-6; /*pow(10, -5.9);*/ /* C2 = 10 ^ (-5.9);*/
-    if (scotopic_flag != NULL) 
-      *scotopic_flag = 0;
-  }
-  if (scotopic_flag != NULL) {
-    if (BNIGHT * BNIGHT_FACTOR > Bsk && BNIGHT / BNIGHT_FACTOR < Bsk)
-      *scotopic_flag |= 2;
+    sflag = 0;
   }
+  if (BNIGHT * BNIGHT_FACTOR > Bsk && BNIGHT / BNIGHT_FACTOR < Bsk)
+    sflag |= 2;
+  if (scotopic_flag != NULL)
+    *scotopic_flag = sflag;
   /*Th = C1 * pow(1 + sqrt(C2 * Bsk), 2) * Fa;*/
   /*Bsk = Bsk / CorrFactor1;*/
   Bsk = Bsk * CorrFactor1;
@@ -1439,7 +1782,17 @@ if ((0)) {
     SN = 0.00000001;
   return -16.57 - 2.5 * (log(Th) / log10) - kX + 5.0 * (log(SN) / log10);*/
 #endif
-  return -16.57 - 2.5 * (log(Th) / log10);
+  vlim = -16.57 - 2.5 * (log(Th) / log10);
+  if (helmemo.active) {
+    m = &helmemo.sky[hel_memo_next(&helmemo.nsky, &helmemo.isky)];
+    memcpy(m->in, in, sizeof(in));
+    memcpy(m->datm, datm, 4 * sizeof(double));
+    memcpy(m->dobs, dobs, 6 * sizeof(double));
+    m->helflag = helflag;
+    m->scotopic_flag = sflag;
+    m->vlim = vlim;
+  }
+  return vlim;
 }
 
 /* tolower star name, but not Bayer designation */
@@ -1461,7 +1814,7 @@ static char *tolower_string_star(char *str)
  *  |1  OK, scotopic vision
  *  |2  OK, near limit photopic/scotopic
 */
-int32 CALL_CONV swe_vis_limit_mag(double tjdut, double *dgeo, double *datm, double *dobs, char *ObjectName, int32 helflag, double *dret, char *serr)
+static int32 vis_limit_mag(double tjdut, double *dgeo, double *datm, double *dobs, char *ObjectName, int32 helflag, double *dret, char *serr)
 {
   int32 retval = OK, i, scotopic_flag = 0;
   double AltO, AziO, AltM, AziM, AltS, AziS;
@@ -1540,6 +1893,45 @@ int32 CALL_CONV swe_vis_limit_mag(double tjdut, double *dgeo, double *datm, doub
   return retval;
 }
 
+/* swe_vis_limit_mag(), with the results remembered during a search */
+int32 CALL_CONV swe_vis_limit_mag(double tjdut, double *dgeo, double *datm, double *dobs, char *ObjectName, int32 helflag, double *dret, char *serr)
+{
+  int32 retval, i;
+  struct hel_memo_vis *m;
+  if (!helmemo.active)
+    return vis_limit_mag(tjdut, dgeo, datm, dobs, ObjectName, helflag, dret, serr);
+  helmemo.stat[SE_HELSTAT_NVISLIM]++;
+  tolower_string_star(ObjectName);
+  default_heliacal_parameters(datm, dgeo, dobs, helflag);
+  for (i = 0; i < helmemo.nvis; i++) {
+    m = &helmemo.vis[i];
+    if (m->tjd == tjdut && m->helflag == helflag && hel_memo_same(m->dgeo, dgeo, 3)
+      && hel_memo_same(m->datm, datm, 4) && hel_memo_same(m->dobs, dobs, 6)
+      && strcmp(m->name, ObjectName) == 0) {
+      helmemo.stat[SE_HELSTAT_NVISLIM_MEMO]++;
+      for (i = 0; i < 8; i++)
+        dret[i] = m->dret[i];
+      if (m->retval == -2 && serr != NULL)
+        strcpy(serr, "object is below local horizon");
+      return m->retval;
+    }
+  }
+  retval = vis_limit_mag(tjdut, dgeo, datm, dobs, ObjectName, helflag, dret, serr);
+  if (retval == ERR)
+    return retval;
+  m = &helmemo.vis[hel_memo_next(&helmemo.nvis, &helmemo.ivis)];
+  m->tjd = tjdut;
+  m->helflag = helflag;
+  m->retval = retval;
+  memcpy(m->dgeo, dgeo, 3 * sizeof(double));
+  memcpy(m->datm, datm, 4 * sizeof(double));
+  memcpy(m->dobs, dobs, 6 * sizeof(double));
+  strcpy(m->name, ObjectName);
+  for (i = 0; i < 8; i++)
+    m->dret[i] = dret[i];
+  return retval;
+}
+
 /*###################################################################
 ' Magn [-]
 ' age [Year]
@@ -3166,6 +3558,7 @@ static int32 heliacal_ut_vis_lim(double tjd_start, double *dgeo, double *datm, d
   double d, darr[10], direct = 1, tjd, tday;
   int32 epheflag, retval = OK, helflag2;
   int32 iflag, ipl;
+  double t = hel_clock();
   int32 TypeEvent = TypeEventIn;
   char serr[AS_MAXCH];
   for (i = 0; i < 10; i++)
@@ -3199,8 +3592,10 @@ static int32 heliacal_ut_vis_lim(double tjd_start, double *dgeo, double *datm, d
 	goto swe_heliacal_err;
       }
     }
+    hel_memo_time(SE_HELSTAT_TIME_CONJ, &t);
     /* find the day and minute on which the object becomes visible */
     retval = get_heliacal_day(tjd, dgeo, datm, dobs, ObjectName, helflag2, TypeEvent, &tday, serr); 
+    hel_memo_time(SE_HELSTAT_TIME_DAY, &t);
     if (retval != OK)
       goto swe_heliacal_err;
   /* 
@@ -3217,8 +3612,10 @@ static int32 heliacal_ut_vis_lim(double tjd_start, double *dgeo, double *datm, d
       if ((retval = find_conjunct_sun(tjd, ipl, helflag, TypeEvent, &tjd, serr)) == ERR)
 	goto swe_heliacal_err;
     }
+    hel_memo_time(SE_HELSTAT_TIME_CONJ, &t);
     tday = tjd;
     retval = get_acronychal_day(tjd, dgeo, datm, dobs, ObjectName, helflag2, TypeEvent, &tday, serr);
+    hel_memo_time(SE_HELSTAT_TIME_DAY, &t);
     if (retval != OK)
       goto swe_heliacal_err;
   }
@@ -3230,6 +3627,7 @@ static int32 heliacal_ut_vis_lim(double tjd_start, double *dgeo, double *datm, d
      */
     if (ipl == SE_MERCURY || ipl == SE_VENUS || TypeEvent <= 2) {
       retval = get_heliacal_details(tday, dgeo, datm, dobs, ObjectName, TypeEvent, helflag2, dret, serr);
+      hel_memo_time(SE_HELSTAT_TIME_DETAILS, &t);
       if (retval == ERR) goto swe_heliacal_err;
     } else if ((0)) {
       if (TypeEvent == 4 || TypeEvent == 6) direct = -1;
@@ -3257,6 +3655,7 @@ static int32 moon_event_vis_lim(double tjdstart, double *dgeo, double *datm, dou
   char ObjectName[30];
   int32 iflag, ipl, retval, helflag2, direct;
   int32 epheflag = helflag & (SEFLG_JPLEPH|SEFLG_SWIEPH|SEFLG_MOSEPH);
+  double t = hel_clock();
   dret[0] = tjdstart; /* will be returned in error case */
   if (TypeEvent == 1 || TypeEvent == 2) {
     if (serr_ret != NULL)
@@ -3275,8 +3674,10 @@ static int32 moon_event_vis_lim(double tjdstart, double *dgeo, double *datm, dou
                          * but may return an event before start date */
   if ((retval = find_conjunct_sun(tjd, ipl, helflag, TypeEvent, &tjd, serr)) == ERR)
     return ERR;
+  hel_memo_time(SE_HELSTAT_TIME_CONJ, &t);
   /* find the day and minute on which the object becomes visible */
   retval = get_heliacal_day(tjd, dgeo, datm, dobs, ObjectName, helflag2, TypeEvent, &tjd, serr); 
+  hel_memo_time(SE_HELSTAT_TIME_DAY, &t);
   if (retval != OK)
     goto moon_event_err;
   dret[0] = tjd;
@@ -3326,6 +3727,7 @@ static int32 moon_event_vis_lim(double tjdstart, double *dgeo, double *datm, dou
     dret[0] = dret[2];
     dret[2] = tjd;
   }
+  hel_memo_time(SE_HELSTAT_TIME_DETAILS, &t);
 moon_event_err:
   if (serr_ret != NULL && *serr != '\0')
     strcpy(serr_ret, serr);
@@ -3390,7 +3792,7 @@ static int32 heliacal_ut(double JDNDaysUTStart, double *dgeo, double *datm, doub
 '                   dret[2]: end of visibility (Julian day number; 0 if SE_HELFLAG_AV)
 ' see http://www.iol.ie/~geniet/eng/atmoastroextinction.htm
 */
-int32 CALL_CONV swe_heliacal_ut(double JDNDaysUTStart, double *dgeo, double *datm, double *dobs, char *ObjectNameIn, int32 TypeEvent, int32 helflag, double *dret, char *serr_ret)
+static int32 heliacal_search(double JDNDaysUTStart, double *dgeo, double *datm, double *dobs, char *ObjectNameIn, int32 TypeEvent, int32 helflag, double *dret, char *serr_ret)
 {
   int32 retval, Planet, itry;
   char ObjectName[AS_MAXCH], serr[AS_MAXCH], s[AS_MAXCH];
@@ -3520,3 +3922,111 @@ int32 CALL_CONV swe_heliacal_ut(double JDNDaysUTStart, double *dgeo, double *dat
     strcpy(serr_ret, serr);
   return retval;
 }
+
+int32 CALL_CONV swe_heliacal_ut(double JDNDaysUTStart, double *dgeo, double *datm, double *dobs, char *ObjectNameIn, int32 TypeEvent, int32 helflag, double *dret, char *serr_ret)
+{
+  int32 retval;
+  hel_memo_begin();
+  retval = heliacal_search(JDNDaysUTStart, dgeo, datm, dobs, ObjectNameIn, TypeEvent, helflag, dret, serr_ret);
+  hel_memo_end();
+  return retval;
+}
+
+/* 
+ * TRUE if the event TypeEvent exists for Planet, see the checks
+ * in heliacal_search()
+ */
+static AS_BOOL heliacal_event_exists(int32 Planet, int32 TypeEvent, int32 helflag)
+{
+  if (Planet == SE_SUN)
+    return FALSE;
+  if (Planet == SE_MOON)
+    return (TypeEvent >= 3);
+  if (Planet == -1 || Planet >= SE_MARS) {
+    if (helflag & SE_HELFLAG_AVKIND)
+      return TRUE;
+    if (TypeEvent == 3 || TypeEvent == 4)
+      return FALSE;
+  }
+  if (!(helflag & SE_HELFLAG_AVKIND)) {
+    if (TypeEvent == SE_ACRONYCHAL_RISING || TypeEvent == SE_ACRONYCHAL_SETTING)
+      return FALSE;
+  }
+  return TRUE;
+}
+
+static int heliacal_range_cmp(const void *a, const void *b)
+{
+  const double *x = (const double *) a, *y = (const double *) b;
+  if (x[2] != y[2])
+    return (x[2] < y[2]) ? -1 : 1;
+  if (x[0] != y[0])
+    return (x[0] < y[0]) ? -1 : 1;
+  return (x[1] < y[1]) ? -1 : (x[1] > y[1]);
+}
+
+/* 
+ * Heliacal events of several objects between tjd_start and tjd_end, 
+ * e.g. for an annual calendar of first and last visibility.
+ * ObjectNames holds nobj names of AS_MAXCH chars each, TypeEvents the 
+ * ntypes event types wanted for every object; types that do not exist 
+ * for an object (e.g. evening first of Mars) are skipped.
+ * All searches share the memory of the sub-computations (risings and 
+ * settings of the sun, positions of sun and moon, etc.).
+ * For each event, 5 doubles are written to dret, sorted by time:
+ *   object index, event type, and dret[0..2] of swe_heliacal_ut().
+ * At most nret events are written; the number of events found is 
+ * returned, or ERR. If it is greater than nret, dret is too small and
+ * holds the events of the first objects only; call again with a dret
+ * of that size.
+ */
+int32 CALL_CONV swe_heliacal_range(double tjd_start, double tjd_end, double *dgeo, double *datm, double *dobs, char *ObjectNames, int32 nobj, int32 *TypeEvents, int32 ntypes, int32 helflag, double *dret, int32 nret, char *serr)
+{
+  int32 iobj, ityp, retval, nev = 0;
+  double tjd, darr[50];
+  char ObjectName[AS_MAXCH], serr2[AS_MAXCH];
+  if (serr != NULL)
+    *serr = '\0';
+  if (!(tjd_end >= tjd_start)) {
+    if (serr != NULL)
+      strcpy(serr, "swe_heliacal_range: tjd_end is before tjd_start");
+    return ERR;
+  }
+  /* the whole range is searched */
+  helflag &= ~SE_HELFLAG_SEARCH_1_PERIOD;
+  hel_memo_begin();
+  for (iobj = 0; iobj < nobj; iobj++) {
+    for (ityp = 0; ityp < ntypes; ityp++) {
+      strcpy_VBsafe(ObjectName, ObjectNames + (size_t) iobj * AS_MAXCH);
+      tolower_string_star(ObjectName);
+      if (!heliacal_event_exists(DeterObject(ObjectName), TypeEvents[ityp], helflag))
+	continue;
+      for (tjd = tjd_start; tjd < tjd_end; tjd = darr[0] + 1) {
+	*serr2 = '\0';
+	retval = heliacal_search(tjd, dgeo, datm, dobs, ObjectName, TypeEvents[ityp], helflag, darr, serr2);
+	/* no event within MAX_COUNT_SYNPER synodic periods, e.g. Mercury */
+	if (retval == ERR && strncmp(serr2, "no heliacal date found", 22) == 0)
+	  break;
+	if (retval == ERR) {
+	  if (serr != NULL)
+	    strcpy(serr, serr2);
+	  hel_memo_end();
+	  return ERR;
+	}
+	if (retval == -2 || darr[0] >= tjd_end)
+	  break;
+	if (nev < nret) {
+	  dret[nev * 5] = iobj;
+	  dret[nev * 5 + 1] = TypeEvents[ityp];
+	  dret[nev * 5 + 2] = darr[0];
+	  dret[nev * 5 + 3] = darr[1];
+	  dret[nev * 5 + 4] = darr[2];
+	}
+	nev++;
+      }
+    }
+  }
+  hel_memo_end();
+  qsort(dret, (size_t) (nev < nret ? nev : nret), 5 * sizeof(double), heliacal_range_cmp);
+  return nev;
+}
@@ -73,7 +73,9 @@
 /* #define KGAUSS_GEO 0.00002999502129737  Earth + Moon */
 
 static void embofs_mosh(double J, double *xemb);
-static int check_t_terms(double t, char *sinp, double *doutp);
+struct fict_terms;
+static void parse_t_terms(char *sinp, struct fict_terms *ft);
+static double eval_t_terms(double t, struct fict_terms *ft);
 
 static int read_elements_file(int32 ipl, double tjd, 
   double *tjd0, double *tequ, 
@@ -689,7 +691,150 @@ int swi_osc_el_plan(double tjd, double *xp, int ipl, int ipli, double *xearth, d
   return OK;
 }
 
-#if 1
+/* 
+ * The elements file is parsed once per thread into the table fict and 
+ * kept until the ephemeris path is changed or swe_close() is called 
+ * (swi_close_fict_elements()). T terms are kept as lists of factors 
+ * and powers of T, so that they need not be parsed again with every call.
+ */
+#define FICT_MAXTERMS 20
+
+struct fict_terms {
+  int nterms;
+  double fac[FICT_MAXTERMS];	/* factor of term */
+  int tpow[FICT_MAXTERMS];	/* power of T of term */
+  AS_BOOL has_terms;		/* expression contains '+' or '-' */
+};
+
+struct fict_elem {
+  int iline;			/* line in file */
+  double tjd0;			/* epoch */
+  double tequ;			/* equinox */
+  AS_BOOL tequ_is_jdate;	/* equinox of date */
+  struct fict_terms mano, sema, ecce, parg, node, incl;
+  char pname[AS_MAXCH];
+  int32 fict_ifl;
+  AS_BOOL epoch_invalid;
+  AS_BOOL equinox_invalid;
+};
+
+static TLS struct {
+  AS_BOOL is_loaded;
+  AS_BOOL file_found;
+  char serr_open[AS_MAXCH];	/* message if file was not found */
+  int nelem;
+  struct fict_elem *elem;
+  int err_line;			/* line with less than nine elements, 0 if none */
+  int last_line;		/* last line read */
+} fict;
+
+void swi_close_fict_elements(void)
+{
+  if (fict.elem != NULL)
+    free(fict.elem);
+  memset((void *) &fict, 0, sizeof(fict));
+}
+
+/* epoch or equinox: j2000, b1950, j1900 or julian day number */
+static int parse_epoch(char *sp, double *tjd)
+{
+  int i;
+  for (i = 0; i < 5 && sp[i] != '\0'; i++)
+    sp[i] = tolower(sp[i]);
+  if (strncmp(sp, "j2000", 5) == OK)
+    *tjd = J2000;
+  else if (strncmp(sp, "b1950", 5) == OK)
+    *tjd = B1950;
+  else if (strncmp(sp, "j1900", 5) == OK)
+    *tjd = J1900;
+  else if (*sp == 'j' || *sp == 'b')
+    return ERR;
+  else
+    *tjd = atof(sp);
+  return OK;
+}
+
+static void parse_elements_line(struct fict_elem *fe, char **cpos, int ncpos)
+{
+  char *sp;
+  /* epoch of elements */
+  fe->epoch_invalid = (parse_epoch(cpos[0], &fe->tjd0) == ERR);
+  /* equinox */
+  sp = cpos[1];
+  while(*sp == ' ' || *sp == '\t')
+    sp++;
+  if (parse_epoch(sp, &fe->tequ) == ERR) {
+    if (strncmp(sp, "jdate", 5) == OK)
+      fe->tequ_is_jdate = TRUE;
+    else
+      fe->equinox_invalid = TRUE;
+  }
+  parse_t_terms(cpos[2], &fe->mano);
+  parse_t_terms(cpos[3], &fe->sema);
+  parse_t_terms(cpos[4], &fe->ecce);
+  parse_t_terms(cpos[5], &fe->parg);
+  parse_t_terms(cpos[6], &fe->node);
+  parse_t_terms(cpos[7], &fe->incl);
+  /* planet name */
+  sp = cpos[8];
+  while(*sp == ' ' || *sp == '\t')
+    sp++;
+  swi_right_trim(sp);
+  strncpy(fe->pname, sp, AS_MAXCH - 1);
+  /* geocentric */
+  if (ncpos > 9) {
+    for (sp = cpos[9]; *sp != '\0'; sp++)
+      *sp = tolower(*sp);
+    if (strstr(cpos[9], "geo") != NULL)
+      fe->fict_ifl |= FICT_GEO;
+  }
+}
+
+static void load_elements_file(void)
+{
+  int iline;
+  int ncpos;
+  FILE *fp;
+  char s[AS_MAXCH], *sp;
+  char *cpos[20];
+  struct fict_elem *elem;
+  swi_close_fict_elements();
+  fict.is_loaded = TRUE;
+  /* -1, because file information is not saved, file is always closed */
+  if ((fp = swi_fopen(-1, SE_FICTFILE, swed.ephepath, fict.serr_open)) == NULL)
+    return;
+  fict.file_found = TRUE;
+  iline = 0;
+  while (fgets(s, AS_MAXCH, fp) != NULL) {
+    iline++;
+    sp = s;
+    while(*sp == ' ' || *sp == '\t')
+      sp++;
+    swi_strcpy(s, sp);
+    if (*s == '#' || *s == '\r' || *s == '\n' || *s == '\0')
+      continue;
+    if ((sp = strchr(s, '#')) != NULL)
+      *sp = '\0';
+    ncpos = swi_cutstr(s, ",", cpos, 20);
+    fict.last_line = iline;
+    if (ncpos < 9) {
+      fict.err_line = iline;
+      break;
+    }
+    if (fict.nelem % 16 == 0) {
+      elem = (struct fict_elem *) realloc(fict.elem, (fict.nelem + 16) * sizeof(struct fict_elem));
+      if (elem == NULL)
+        break;
+      fict.elem = elem;
+    }
+    memset((void *) &fict.elem[fict.nelem], 0, sizeof(struct fict_elem));
+    fict.elem[fict.nelem].iline = iline;
+    parse_elements_line(&fict.elem[fict.nelem], cpos, ncpos);
+    fict.nelem++;
+  }
+  fclose(fp);
+}
+
 /* note: input parameter tjd is required for T terms in elements */
 static int read_elements_file(int32 ipl, double tjd, 
   double *tjd0, double *tequ, 
@@ -697,15 +842,15 @@ static int read_elements_file(int32 ipl, double tjd,
   double *parg, double *node, double *incl,
   char *pname, int32 *fict_ifl, char *serr)
 {
-  int i, iline, iplan, retc, ncpos;
-  FILE *fp = NULL;
-  char s[AS_MAXCH], *sp;
-  char *cpos[20], serri[AS_MAXCH];
-  AS_BOOL elem_found = FALSE;
+  struct fict_elem *fe;
+  char serri[AS_MAXCH];
   double tt = 0;
-  /* -1, because file information is not saved, file is always closed */
-  if ((fp = swi_fopen(-1, SE_FICTFILE, swed.ephepath, serr)) == NULL) {
+  if (!fict.is_loaded)
+    load_elements_file();
+  if (!fict.file_found) {
     /* file does not exist, use built-in bodies */
+    if (serr != NULL)
+      strcpy(serr, fict.serr_open);
     if (ipl >= SE_NFICT_ELEM) {
       if (serr != NULL)
         sprintf(serr, "error no elements for fictitious body no %7.0f", (double) ipl);
@@ -732,236 +877,164 @@ static int read_elements_file(int32 ipl, double tjd,
     return OK;
   }
   /* 
-   * find elements in file 
+   * find elements in table 
    */
-  iline = 0;
-  iplan = -1;
-  while (fgets(s, AS_MAXCH, fp) != NULL) {
-    iline++;
-    sp = s;
-    while(*sp == ' ' || *sp == '\t')
-      sp++;
-    swi_strcpy(s, sp);
-    if (*s == '#')
-      continue;
-    if (*s == '\r')
-      continue;
-    if (*s == '\n')
-      continue;
-    if (*s == '\0')
-      continue;
-    if ((sp = strchr(s, '#')) != NULL)
-      *sp = '\0';
-    ncpos = swi_cutstr(s, ",", cpos, 20);
-    sprintf(serri, "error in file %s, line %7.0f:", SE_FICTFILE, (double) iline);
-    if (ncpos < 9) {
-      if (serr != NULL) {
-        sprintf(serr, "%s nine elements required", serri);
-      }
-      goto return_err;
-    }
-    iplan++;
-    if (iplan != ipl)
-      continue;
-    elem_found = TRUE;
-    /* epoch of elements */
-    if (tjd0 != NULL) {
-      sp = cpos[0];
-	  for (i = 0; i < 5; i++)
-       sp[i] = tolower(sp[i]);
-      if (strncmp(sp, "j2000", 5) == OK)
-        *tjd0 = J2000;
-      else if (strncmp(sp, "b1950", 5) == OK)
-        *tjd0 = B1950;
-      else if (strncmp(sp, "j1900", 5) == OK)
-        *tjd0 = J1900;
-      else if (*sp == 'j' || *sp == 'b') {
-        if (serr != NULL) {
-          sprintf(serr, "%s invalid epoch", serri);
-	}
-        goto return_err;
-      } else
-        *tjd0 = atof(sp);
-      tt = tjd - *tjd0;
-    }
-    /* equinox */
-    if (tequ != NULL) {
-      sp = cpos[1];
-      while(*sp == ' ' || *sp == '\t')
-        sp++;
-	  for (i = 0; i < 5; i++)
-       sp[i] = tolower(sp[i]);
-      if (strncmp(sp, "j2000", 5) == OK)
-        *tequ = J2000;
-      else if (strncmp(sp, "b1950", 5) == OK)
-        *tequ = B1950;
-      else if (strncmp(sp, "j1900", 5) == OK)
-        *tequ = J1900;
-      else if (strncmp(sp, "jdate", 5) == OK)
-        *tequ = tjd;
-      else if (*sp == 'j' || *sp == 'b') {
-        if (serr != NULL) {
-          sprintf(serr, "%s invalid equinox", serri);
-	}
-        goto return_err;
-      } else
-        *tequ = atof(sp);
-    }
-    /* mean anomaly t0 */
-    if (mano != NULL) {
-      retc = check_t_terms(tt, cpos[2], mano);
-	  *mano = swe_degnorm(*mano);
-      if (retc == ERR) {
-        if (serr != NULL) {
-          sprintf(serr, "%s mean anomaly value invalid", serri);
-	}
-        goto return_err;
-      }
-      /* if mean anomaly has t terms (which happens with fictitious 
-       * planet Vulcan), we set
-       * epoch = tjd, so that no motion will be added anymore 
-       * equinox = tjd */
-      if (retc == 1) {
-	*tjd0 = tjd;
-      }
-      *mano *= DEGTORAD;
-    }
-    /* semi-axis */
-    if (sema != NULL) {
-      retc = check_t_terms(tt, cpos[3], sema);
-      if (*sema <= 0 || retc == ERR) {
-        if (serr != NULL) {
-          sprintf(serr, "%s semi-axis value invalid", serri);
-	}
-        goto return_err;
-      }
+  if (ipl < 0 || ipl >= fict.nelem) {
+    if (serr != NULL) {
+      if (fict.err_line > 0)
+        sprintf(serr, "error in file %s, line %7.0f: nine elements required", SE_FICTFILE, (double) fict.err_line);
+      else
+        sprintf(serr, "error in file %s, line %7.0f: elements for planet %7.0f not found", SE_FICTFILE, (double) fict.last_line, (double) ipl);
     }
-    /* eccentricity */
-    if (ecce != NULL) {
-      retc = check_t_terms(tt, cpos[4], ecce);
-      if (*ecce >= 1 || *ecce < 0 || retc == ERR) {
-        if (serr != NULL) {
-          sprintf(serr, "%s eccentricity invalid (no parabolic or hyperbolic orbits allowed)", serri);
-	}
-        goto return_err;
-      }
+    return ERR;
+  }
+  fe = &fict.elem[ipl];
+  sprintf(serri, "error in file %s, line %7.0f:", SE_FICTFILE, (double) fe->iline);
+  /* epoch of elements */
+  if (tjd0 != NULL) {
+    if (fe->epoch_invalid) {
+      if (serr != NULL)
+        sprintf(serr, "%s invalid epoch", serri);
+      return ERR;
     }
-    /* perihelion argument */
-    if (parg != NULL) {
-      retc = check_t_terms(tt, cpos[5], parg);
-	  *parg = swe_degnorm(*parg);
-      if (retc == ERR) {
-        if (serr != NULL) {
-          sprintf(serr, "%s perihelion argument value invalid", serri);
-	}
-        goto return_err;
-      }
-      *parg *= DEGTORAD;
+    *tjd0 = fe->tjd0;
+    tt = tjd - *tjd0;
+  }
+  /* equinox */
+  if (tequ != NULL) {
+    if (fe->equinox_invalid) {
+      if (serr != NULL)
+        sprintf(serr, "%s invalid equinox", serri);
+      return ERR;
     }
-    /* node */
-    if (node != NULL) {
-      retc = check_t_terms(tt, cpos[6], node);
-	  *node = swe_degnorm(*node);
-      if (retc == ERR) {
-        if (serr != NULL) {
-          sprintf(serr, "%s node value invalid", serri);
-	}
-        goto return_err;
-      }
-      *node *= DEGTORAD;
+    if (fe->tequ_is_jdate)
+      *tequ = tjd;
+    else
+      *tequ = fe->tequ;
+  }
+  /* mean anomaly t0 */
+  if (mano != NULL) {
+    *mano = swe_degnorm(eval_t_terms(tt, &fe->mano));
+    /* if mean anomaly has t terms (which happens with fictitious 
+     * planet Vulcan), we set
+     * epoch = tjd, so that no motion will be added anymore 
+     * equinox = tjd */
+    if (fe->mano.has_terms && tjd0 != NULL) {
+      *tjd0 = tjd;
     }
-    /* inclination */
-    if (incl != NULL) {
-      retc = check_t_terms(tt, cpos[7], incl);
-	  *incl = swe_degnorm(*incl);
-      if (retc == ERR) {
-        if (serr != NULL) {
-          sprintf(serr, "%s inclination value invalid", serri);
-	}
-        goto return_err;
+    *mano *= DEGTORAD;
+  }
+  /* semi-axis */
+  if (sema != NULL) {
+    *sema = eval_t_terms(tt, &fe->sema);
+    if (*sema <= 0) {
+      if (serr != NULL) {
+        sprintf(serr, "%s semi-axis value invalid", serri);
       }
-      *incl *= DEGTORAD;
-    }
-    /* planet name */
-    if (pname != NULL) {
-      sp = cpos[8];
-      while(*sp == ' ' || *sp == '\t')
-        sp++;
-      swi_right_trim(sp);
-      strcpy(pname, sp);
-    }
-    /* geocentric */
-    if (fict_ifl != NULL && ncpos > 9) {
-      for (sp = cpos[9]; *sp != '\0'; sp++)
-        *sp = tolower(*sp);
-      if (strstr(cpos[9], "geo") != NULL)
-        *fict_ifl |= FICT_GEO;
+      return ERR;
     }
-    break;
   }
-  if (!elem_found) {
-    if (serr != NULL) {
-      sprintf(serr, "%s elements for planet %7.0f not found", serri, (double) ipl);
+  /* eccentricity */
+  if (ecce != NULL) {
+    *ecce = eval_t_terms(tt, &fe->ecce);
+    if (*ecce >= 1 || *ecce < 0) {
+      if (serr != NULL) {
+        sprintf(serr, "%s eccentricity invalid (no parabolic or hyperbolic orbits allowed)", serri);
+      }
+      return ERR;
     }
-    goto return_err;
   }
-  fclose(fp);
+  /* perihelion argument */
+  if (parg != NULL)
+    *parg = swe_degnorm(eval_t_terms(tt, &fe->parg)) * DEGTORAD;
+  /* node */
+  if (node != NULL)
+    *node = swe_degnorm(eval_t_terms(tt, &fe->node)) * DEGTORAD;
+  /* inclination */
+  if (incl != NULL)
+    *incl = swe_degnorm(eval_t_terms(tt, &fe->incl)) * DEGTORAD;
+  /* planet name */
+  if (pname != NULL)
+    strcpy(pname, fe->pname);
+  /* geocentric */
+  if (fict_ifl != NULL)
+    *fict_ifl |= fe->fict_ifl;
   return OK;
-return_err:
-  fclose(fp);
-  return ERR;
 }
-#endif
 
-static int check_t_terms(double t, char *sinp, double *doutp)
+/* parses an element with T terms, e.g. "252.8987988 + 707550.7341 * T",
+ * into a list of terms. T, T1 .. T4 are powers of T = t / 36525. */
+static void parse_t_terms(char *sinp, struct fict_terms *ft)
 {
-  int i, isgn = 1, z;
-  int retc = 0;
+  int i, isgn = 1, z, tpow;
   char *sp;
-  double tt[5], fac;
-  tt[0] = t / 36525;
-  tt[1] = tt[0];
-  tt[2] = tt[1] * tt[1];
-  tt[3] = tt[2] * tt[1];
-  tt[4] = tt[3] * tt[1];
-  if ((sp = strpbrk(sinp, "+-")) != NULL)
-    retc = 1; /* with additional terms */
+  double fac;
+  ft->nterms = 0;
+  ft->has_terms = (strpbrk(sinp, "+-") != NULL); /* with additional terms */
   sp = sinp;
-  *doutp = 0;
   fac = 1;
+  tpow = 0;
   z = 0;
   while (1) {
     while(*sp != '\0' && strchr(" \t", *sp) != NULL)
       sp++;
     if (strchr("+-", *sp) || *sp == '\0') {
-	  if (z > 0)
-		*doutp += fac;
-	  isgn = 1;
-	  if (*sp == '-')
-	    isgn = -1;
-	  fac = 1 * isgn;
-	  if (*sp == '\0')
-		return retc;
-	  sp++;
-	} else {
+      if (z > 0 && ft->nterms < FICT_MAXTERMS) {
+        ft->fac[ft->nterms] = fac;
+        ft->tpow[ft->nterms] = tpow;
+        ft->nterms++;
+      }
+      isgn = 1;
+      if (*sp == '-')
+        isgn = -1;
+      fac = 1 * isgn;
+      tpow = 0;
+      if (*sp == '\0')
+        return;
+      sp++;
+    } else {
       while(*sp != '\0' && strchr("* \t", *sp) != NULL)
         sp++;
       if (*sp != '\0' && strchr("tT", *sp) != NULL) {
-		/* a T */
+        /* a T */
         sp++;
         if (*sp != '\0' && strchr("+-", *sp))
-		  fac *= tt[0];
-	    else if ((i = atoi(sp)) <= 4 && i >= 0)
-          fac *= tt[i];
-	  } else {
+          tpow += 1;
+        else if ((i = atoi(sp)) <= 4 && i >= 0)
+          tpow += (i == 0) ? 1 : i;
+      } else if (*sp != '\0' && strchr("0123456789.", *sp) == NULL) {
+        sp++;	/* skip invalid character */
+      } else {
         /* a number */
         if (atof(sp) != 0 || *sp == '0')
           fac *= atof(sp);
-	  }
+      }
       while (*sp != '\0' && strchr("0123456789.", *sp))
-	    sp++;
-	}
-	z++;
+        sp++;
+    }
+    z++;
+  }
+}
+
+static double eval_t_terms(double t, struct fict_terms *ft)
+{
+  int i, j;
+  double tt[5], fac, dout = 0;
+  tt[0] = t / 36525;
+  tt[1] = tt[0];
+  tt[2] = tt[1] * tt[1];
+  tt[3] = tt[2] * tt[1];
+  tt[4] = tt[3] * tt[1];
+  for (i = 0; i < ft->nterms; i++) {
+    fac = ft->fac[i];
+    if (ft->tpow[i] <= 4) {
+      if (ft->tpow[i] > 0)
+        fac *= tt[ft->tpow[i]];
+    } else {
+      for (j = 0; j < ft->tpow[i]; j++)
+        fac *= tt[1];
+    }
+    dout += fac;
   }
-  return retc;	/* there have been additional terms */
+  return dout;
 }
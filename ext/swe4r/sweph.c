@@ -207,6 +207,8 @@ static int app_pos_etc_plan(int ipli, int iplmoon, int32 iflag, char *serr);
 static int app_pos_etc_plan_osc(int ipl, int ipli, int32 iflag, char *serr);
 static int app_pos_etc_sun(int32 iflag, char *serr);
 static int app_pos_etc_moon(int32 iflag, char *serr);
+static void observer_at_light_time(double dt, double *xobs2);
+static void aberr_light_speed(double *xx, double *dv);
 static int app_pos_etc_sbar(int32 iflag, char *serr);
 extern int swi_plan_for_osc_elem(int32 iflag, double tjd, double *xx);
 static void swi_close_keep_topo_etc(void); 
@@ -223,6 +225,15 @@ static int app_pos_rest(struct plan_data *pdp, int32 iflag,
     double *xx, double *x2000, struct epsilon *oe, char *serr);
 static int open_jpl_file(double *ss, char *fname, char *fpath, char *serr);
 static void free_planets(void);
+static void ast_pool_switch(int ipli);
+static void ast_pool_close(void);
+static void calc_cache_clear(void);
+static struct save_positions *calc_cache_find(double tjd, int ipl, int iplmoon, int32 iflag);
+static void calc_cache_store(struct save_positions *sdnew);
+static void force_app_pos(void);
+static void astnam_close(void);
+static void set_ephe_path(const char *path, AS_BOOL keep_file_caches);
+static void close_ephe(AS_BOOL keep_file_caches);
 
 #ifdef TRACE
 static void trace_swe_calc(int param, double tjd, int ipl, int32 iflag, double *xx, char *serr);
@@ -313,7 +324,7 @@ int32 CALL_CONV swe_calc(double tjd, int ipl, int32 iflag,
   int32 iplmoon = 0, iflgsave = iflag;
   int32 epheflag;
   AS_BOOL use_speed3 = FALSE;
-  struct save_positions *sd;
+  struct save_positions *sd, sdnew;
   double x[6], *xs, x0[24], x2[24];
   double dt;
   if (serr != NULL) 
@@ -404,10 +415,10 @@ int32 CALL_CONV swe_calc(double tjd, int ipl, int32 iflag,
     iflag = iflag & ~SEFLG_SPEED3;
   if (iflag & SEFLG_SPEED3) 
     use_speed3 = TRUE;
-  /* topocentric with SEFLG_SPEED is not good if aberration is included. 
-   * in such cases we calculate speed from three positions */
-  if ((iflag & SEFLG_SPEED) && (iflag & SEFLG_TOPOCTR) && !(iflag & SEFLG_NOABERR)) 
-    use_speed3 = TRUE;
+  /* topocentric with SEFLG_SPEED used to be computed from three positions
+   * if aberration was included. the change of the observer's speed during 
+   * light-time is now taken into account in app_pos_etc_*(), see 
+   * observer_at_light_time(), so one evaluation is sufficient. */
   /* cartesian flag excludes radians flag */
   if ((iflag & SEFLG_XYZ) && (iflag & SEFLG_RADIANS))
     iflag = iflag & ~SEFLG_RADIANS;
@@ -433,40 +444,34 @@ int32 CALL_CONV swe_calc(double tjd, int ipl, int32 iflag,
     iplmoon = 0;
     iflag &= ~SEFLG_CENTER_BODY;
   }
+  /* the results of the planet and of its moons or center of body
+   * are cached separately, but light-time etc. must be recomputed */
   if ((iflag & SEFLG_CENTER_BODY) || iplmoon > 0)
-    swi_force_app_pos_etc();
-  /* pointer to save area */
-  if (ipl < SE_NPLANETS && ipl >= SE_SUN) {
-    sd = &swed.savedat[ipl];
-//    if (iflag & SEFLG_CENTER_BODY)
-//      sd = &swed.savedat[SE_NPLANETS];
-  } else {
-    /* other bodies, e.g. asteroids called with ipl = SE_AST_OFFSET + MPC# */
-    sd = &swed.savedat[SE_NPLANETS];
-  }
+    force_app_pos();
   /* 
    * if position is available in save area, it is returned.
-   * this is the case, if tjd = tsave and iflag = iflgsave.
-   * coordinate flags can be neglected, because save area 
-   * provides all coordinate types.
-   * if ipl > SE_AST(EROID)_OFFSET, ipl must be checked, 
-   * because all asteroids called by MPC number share the same
-   * save area.
+   * this is the case, if tjd, ipl, iplmoon and iflag are the same 
+   * as with a previous call. coordinate flags can be neglected, 
+   * because save area provides all coordinate types.
+   * SE_ECL_NUT is not cached, because callers rely on its side 
+   * effect of computing obliquity and nutation in swed.
    */ 
-  if (sd->tsave == tjd && tjd != 0 && ipl == sd->ipl && iplmoon == 0) {
-    if ((sd->iflgsave & ~SEFLG_COORDSYS) == (iflag & ~SEFLG_COORDSYS)) 
-      goto end_swe_calc;
-  }
+  if (ipl != SE_ECL_NUT 
+    && (sd = calc_cache_find(tjd, ipl, iplmoon, iflag)) != NULL)
+    goto end_swe_calc;
   /* 
    * otherwise, new position must be computed 
    */
+  sd = &sdnew;
+  sd->tsave = tjd;
+  sd->ipl = ipl;
+  sd->iplmoon = iplmoon;
+  sd->iflag = iflag & ~SEFLG_COORDSYS;
   if (!use_speed3) {
     /* 
      * with high precision speed from one call of swecalc() 
      * (FAST speed)
      */
-    sd->tsave = tjd;
-    sd->ipl = ipl;
     if ((sd->iflgsave = swecalc(tjd, ipl, iplmoon, iflag, sd->xsaves, serr)) == ERR) 
       goto return_error;
   } else {
@@ -474,8 +479,6 @@ int32 CALL_CONV swe_calc(double tjd, int ipl, int32 iflag,
      * with speed from three calls of swecalc(), slower and less accurate.
      * (SLOW speed, for test only)
      */
-    sd->tsave = tjd;
-    sd->ipl = ipl;
     switch(ipl) {
       case SE_MOON:
 	dt = MOON_SPEED_INTV;
@@ -503,6 +506,10 @@ int32 CALL_CONV swe_calc(double tjd, int ipl, int32 iflag,
     denormalize_positions(x0, sd->xsaves, x2);
     calc_speed(x0, sd->xsaves, x2, dt);
   }
+  /* results from another ephemeris than the one requested, e.g. 
+   * Moshier if files are missing, are not kept */
+  if (ipl != SE_ECL_NUT && (sd->iflgsave & SEFLG_EPHMASK) == epheflag)
+    calc_cache_store(sd);
   end_swe_calc:
   if (iflag & SEFLG_EQUATORIAL) {
     xs = sd->xsaves+12;	/* equatorial coordinates */
@@ -1155,9 +1162,206 @@ static int32 swecalc(double tjd, int ipl, int32 iplmoon, int32 iflag, double *x,
   return ERR;
 }
 
+/* Puts the current body of fidat[SEI_FILE_ANY_AST] and pldat[SEI_ANYBODY]
+ * into the asteroid pool and takes body ipli from the pool, if it is there.
+ * Otherwise the slots are left without open file, as after fclose().
+ * If the pool is full, the least recently used entry is closed. */
+static void ast_pool_switch(int ipli)
+{
+  int i, inew = -1;
+  struct file_data *fdp = &swed.fidat[SEI_FILE_ANY_AST];
+  struct plan_data *pdp = &swed.pldat[SEI_ANYBODY];
+  struct ast_pool_entry *pe;
+  if (fdp->fptr != NULL && swed.astpool == NULL)
+    swed.astpool = (struct ast_pool_entry *) calloc(SEI_NAST_POOL, sizeof(struct ast_pool_entry));
+  if (fdp->fptr != NULL && swed.astpool == NULL) {
+    /* no pool, close the file */
+    fclose(fdp->fptr);
+    fdp->fptr = NULL;
+  }
+  if (fdp->fptr != NULL) {
+    for (i = 0; i < SEI_NAST_POOL; i++) {
+      pe = &swed.astpool[i];
+      if (pe->fd.fptr == NULL) {
+	inew = i;
+	break;
+      }
+      if (inew < 0 || pe->last_use < swed.astpool[inew].last_use)
+	inew = i;
+    }
+    pe = &swed.astpool[inew];
+    if (pe->fd.fptr != NULL) {
+      fclose(pe->fd.fptr);
+      if (pe->pd.refep != NULL)
+	free((void *) pe->pd.refep);
+      if (pe->pd.segp != NULL)
+	free((void *) pe->pd.segp);
+    }
+    pe->fd = *fdp;
+    pe->pd = *pdp;
+    pe->last_use = ++swed.astpool_clock;
+    fdp->fptr = NULL;
+  } else {
+    if (pdp->refep != NULL) 
+      free((void *) pdp->refep);
+    if (pdp->segp != NULL)
+      free((void *) pdp->segp);
+  }
+  pdp->refep = NULL;
+  pdp->segp = NULL;
+  if (swed.astpool == NULL)
+    return;
+  for (i = 0; i < SEI_NAST_POOL; i++) {
+    pe = &swed.astpool[i];
+    if (pe->fd.fptr != NULL && pe->pd.ibdy == ipli) {
+      *fdp = pe->fd;
+      *pdp = pe->pd;
+      pdp->teval = 0;	/* saved position is not valid any more */
+      pdp->xflgs = -1;
+      memset((void *) pe, 0, sizeof(struct ast_pool_entry));
+      return;
+    }
+  }
+}
+
+static void ast_pool_close(void)
+{
+  int i;
+  struct ast_pool_entry *pe;
+  if (swed.astpool == NULL)
+    return;
+  for (i = 0; i < SEI_NAST_POOL; i++) {
+    pe = &swed.astpool[i];
+    if (pe->fd.fptr != NULL)
+      fclose(pe->fd.fptr);
+    if (pe->pd.refep != NULL)
+      free((void *) pe->pd.refep);
+    if (pe->pd.segp != NULL)
+      free((void *) pe->pd.segp);
+  }
+  free((void *) swed.astpool);
+  swed.astpool = NULL;
+  swed.astpool_clock = 0;
+}
+
+/* number of sets of the swe_calc() cache, 0 if it is switched off */
+static int32 calc_cache_nsets(void)
+{
+  if (swed.calc_cache_nsets < 0)
+    return 0;
+  if (swed.calc_cache_nsets == 0)
+    return SEI_CALC_CACHE_NSETS_DEFAULT;
+  return swed.calc_cache_nsets;
+}
+
+static int32 calc_cache_set(double tjd, int ipl, int iplmoon, int32 nsets)
+{
+  int i;
+  uint32 h;
+  unsigned char b[sizeof(double)];
+  memcpy(b, &tjd, sizeof(double));
+  h = (uint32) ipl * 2654435761u ^ (uint32) iplmoon;
+  for (i = 0; i < (int) sizeof(double); i++)
+    h = (h ^ b[i]) * 16777619u;
+  return (int32) (h & (uint32) (nsets - 1));
+}
+
+/* entries of the cache with nsets sets, NULL if they cannot be allocated */
+static struct save_positions *calc_cache_entries(int32 nsets)
+{
+  if (nsets <= SEI_CALC_CACHE_NSETS_DEFAULT)
+    return swed.savedat;
+  if (swed.savedat_large == NULL)
+    swed.savedat_large = (struct save_positions *) calloc((size_t) SEI_CALC_CACHE_NSETS * SEI_CALC_CACHE_WAYS, sizeof(struct save_positions));
+  return swed.savedat_large;
+}
+
+static void calc_cache_clear(void)
+{
+  int i;
+  for (i = 0; i < SEI_CALC_CACHE_NSETS_DEFAULT * SEI_CALC_CACHE_WAYS; i++)
+    swed.savedat[i].last_use = 0;
+  if (swed.savedat_large != NULL) {
+    for (i = 0; i < SEI_CALC_CACHE_NSETS * SEI_CALC_CACHE_WAYS; i++)
+      swed.savedat_large[i].last_use = 0;
+  }
+  swed.calc_cache_clock = 0;
+}
+
+/* returns the saved result of swe_calc() for tjd, ipl, iplmoon and 
+ * iflag (without coordinate system flags), or NULL */
+static struct save_positions *calc_cache_find(double tjd, int ipl, int iplmoon, int32 iflag)
+{
+  int i;
+  int32 nsets = calc_cache_nsets();
+  struct save_positions *sd;
+  if (nsets == 0 || (sd = calc_cache_entries(nsets)) == NULL)
+    return NULL;
+  swed.calc_cache_stats[0]++;
+  iflag &= ~SEFLG_COORDSYS;
+  sd += calc_cache_set(tjd, ipl, iplmoon, nsets) * SEI_CALC_CACHE_WAYS;
+  for (i = 0; i < SEI_CALC_CACHE_WAYS; i++, sd++) {
+    if (sd->last_use != 0 && sd->tsave == tjd && sd->ipl == ipl
+      && sd->iplmoon == iplmoon && sd->iflag == iflag) {
+      sd->last_use = ++swed.calc_cache_clock;
+      swed.calc_cache_stats[1]++;
+      return sd;
+    }
+  }
+  return NULL;
+}
+
+/* puts a result of swe_calc() into its set, replacing an entry with 
+ * the same key, a free entry or the least recently used one */
+static void calc_cache_store(struct save_positions *sdnew)
+{
+  int i;
+  int32 nsets = calc_cache_nsets();
+  struct save_positions *sd, *sdset;
+  if (nsets == 0 || (sdset = calc_cache_entries(nsets)) == NULL)
+    return;
+  sdset += calc_cache_set(sdnew->tsave, sdnew->ipl, sdnew->iplmoon, nsets) * SEI_CALC_CACHE_WAYS;
+  sd = sdset;
+  for (i = 0; i < SEI_CALC_CACHE_WAYS; i++) {
+    if (sdset[i].last_use == 0) {
+      sd = &sdset[i];
+      break;
+    }
+    if (sdset[i].tsave == sdnew->tsave && sdset[i].ipl == sdnew->ipl
+      && sdset[i].iplmoon == sdnew->iplmoon && sdset[i].iflag == sdnew->iflag) {
+      sd = &sdset[i];
+      break;
+    }
+    if (sdset[i].last_use < sd->last_use)
+      sd = &sdset[i];
+  }
+  *sd = *sdnew;
+  sd->last_use = ++swed.calc_cache_clock;
+}
+
+/* sets the number of results of swe_calc() kept by the calling thread.
+ * 0 switches the cache off, a negative value restores the default.
+ * The number is rounded up to a power of 2 times SEI_CALC_CACHE_WAYS. */
+void CALL_CONV swe_set_calc_cache(int32 nentries)
+{
+  int32 nsets = 1;
+  swi_init_swed_if_start();
+  if (nentries < 0) {
+    swed.calc_cache_nsets = 0;
+  } else if (nentries == 0) {
+    swed.calc_cache_nsets = -1;
+  } else {
+    while (nsets * SEI_CALC_CACHE_WAYS < nentries && nsets < SEI_CALC_CACHE_NSETS)
+      nsets *= 2;
+    swed.calc_cache_nsets = nsets;
+  }
+  calc_cache_clear();
+}
+
 static void free_planets(void)
 {
   int i;
+  ast_pool_close();
   /* free planets data space */
   for (i = 0; i < SEI_NPLANETS; i++) {
     if (swed.pldat[i].segp != NULL) {
@@ -1168,8 +1372,7 @@ static void free_planets(void)
     }
     memset((void *) &swed.pldat[i], 0, sizeof(struct plan_data));
   }
-  for (i = 0; i <= SE_NPLANETS; i++) /* "<=" is correct! see decl. */
-    memset((void *) &swed.savedat[i], 0, sizeof(struct save_positions));
+  calc_cache_clear();
   /* clear node data space */
   for (i = 0; i < SEI_NNODE_ETC; i++) {
     memset((void *) &swed.nddat[i], 0, sizeof(struct plan_data));
@@ -1205,6 +1408,11 @@ static void swi_close_keep_topo_etc(void)
     memset((void *) &swed.fidat[i], 0, sizeof(struct file_data));
   }
   free_planets();
+  swi_close_fict_elements();
+  swi_close_ecl_catalog();
+  swi_ecl_track_clear();
+  swi_prec_cache_clear();
+  swi_observer_cache_clear();
   memset((void *) &swed.oec, 0, sizeof(struct epsilon));
   memset((void *) &swed.oec2000, 0, sizeof(struct epsilon));
   memset((void *) &swed.nut, 0, sizeof(struct nut));
@@ -1231,6 +1439,13 @@ static void swi_close_keep_topo_etc(void)
  * deletes memory of all computed positions 
  */
 void CALL_CONV swe_close(void) 
+{
+  close_ephe(FALSE);
+}
+
+/* with keep_file_caches, the caches shared by all threads (path 
+ * lookups, seasnam.txt) are kept; this is for worker threads */
+static void close_ephe(AS_BOOL keep_file_caches)
 {
   int i;
   /* close SWISSEPH files */
@@ -1240,6 +1455,13 @@ void CALL_CONV swe_close(void)
     memset((void *) &swed.fidat[i], 0, sizeof(struct file_data));
   }
   free_planets();
+  swi_close_fict_elements();
+  swi_close_ecl_catalog();
+  swi_ecl_track_clear();
+  swi_prec_cache_clear();
+  swi_observer_cache_clear();
+  if (!keep_file_caches)
+    astnam_close();
   memset((void *) &swed.oec, 0, sizeof(struct epsilon));
   memset((void *) &swed.oec2000, 0, sizeof(struct epsilon));
   memset((void *) &swed.nut, 0, sizeof(struct nut));
@@ -1256,6 +1478,13 @@ void CALL_CONV swe_close(void)
     swed.fixfp = NULL;
   }
   swe_set_tid_acc(SE_TIDAL_AUTOMATIC);
+  swi_free_deltat_spline();
+  if (swed.savedat_large != NULL) {
+    free(swed.savedat_large);
+    swed.savedat_large = NULL;
+  }
+  swi_refrac_table_close();
+  swi_hel_memo_close();
   swed.geopos_is_set = FALSE;
   swed.ayana_is_set = FALSE;
   swed.is_old_starfile = FALSE;
@@ -1313,6 +1542,14 @@ void CALL_CONV swe_close(void)
  * ephemerides
  */
 void CALL_CONV swe_set_ephe_path(const char *path) 
+{
+  set_ephe_path(path, FALSE);
+}
+
+/* with keep_file_caches, the files already looked up are not searched
+ * for again and seasnam.txt is not read again; this is for worker 
+ * threads, which set the path of the calling thread */
+static void set_ephe_path(const char *path, AS_BOOL keep_file_caches)
 {
   int i, iflag;
   char s[AS_MAXCH];
@@ -1338,6 +1575,10 @@ void CALL_CONV swe_set_ephe_path(const char *path)
   if (*(s + i - 1) != *DIR_GLUE && *s != '\0')
     strcat(s, DIR_GLUE);
   strcpy(swed.ephepath, s);
+  if (!keep_file_caches) {
+    swi_fopen_cache_clear();
+    astnam_close();
+  }
 //swe_set_interpolate_nut(TRUE);
   /* try to open lunar ephemeris, in order to get DE number and set
    * tidal acceleration of the Moon */
@@ -2132,7 +2373,7 @@ static int sweph(double tjd, int ipli, int ifno, int32 iflag, double *xsunb, AS_
   struct plan_data *psdp = &swed.pldat[SEI_SUNBARY];
   struct file_data *fdp = &swed.fidat[ifno];
   int32 speedf1, speedf2;
-  AS_BOOL need_speed;
+  AS_BOOL need_speed, pool_searched = FALSE;
   ipl = ipli;
   if (ipli > SE_AST_OFFSET) 
     ipl = SEI_ANYBODY;
@@ -2163,7 +2404,12 @@ static int sweph(double tjd, int ipli, int ifno, int32 iflag, double *xsunb, AS_
   if (fdp->fptr != NULL) {
     /* if tjd is beyond file range, close old file.
      * if new asteroid, close old file. */
-    if (tjd < fdp->tfstart || tjd > fdp->tfend
+    if (tjd >= fdp->tfstart && tjd <= fdp->tfend
+      && ipl == SEI_ANYBODY && ipli != pdp->ibdy) {
+      /* new asteroid: keep old file open in pool, take new one from pool */
+      ast_pool_switch(ipli);
+      pool_searched = TRUE;
+    } else if (tjd < fdp->tfstart || tjd > fdp->tfend
       || (ipl == SEI_ANYBODY && ipli != pdp->ibdy)) { 	
       fclose(fdp->fptr);
       fdp->fptr = NULL;
@@ -2175,6 +2421,9 @@ static int sweph(double tjd, int ipli, int ifno, int32 iflag, double *xsunb, AS_
       pdp->segp = NULL;
     }
   }
+  /* if sweph file not open, it may be in the asteroid pool */
+  if (fdp->fptr == NULL && ipl == SEI_ANYBODY && !pool_searched)
+    ast_pool_switch(ipli);
   /* if sweph file not open, find and open it */
   if (fdp->fptr == NULL) {
     swi_gen_filename(tjd, ipli, fname); 
@@ -2356,12 +2605,264 @@ again:
   return(OK);
 }
 
+/*
+ * Resolution cache of swi_fopen(). 
+ * For each (ephemeris path, file name) that has been looked up, it keeps
+ * the full name of the file found or remembers that the file is missing,
+ * so that the directories of the path need not be probed again.
+ * The cache is shared by all threads; it is cleared by every call of
+ * swe_set_ephe_path(), so that files added since are found, and whenever 
+ * the library writes an ephemeris file. Worker threads of 
+ * swi_parallel_for() set the path of the calling thread and keep
+ * the cache.
+ */
+#if MSDOS
+static SRWLOCK fopen_cache_lock = SRWLOCK_INIT;
+# define FOPEN_CACHE_LOCK()	AcquireSRWLockExclusive(&fopen_cache_lock)
+# define FOPEN_CACHE_UNLOCK()	ReleaseSRWLockExclusive(&fopen_cache_lock)
+#else
+#include <pthread.h>
+static pthread_mutex_t fopen_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+# define FOPEN_CACHE_LOCK()	pthread_mutex_lock(&fopen_cache_lock)
+# define FOPEN_CACHE_UNLOCK()	pthread_mutex_unlock(&fopen_cache_lock)
+#endif
+
+#define FOPEN_CACHE_SIZE	64
+static struct {
+  int n, next;
+  struct {
+    char ephepath[AS_MAXCH];
+    char fname[AS_MAXCH];
+    char fnam_found[AS_MAXCH];	/* empty if the file is missing */
+  } e[FOPEN_CACHE_SIZE];
+  int64 stats[SE_STAT_FOPEN_CACHED + 1];
+} fopen_cache;
+
+void swi_fopen_cache_clear(void)
+{
+  FOPEN_CACHE_LOCK();
+  fopen_cache.n = 0;
+  fopen_cache.next = 0;
+  FOPEN_CACHE_UNLOCK();
+}
+
+/* must be called with the lock held */
+static int fopen_cache_find(const char *fname, const char *ephepath)
+{
+  int i;
+  for (i = 0; i < fopen_cache.n; i++) {
+    if (strcmp(fopen_cache.e[i].fname, fname) == 0
+      && strcmp(fopen_cache.e[i].ephepath, ephepath) == 0)
+      return i;
+  }
+  return -1;
+}
+
+static void fopen_cache_store(const char *fname, const char *ephepath, const char *fnam_found)
+{
+  int i;
+  if (strlen(fname) >= AS_MAXCH || strlen(ephepath) >= AS_MAXCH)
+    return;
+  FOPEN_CACHE_LOCK();
+  if ((i = fopen_cache_find(fname, ephepath)) < 0) {
+    i = fopen_cache.next;
+    fopen_cache.next = (i + 1) % FOPEN_CACHE_SIZE;
+    if (fopen_cache.n < FOPEN_CACHE_SIZE)
+      fopen_cache.n++;
+    strcpy(fopen_cache.e[i].fname, fname);
+    strcpy(fopen_cache.e[i].ephepath, ephepath);
+  }
+  strcpy(fopen_cache.e[i].fnam_found, fnam_found);
+  FOPEN_CACHE_UNLOCK();
+}
+
+static void fopen_cache_count(int istat, int64 n)
+{
+  FOPEN_CACHE_LOCK();
+  fopen_cache.stats[istat] += n;
+  FOPEN_CACHE_UNLOCK();
+}
+
+/* 
+ * Fills stats[0..nstats-1] with the counters SE_STAT_*, 
+ * returns the number of counters available (SE_NSTATS).
+ */
+int32 CALL_CONV swe_get_cache_stats(int64 *stats, int32 nstats)
+{
+  int i;
+  int64 prec[2];
+  FOPEN_CACHE_LOCK();
+  for (i = 0; i < nstats && i < SE_NSTATS; i++) {
+    if (i <= SE_STAT_FOPEN_CACHED)
+      stats[i] = fopen_cache.stats[i];
+    else
+      stats[i] = 0;
+  }
+  FOPEN_CACHE_UNLOCK();
+  /* thread-local caches, counted for the calling thread */
+  swi_prec_cache_stats(prec, FALSE);
+  for (i = SE_STAT_PREC; i <= SE_STAT_PREC_CACHED && i < nstats; i++)
+    stats[i] = prec[i - SE_STAT_PREC];
+  swi_observer_cache_stats(prec, FALSE);
+  for (i = SE_STAT_OBSERVER; i <= SE_STAT_OBSERVER_CACHED && i < nstats; i++)
+    stats[i] = prec[i - SE_STAT_OBSERVER];
+  for (i = SE_STAT_CALC; i <= SE_STAT_CALC_CACHED && i < nstats; i++)
+    stats[i] = swed.calc_cache_stats[i - SE_STAT_CALC];
+  return SE_NSTATS;
+}
+
+void CALL_CONV swe_reset_cache_stats(void)
+{
+  FOPEN_CACHE_LOCK();
+  memset(fopen_cache.stats, 0, sizeof(fopen_cache.stats));
+  FOPEN_CACHE_UNLOCK();
+  swi_prec_cache_stats(NULL, TRUE);
+  swi_observer_cache_stats(NULL, TRUE);
+  swed.calc_cache_stats[0] = swed.calc_cache_stats[1] = 0;
+}
+
+/* settings of the calling thread */
+void swi_get_settings(struct swe_settings *s)
+{
+  swi_init_swed_if_start();
+  memset((void *) s, 0, sizeof(struct swe_settings));
+  s->ephe_path_is_set = swed.ephe_path_is_set;
+  strcpy(s->ephepath, swed.ephepath);
+  strcpy(s->jplfnam, swed.jplfnam);
+  s->is_tid_acc_manual = swed.is_tid_acc_manual;
+  s->tid_acc = swed.tid_acc;
+  s->delta_t_userdef_is_set = swed.delta_t_userdef_is_set;
+  s->delta_t_userdef = swed.delta_t_userdef;
+  memcpy(s->astro_models, swed.astro_models, SEI_NMODELS * sizeof(int32));
+  s->do_interpolate_nut = swed.do_interpolate_nut;
+  s->do_interpolate_deltat = swed.do_interpolate_deltat;
+  s->do_interpolate_ecl = swed.do_interpolate_ecl;
+  s->read_table_files = swed.read_table_files;
+  s->geopos_is_set = swed.geopos_is_set;
+  s->topd = swed.topd;
+  s->ayana_is_set = swed.ayana_is_set;
+  s->sidd = swed.sidd;
+  s->calc_cache_nsets = swed.calc_cache_nsets;
+}
+
+/* gives the calling thread the settings s of another thread */
+void swi_set_settings(const struct swe_settings *s)
+{
+  swi_init_swed_if_start();
+  strcpy(swed.jplfnam, s->jplfnam);
+  if (s->ephe_path_is_set)
+    set_ephe_path(s->ephepath, TRUE);
+  /* after set_ephe_path(), which resets them */
+  memcpy(swed.astro_models, s->astro_models, SEI_NMODELS * sizeof(int32));
+  swi_prec_cache_clear();
+  swi_observer_cache_clear();
+  if (s->is_tid_acc_manual)
+    swe_set_tid_acc(s->tid_acc);
+  if (s->delta_t_userdef_is_set)
+    swe_set_delta_t_userdef(s->delta_t_userdef);
+  swe_set_interpolate_nut(s->do_interpolate_nut);
+  swe_set_interpolate_deltat(s->do_interpolate_deltat);
+  swe_set_interpolate_ecl(s->do_interpolate_ecl);
+  swed.read_table_files = s->read_table_files;
+  swed.geopos_is_set = s->geopos_is_set;
+  swed.topd = s->topd;
+  swed.ayana_is_set = s->ayana_is_set;
+  swed.sidd = s->sidd;
+  swed.calc_cache_nsets = s->calc_cache_nsets;
+}
+
+/*
+ * Calls fn(i, arg) for i = 0 .. n-1 on nthreads worker threads.
+ * Each worker starts with the settings of the calling thread
+ * (ephemeris path, Delta T, topocentric and sidereal settings etc.)
+ * and closes its files when it is done; fn must only write data
+ * that belongs to item i. With nthreads <= 1, or where threads are
+ * not available, the items are done in the calling thread.
+ * Returns the number of threads used.
+ */
+#if !MSDOS
+struct parallel_for {
+  void (*fn)(int32 i, void *arg);
+  void *arg;
+  int32 n, next;
+  pthread_mutex_t lock;
+  struct swe_settings settings;
+};
+
+static void *parallel_for_worker(void *p)
+{
+  struct parallel_for *pf = (struct parallel_for *) p;
+  int32 i;
+  swi_set_settings(&pf->settings);
+  for (;;) {
+    pthread_mutex_lock(&pf->lock);
+    i = pf->next++;
+    pthread_mutex_unlock(&pf->lock);
+    if (i >= pf->n)
+      break;
+    pf->fn(i, pf->arg);
+  }
+  close_ephe(TRUE);
+  return NULL;
+}
+#endif
+
+int32 swi_parallel_for(int32 nthreads, int32 n, void (*fn)(int32 i, void *arg), void *arg)
+{
+  int32 i, nstarted = 0;
+#if !MSDOS
+  struct parallel_for pf;
+  pthread_t *tid;
+  if (nthreads > n)
+    nthreads = n;
+  if (nthreads > 1 && (tid = (pthread_t *) malloc(nthreads * sizeof(pthread_t))) != NULL) {
+    pf.fn = fn;
+    pf.arg = arg;
+    pf.n = n;
+    pf.next = 0;
+    pthread_mutex_init(&pf.lock, NULL);
+    swi_get_settings(&pf.settings);
+    for (i = 0; i < nthreads; i++) {
+      if (pthread_create(&tid[i], NULL, parallel_for_worker, &pf) != 0)
+	break;
+      nstarted++;
+    }
+    for (i = 0; i < nstarted; i++)
+      pthread_join(tid[i], NULL);
+    pthread_mutex_destroy(&pf.lock);
+    free(tid);
+    if (nstarted > 0)
+      return nstarted;
+  }
+#endif
+  for (i = 0; i < n; i++)
+    fn(i, arg);
+  return 1;
+}
+
+/* directory into which the library writes a file: dir, or, if dir is
+ * NULL or empty, the first directory of the ephemeris path, or ".".
+ * s is a buffer of AS_MAXCH bytes, the result may point into it.
+ */
+const char *swi_ephe_write_dir(const char *dir, char *s)
+{
+  char *cpos[20];
+  if (dir != NULL && *dir != '\0')
+    return dir;
+  if (!swed.ephe_path_is_set)
+    swe_set_ephe_path(NULL);
+  strcpy(s, swed.ephepath);
+  if (swi_cutstr(s, PATH_SEPARATOR, cpos, 20) < 1 || *cpos[0] == '\0') 
+    return ".";
+  return cpos[0];
+}
+
 /*
  * Alois 2.12.98: inserted error message generation for file not found 
  */
 FILE *swi_fopen(int ifno, char *fname, char *ephepath, char *serr)
 {
-  int np, i, j;
+  int np, i, j, icache, nprobe = 0;
   FILE *fp = NULL;
   char *fnamp, fn[AS_MAXCH];
   char *cpos[20];
@@ -2372,6 +2873,21 @@ FILE *swi_fopen(int ifno, char *fname, char *ephepath, char *serr)
   } else {
     fnamp = fn; 
   }
+  FOPEN_CACHE_LOCK();
+  fopen_cache.stats[SE_STAT_FOPEN]++;
+  if ((icache = fopen_cache_find(fname, ephepath)) >= 0) {
+    fopen_cache.stats[SE_STAT_FOPEN_CACHED]++;
+    strcpy(fnamp, fopen_cache.e[icache].fnam_found);
+  }
+  FOPEN_CACHE_UNLOCK();
+  if (icache >= 0) {
+    if (*fnamp == '\0')
+      goto file_not_found;
+    fopen_cache_count(SE_STAT_FOPEN_PROBE, 1);
+    if ((fp = fopen(fnamp, BFILE_R_ACCESS)) != NULL)
+      return fp;
+    /* the file has disappeared since, search the path again */
+  }
   strcpy(s1, ephepath);
   np = swi_cutstr(s1, PATH_SEPARATOR, cpos, 20);
   *s = '\0';
@@ -2393,9 +2909,17 @@ FILE *swi_fopen(int ifno, char *fname, char *ephepath, char *serr)
     }
     strcpy(fnamp, s);
     fp = fopen(fnamp, BFILE_R_ACCESS);
-    if (fp != NULL) 
+    nprobe++;
+    if (fp != NULL) {
+      fopen_cache_count(SE_STAT_FOPEN_PROBE, nprobe);
+      fopen_cache_store(fname, ephepath, fnamp);
       return fp;
+    }
   }
+  fopen_cache_count(SE_STAT_FOPEN_PROBE, nprobe);
+  fopen_cache_store(fname, ephepath, "");
+file_not_found:
+  fopen_cache_count(SE_STAT_FOPEN_MISS, 1);
   sprintf(s, "SwissEph file '%s' not found in PATH '%s'", fname, ephepath);
   s[AS_MAXCH-1] = '\0';		/* s must not be longer then AS_MAXCH */
   if (serr != NULL)
@@ -2467,7 +2991,7 @@ static int app_pos_etc_plan(int ipli, int iplmoon, int32 iflag, char *serr)
   int ipl, ifno, ibody;
   int32 flg1, flg2;
   double xx[6], xx0[6], dx[3], dt, t, dtsave_for_defl;
-  double xobs[6], xobs2[6];
+  double xobs[6], xobs2[6] = {0}, dv[3];
   double xearth[6], xsun[6], xcom[6];
   double xxsp[6], xxsv[6];
   struct plan_data *pedp = &swed.pldat[SEI_EARTH];
@@ -2696,8 +3220,7 @@ static int app_pos_etc_plan(int ipli, int iplmoon, int32 iflag, char *serr)
     if (iflag & SEFLG_SPEED) {
       /* observer position for t(light-time) */
       if (iflag & SEFLG_TOPOCTR) {
-        if (swi_get_observer(t, iflag | SEFLG_NONUT, NO_SAVE, xobs2, serr) != OK)
-          return ERR;
+        observer_at_light_time(t - pedp->teval, xobs2);
         for (i = 0; i <= 5; i++)
           xobs2[i] += xearth[i];
       } else {
@@ -2745,8 +3268,9 @@ static int app_pos_etc_plan(int ipli, int iplmoon, int32 iflag, char *serr)
      * Neglecting this would involve an error of several 0.1"
      */
     if (iflag & SEFLG_SPEED) {
-      for (i = 3; i <= 5; i++) 
-	xx[i] += xobs[i] - xobs2[i];
+      for (i = 0; i <= 2; i++) 
+	dv[i] = xobs[i+3] - xobs2[i+3];
+      aberr_light_speed(xx, dv);
     }
   }
   if (!(iflag & SEFLG_SPEED))
@@ -3366,7 +3890,7 @@ static int app_pos_etc_plan_osc(int ipl, int ipli, int32 iflag, char *serr)
   int i, j, niter, retc;
   double xx[6], dx[3], dt, dtsave_for_defl;
   double xearth[6], xsun[6], xmoon[6];
-  double xxsv[6], xxsp[3]={0}, xobs[6], xobs2[6];
+  double xxsv[6], xxsp[3]={0}, xobs[6], xobs2[6] = {0}, dv[3];
   double t;
   struct plan_data *pdp = &swed.pldat[ipli];
   struct plan_data *pedp = &swed.pldat[SEI_EARTH];
@@ -3480,8 +4004,7 @@ static int app_pos_etc_plan_osc(int ipl, int ipli, int32 iflag, char *serr)
       if (retc != OK)
 	return(retc);
       if (iflag & SEFLG_TOPOCTR) {
-        if (swi_get_observer(t, iflag | SEFLG_NONUT, NO_SAVE, xobs2, serr) != OK)
-          return ERR;
+        observer_at_light_time(t - pedp->teval, xobs2);
         for (i = 0; i <= 5; i++)
           xobs2[i] += xearth[i];
       } else {
@@ -3525,9 +4048,11 @@ static int app_pos_etc_plan_osc(int ipl, int ipli, int32 iflag, char *serr)
      * the difference of speed of the earth between t and t-dt. 
      * Neglecting this would involve an error of several 0.1"
      */
-    if (iflag & SEFLG_SPEED)
-      for (i = 3; i <= 5; i++) 
-	xx[i] += xobs[i] - xobs2[i];
+    if (iflag & SEFLG_SPEED) {
+      for (i = 0; i <= 2; i++) 
+	dv[i] = xobs[i+3] - xobs2[i+3];
+      aberr_light_speed(xx, dv);
+    }
   }
   /* save J2000 coordinates; required for sidereal positions */
   for (i = 0; i <= 5; i++)
@@ -3551,7 +4076,7 @@ static int app_pos_etc_plan_osc(int ipl, int ipli, int32 iflag, char *serr)
 void swi_precess_speed(double *xx, double t, int32 iflag, int direction) 
 {
   struct epsilon *oe;
-  double fac, dpre, dpre2;
+  double fac;
   double tprec = (t - J2000) / 36525.0;
   int prec_model = swed.astro_models[SE_MODEL_PREC_LONGTERM];
   if (prec_model == 0) prec_model = SEMOD_PREC_DEFAULT;
@@ -3572,9 +4097,7 @@ void swi_precess_speed(double *xx, double t, int32 iflag, int direction)
   swi_cartpol_sp(xx, xx);
 if (1) {
   if (prec_model == SEMOD_PREC_VONDRAK_2011) {
-    swi_ldp_peps(t, &dpre, NULL);
-    swi_ldp_peps(t + 1, &dpre2, NULL);
-    xx[3] += (dpre2 - dpre) * fac;
+    xx[3] += swi_precess_rate(t, iflag, direction) * fac;
   } else {
     xx[3] += (50.290966 + 0.0222226 * tprec) / 3600 / 365.25 * DEGTORAD * fac;
 			/* formula from Montenbruck, German 1994, p. 18 */
@@ -3661,6 +4184,22 @@ static void aberr_light(double *xx, double *xe) {
     xx[i] = (b_1*xx[i] + f2*ru*v[i]) / (1.0 + f1);
 }
 
+/* adds to the speed of xx the change of aberration resulting from
+ * the change of the observer's speed during light-time
+ * xx		planet's position and speed after aberration
+ * dv		observer's speed at t minus its speed at t - light-time
+ * aberration changes the direction of xx, not its length, therefore
+ * only the part of dv perpendicular to xx is used.
+ */
+static void aberr_light_speed(double *xx, double *dv)
+{
+  int i;
+  double ru = sqrt(square_sum(xx));
+  double f = dot_prod(xx, dv) / ru / ru;
+  for (i = 0; i <= 2; i++)
+    xx[i+3] += dv[i] - f * xx[i];
+}
+
 /* computes 'annual' aberration
  * xx		planet's position accounted for light-time 
  *              and gravitational light deflection
@@ -3903,7 +4442,7 @@ static int app_pos_etc_sun(int32 iflag, char *serr)
   int i, j, niter, retc = OK;
   int32 flg1, flg2;
   double xx[6], xxsv[6], dx[3], dt, t = 0;
-  double xearth[6], xsun[6], xobs[6];
+  double xearth[6], xsun[6], xobs[6], dv[3];
   struct plan_data *pedp = &swed.pldat[SEI_EARTH];
   struct plan_data *psdp = &swed.pldat[SEI_SUNBARY];
   struct epsilon *oe = &swed.oec2000;
@@ -4044,6 +4583,17 @@ static int app_pos_etc_sun(int32 iflag, char *serr)
   if (!(iflag & SEFLG_TRUEPOS) && !(iflag & SEFLG_NOABERR)) {
 		/* SEFLG_NOABERR is on, if SEFLG_HELCTR or SEFLG_BARYCTR */
     swi_aberr_light(xx, xobs, iflag);
+    /* 
+     * Apparent speed is also influenced by the change of speed
+     * of the topocentric observer during light-time.
+     * Neglecting this would involve an error of about 1"/day.
+     */
+    if ((iflag & SEFLG_SPEED) && (iflag & SEFLG_TOPOCTR)) {
+      dt = sqrt(square_sum(xx)) * AUNIT / CLIGHT / 86400.0;     
+      for (i = 0; i <= 2; i++) 
+	dv[i] = dt * swed.topd.xacc[i];
+      aberr_light_speed(xx, dv);
+    }
   }
   if (!(iflag & SEFLG_SPEED))
     for (i = 3; i <= 5; i++)
@@ -4087,7 +4637,7 @@ static int app_pos_etc_moon(int32 iflag, char *serr)
 {
   int i;
   int32 flg1, flg2;
-  double xx[6], xxsv[6], xobs[6], xxm[6], xs[6], xe[6], xobs2[6], dt;
+  double xx[6], xxsv[6], xobs[6], xxm[6], xs[6], xe[6], xobs2[6] = {0}, dv[3], dt, dtdt;
   struct plan_data *pedp = &swed.pldat[SEI_EARTH];
   struct plan_data *psdp = &swed.pldat[SEI_SUNBARY];
   struct plan_data *pdp = &swed.pldat[SEI_MOON];
@@ -4182,9 +4732,18 @@ static int app_pos_etc_moon(int32 iflag, char *serr)
         }
         break;
     } 
+    /* 
+     * Apparent speed is also influenced by the change of light-time, 
+     * which for a topocentric observer is mainly due to the rotation 
+     * of the earth. Neglecting this would involve an error of up to 2"/day.
+     */
+    if (iflag & SEFLG_SPEED) {
+      dtdt = dot_prod(xxm, (xxm+3)) / sqrt(square_sum(xxm)) * AUNIT / CLIGHT / 86400.0;
+      for (i = 3; i <= 5; i++)
+	xx[i] -= dtdt * xx[i];
+    }
     if (iflag & SEFLG_TOPOCTR) {
-      if (swi_get_observer(t, iflag | SEFLG_NONUT, NO_SAVE, xobs2, NULL) != OK)
-	  return ERR;
+      observer_at_light_time(t - pdp->teval, xobs2);
       for (i = 0; i <= 5; i++)
 	xobs2[i] += xe[i];
     } else if (iflag & SEFLG_BARYCTR) {
@@ -4215,9 +4774,11 @@ static int app_pos_etc_moon(int32 iflag, char *serr)
      * Neglecting this would lead to an error of several 0.1"
      */
 #if 1
-    if (iflag & SEFLG_SPEED)
-      for (i = 3; i <= 5; i++) 
-        xx[i] += xobs[i] - xobs2[i];
+    if (iflag & SEFLG_SPEED) {
+      for (i = 0; i <= 2; i++) 
+        dv[i] = xobs[i+3] - xobs2[i+3];
+      aberr_light_speed(xx, dv);
+    }
 #endif
   }
   /* if !speedflag, speed = 0 */
@@ -6943,6 +7504,179 @@ int32 CALL_CONV swe_fixstar2_mag(char *star, double *mag, char *serr)
   return retc;
 }
 
+/*
+ * Index of seasnam.txt, sorted by catalog number.
+ * The file is read into memory on first use; the names are terminated 
+ * in place and the index points into the buffer. The index is shared 
+ * by all threads and read-only once it is built, so a lookup only 
+ * holds the lock to copy a name. It is built for one ephemeris path 
+ * and rebuilt when a thread with another path asks for a name. It is 
+ * dropped by swe_set_ephe_path() and swe_close(), but not by the 
+ * worker threads of swi_parallel_for().
+ */
+#if MSDOS
+static SRWLOCK astnam_lock = SRWLOCK_INIT;
+# define ASTNAM_LOCK()		AcquireSRWLockExclusive(&astnam_lock)
+# define ASTNAM_UNLOCK()	ReleaseSRWLockExclusive(&astnam_lock)
+#else
+static pthread_mutex_t astnam_lock = PTHREAD_MUTEX_INITIALIZER;
+# define ASTNAM_LOCK()		pthread_mutex_lock(&astnam_lock)
+# define ASTNAM_UNLOCK()	pthread_mutex_unlock(&astnam_lock)
+#endif
+
+struct astnam_entry {
+  int32 ipli;
+  int32 iline;		/* index of the line in the file */
+  char *name;		/* NULL if the line has no name */
+};
+
+static struct {
+  AS_BOOL is_loaded;
+  char ephepath[AS_MAXCH];	/* path the index was built for */
+  char *text;
+  struct astnam_entry *ent;
+  int32 n;
+} astnam;
+
+/* must be called with the lock held */
+static void astnam_free(void)
+{
+  if (astnam.text != NULL)
+    free(astnam.text);
+  if (astnam.ent != NULL)
+    free(astnam.ent);
+  memset((void *) &astnam, 0, sizeof(astnam));
+}
+
+static void astnam_close(void)
+{
+  ASTNAM_LOCK();
+  astnam_free();
+  ASTNAM_UNLOCK();
+}
+
+/* sort by catalog number; of several lines with the same number, 
+ * the first one in the file counts */
+static int CMP_CALL_CONV astnam_compare(const void *a, const void *b)
+{
+  const struct astnam_entry *e1 = (const struct astnam_entry *) a;
+  const struct astnam_entry *e2 = (const struct astnam_entry *) b;
+  if (e1->ipli != e2->ipli)
+    return e1->ipli < e2->ipli ? -1 : 1;
+  return (e1->iline > e2->iline) - (e1->iline < e2->iline);
+}
+
+/*
+ * The file may contain comments starting with '#'.
+ * There must be at least two columns: 
+ * 1. asteroid catalog number
+ * 2. asteroid name
+ * The asteroid number may or may not be in brackets
+ * Must be called with the lock held.
+ */
+static void astnam_load(const char *ephepath)
+{
+  FILE *fp;
+  long size;
+  int32 nlines, i, j;
+  char *sp, *sp2, *eol;
+  astnam_free();
+  astnam.is_loaded = TRUE;
+  strcpy(astnam.ephepath, ephepath);
+  if ((fp = swi_fopen(-1, SE_ASTNAMFILE, astnam.ephepath, NULL)) == NULL)
+    return;
+  if (fseek(fp, 0L, SEEK_END) != 0 || (size = ftell(fp)) <= 0
+    || (astnam.text = (char *) malloc((size_t) size + 1)) == NULL) {
+    fclose(fp);
+    return;
+  }
+  rewind(fp);
+  size = (long) fread(astnam.text, 1, (size_t) size, fp);
+  fclose(fp);
+  astnam.text[size] = '\0';
+  for (nlines = 1, sp = astnam.text; (sp = strchr(sp, '\n')) != NULL; sp++)
+    nlines++;
+  if ((astnam.ent = (struct astnam_entry *) malloc(nlines * sizeof(struct astnam_entry))) == NULL) {
+    astnam_free();
+    astnam.is_loaded = TRUE;
+    strcpy(astnam.ephepath, ephepath);
+    return;
+  }
+  for (sp = astnam.text; sp != NULL && *sp != '\0'; sp = eol) {
+    if ((eol = strchr(sp, '\n')) != NULL)
+      *eol++ = '\0';
+    while (*sp == ' ' || *sp == '\t' 
+           || *sp == '(' || *sp == '[' || *sp == '{')
+      sp++;
+    if (*sp == '#' || *sp == '\r' || *sp == '\0')
+      continue;
+    /* catalog number of body of current line */
+    astnam.ent[astnam.n].ipli = atoi(sp);
+    astnam.ent[astnam.n].iline = astnam.n;
+    /* set pointer after catalog number */
+    if ((sp = strpbrk(sp, " \t")) != NULL) {
+      while (*sp == ' ' || *sp == '\t')
+        sp++;
+      if ((sp2 = strpbrk(sp, "#\r")) != NULL)
+        *sp2 = '\0'; 
+      swi_right_trim(sp);
+      if (*sp == '\0')
+        sp = NULL;
+    }
+    astnam.ent[astnam.n].name = sp;
+    astnam.n++;
+  }
+  qsort((void *) astnam.ent, (size_t) astnam.n, sizeof(struct astnam_entry), astnam_compare);
+  /* keep the first line of each catalog number */
+  for (i = 0, j = 0; i < astnam.n; i++) {
+    if (j > 0 && astnam.ent[j - 1].ipli == astnam.ent[i].ipli)
+      continue;
+    astnam.ent[j++] = astnam.ent[i];
+  }
+  astnam.n = j;
+}
+
+/* copies the name of asteroid with catalog number ipli from seasnam.txt 
+ * to s (AS_MAXCH chars); returns FALSE if there is none */
+static AS_BOOL astnam_lookup(int32 ipli, char *s)
+{
+  int32 lo = 0, hi, mid;
+  AS_BOOL found = FALSE;
+  ASTNAM_LOCK();
+  if (!astnam.is_loaded || strcmp(astnam.ephepath, swed.ephepath) != 0)
+    astnam_load(swed.ephepath);
+  hi = astnam.n - 1;
+  while (lo <= hi) {
+    mid = (lo + hi) / 2;
+    if (astnam.ent[mid].ipli == ipli) {
+      if (astnam.ent[mid].name != NULL && strlen(astnam.ent[mid].name) < AS_MAXCH) {
+        strcpy(s, astnam.ent[mid].name);
+        found = TRUE;
+      }
+      break;
+    }
+    if (astnam.ent[mid].ipli < ipli)
+      lo = mid + 1;
+    else
+      hi = mid - 1;
+  }
+  ASTNAM_UNLOCK();
+  return found;
+}
+
+/* 
+ * Names of n bodies at a time; the name of ipl[i] is written 
+ * to spname + i * AS_MAXCH, so spname must hold n * AS_MAXCH chars.
+ * This is only a loop over swe_get_planet_name(); each asteroid 
+ * still needs its own lookup in the ephemeris file.
+ */
+void CALL_CONV swe_get_planet_name_arr(int *ipl, int32 n, char *spname)
+{
+  int32 i;
+  for (i = 0; i < n; i++)
+    swe_get_planet_name(ipl[i], spname + i * AS_MAXCH);
+}
+
 char *CALL_CONV swe_get_planet_name(int ipl, char *s) 
 {
   int i;
@@ -7076,36 +7810,7 @@ char *CALL_CONV swe_get_planet_name(int ipl, char *s)
          * The asteroid number may or may not be in brackets
          */
         if (ipl > SE_AST_OFFSET && (s[0] == '?' || isdigit((int) s[1]))) {
-          int ipli = (int) (ipl - SE_AST_OFFSET), iplf = 0;
-          FILE *fp;
-          char si[AS_MAXCH], *sp, *sp2;
-          if ((fp = swi_fopen(-1, SE_ASTNAMFILE, swed.ephepath, NULL)) != NULL) {
-            while(ipli != iplf && (sp = fgets(si, AS_MAXCH, fp)) != NULL) {
-              while (*sp == ' ' || *sp == '\t' 
-                     || *sp == '(' || *sp == '[' || *sp == '{')
-                sp++;
-              if (*sp == '#' || *sp == '\r' || *sp == '\n' || *sp == '\0')
-                continue;
-              /* catalog number of body of current line */
-              iplf = atoi(sp);
-              if (ipli != iplf)
-                continue;
-              /* set pointer after catalog number */
-              sp = strpbrk(sp, " \t");
-              if (sp == NULL)
-                continue; /* there is no name */
-              while (*sp == ' ' || *sp == '\t')
-                sp++;
-              sp2 = strpbrk(sp, "#\r\n");
-              if (sp2 != NULL)
-                *sp2 = '\0'; 
-              if (*sp == '\0')
-                continue;
-              swi_right_trim(sp);
-              strcpy(s, sp);
-            }
-            fclose(fp);
-          }
+          astnam_lookup((int32) (ipl - SE_AST_OFFSET), s);
         }
       } else  {
 	i = ipl;
@@ -7267,38 +7972,80 @@ void CALL_CONV swe_set_topo(double geolon, double geolat, double geoalt)
 }
 
 void swi_force_app_pos_etc()
+{
+  force_app_pos();
+  calc_cache_clear();
+}
+
+/* swe_calc() for callers that read the save area afterwards 
+ * (barycentric earth and sun, obliquity, nutation, observer).
+ * A result from the cache would leave it at the date of the last 
+ * computation. */
+int32 swi_calc_save_area(double tjd, int ipl, int32 iflag, double *xx, char *serr)
+{
+  int32 retc, nsets = swed.calc_cache_nsets;
+  swed.calc_cache_nsets = -1;
+  retc = swe_calc(tjd, ipl, iflag, xx, serr);
+  swed.calc_cache_nsets = nsets;
+  return retc;
+}
+
+/* forces new computation of light-time etc., but keeps the results 
+ * of swe_calc() */
+static void force_app_pos(void)
 {
   int i;
   for (i = 0; i < SEI_NPLANETS; i++)
     swed.pldat[i].xflgs = -1;
   for (i = 0; i < SEI_NNODE_ETC; i++)
     swed.nddat[i].xflgs = -1;
-  for (i = 0; i <= SE_NPLANETS; i++) { // "=" because save area for asteroids > SE_AST_OFFSET is at i == SE_NPLANETS
-    swed.savedat[i].tsave = 0;
-    swed.savedat[i].iflgsave = -1;
+}
+
+/* observer positions for the last dates, places and flags, so that 
+ * they survive calls of swe_set_topo() for other places and of 
+ * swi_force_app_pos_etc(). only positions with SEFLG_NONUT are cached;
+ * without it, the result depends on the nutation matrix in swed.nut. 
+ * Delta T is part of the key, so that changes of tidal acceleration 
+ * or user-defined Delta T need not clear the cache. */
+#define OBS_CACHE_N	8
+struct observer_cache_entry {
+  double tjd, delt;
+  double geolon, geolat, geoalt;
+  int32 iflag;
+  double xobs[6], xacc[3];
+};
+static TLS struct {
+  int n, next;
+  struct observer_cache_entry e[OBS_CACHE_N];
+  int64 stats[2];	/* SE_STAT_OBSERVER, SE_STAT_OBSERVER_CACHED */
+} obs_cache;
+
+void swi_observer_cache_clear(void)
+{
+  obs_cache.n = 0;
+  obs_cache.next = 0;
+}
+
+void swi_observer_cache_stats(int64 *stats, AS_BOOL reset)
+{
+  if (stats != NULL) {
+    stats[0] = obs_cache.stats[0];
+    stats[1] = obs_cache.stats[1];
   }
+  if (reset)
+    obs_cache.stats[0] = obs_cache.stats[1] = 0;
 }
 
-int swi_get_observer(double tjd, int32 iflag, 
-	AS_BOOL do_save, double *xobs, char *serr)
+/* geocentric position, speed and acceleration of the observer, 
+ * equator J2000 */
+static void observer_state(double tjd, double tjd_ut, int32 iflag, 
+	double *xobs, double *xacc)
 {
   int i;
-  double sidt, delt, tjd_ut, eps, nut, nutlo[2];
+  double sidt, eps, nut, nutlo[2];
   double f = EARTH_OBLATENESS;
   double re = EARTH_RADIUS; 
   double cosfi, sinfi, cc, ss, cosl, sinl, h;
-  if (!swed.geopos_is_set) {
-    if (serr != NULL)
-      strcpy(serr, "geographic position has not been set");
-    return ERR;
-  }
-  /* geocentric position of observer depends on sidereal time,
-   * which depends on UT. 
-   * compute UT from ET. this UT will be slightly different
-   * from the user's UT, but this difference is extremely small.
-   */
-  delt = swe_deltat_ex(tjd, iflag, serr);
-  tjd_ut = tjd - delt;
   if (swed.oec.teps == tjd && swed.nut.tnut == tjd) {
     eps = swed.oec.eps;
     nutlo[1] = swed.nut.nutlo[1];
@@ -7353,6 +8100,13 @@ int swi_get_observer(double tjd, int32 iflag,
   /* to AUNIT */
   for (i = 0; i <= 5; i++)
     xobs[i] /= AUNIT;
+  /* centripetal acceleration of the observer; it is saved with the
+   * observer position, so that the change of the observer's speed
+   * during light-time can be taken into account in the aberration
+   * speed without computing the observer a second time */
+  xacc[0] = -EARTH_ROT_SPEED * EARTH_ROT_SPEED * xobs[0];
+  xacc[1] = -EARTH_ROT_SPEED * EARTH_ROT_SPEED * xobs[1];
+  xacc[2] = 0;
   /* subtract nutation, set backward flag */
   if (!(iflag & SEFLG_NONUT)) {
     swi_coortrf2(xobs, xobs, -swed.nut.snut, swed.nut.cnut);
@@ -7360,23 +8114,96 @@ int swi_get_observer(double tjd, int32 iflag,
     /*if (iflag & SEFLG_SPEED)*/
       swi_coortrf2(xobs+3, xobs+3, -swed.nut.snut, swed.nut.cnut);
     swi_nutate(xobs, iflag | SEFLG_SPEED, TRUE);
+    swi_coortrf2(xacc, xacc, -swed.nut.snut, swed.nut.cnut);
+    swi_nutate(xacc, iflag & ~SEFLG_SPEED, TRUE);
   }
   /* precess to J2000 */
   swi_precess(xobs, tjd, iflag, J_TO_J2000);
   /*if (iflag & SEFLG_SPEED)*/
     swi_precess_speed(xobs, tjd, iflag, J_TO_J2000);
+  swi_precess(xacc, tjd, iflag, J_TO_J2000);
   /* neglect frame bias (displacement of 45cm) */
   /* ... */
+}
+
+int swi_get_observer(double tjd, int32 iflag, 
+	AS_BOOL do_save, double *xobs, char *serr)
+{
+  int i;
+  double delt, tjd_ut;
+  struct observer_cache_entry *e = NULL, e_nocache;
+  int32 keyflag = iflag & (SEFLG_JPLHOR | SEFLG_JPLHOR_APPROX);
+  if (!swed.geopos_is_set) {
+    if (serr != NULL)
+      strcpy(serr, "geographic position has not been set");
+    return ERR;
+  }
+  /* geocentric position of observer depends on sidereal time,
+   * which depends on UT. 
+   * compute UT from ET. this UT will be slightly different
+   * from the user's UT, but this difference is extremely small.
+   */
+  delt = swe_deltat_ex(tjd, iflag, serr);
+  tjd_ut = tjd - delt;
+  if (iflag & SEFLG_NONUT) {
+    obs_cache.stats[0]++;
+    for (i = 0; i < obs_cache.n; i++) {
+      e = &obs_cache.e[i];
+      if (e->tjd == tjd && e->delt == delt && e->iflag == keyflag
+        && e->geolon == swed.topd.geolon 
+        && e->geolat == swed.topd.geolat 
+        && e->geoalt == swed.topd.geoalt) 
+        break;
+    }
+    if (i < obs_cache.n) {
+      obs_cache.stats[1]++;
+    } else {
+      e = &obs_cache.e[obs_cache.next];
+      obs_cache.next = (obs_cache.next + 1) % OBS_CACHE_N;
+      if (obs_cache.n < OBS_CACHE_N)
+        obs_cache.n++;
+      e->tjd = tjd;
+      e->delt = delt;
+      e->iflag = keyflag;
+      e->geolon = swed.topd.geolon;
+      e->geolat = swed.topd.geolat;
+      e->geoalt = swed.topd.geoalt;
+      observer_state(tjd, tjd_ut, iflag, e->xobs, e->xacc);
+    }
+  } else {
+    e = &e_nocache;
+    observer_state(tjd, tjd_ut, iflag, e->xobs, e->xacc);
+  }
+  for (i = 0; i <= 5; i++)
+    xobs[i] = e->xobs[i];
   /* save */
   if (do_save) {
     for (i = 0; i <= 5; i++)
-      swed.topd.xobs[i] = xobs[i];
+      swed.topd.xobs[i] = e->xobs[i];
+    for (i = 0; i <= 2; i++)
+      swed.topd.xacc[i] = e->xacc[i];
     swed.topd.teval = tjd;
     swed.topd.tjd_ut = tjd_ut;	/* -> save area */
   }
   return OK;
 }
 
+/* geocentric position and speed of the observer at the time of 
+ * light emission, teval + dt (dt < 0), extrapolated from the observer 
+ * saved by swi_get_observer() for teval. The change of the observer's 
+ * speed during light-time goes into the aberration speed; it is taken 
+ * from the derivative, because a few hours of light-time amount to a 
+ * large part of the earth's rotation.
+ */
+static void observer_at_light_time(double dt, double *xobs2)
+{
+  int i;
+  for (i = 0; i <= 2; i++) {
+    xobs2[i] = swed.topd.xobs[i] + dt * swed.topd.xobs[i+3];
+    xobs2[i+3] = swed.topd.xobs[i+3] + dt * swed.topd.xacc[i];
+  }
+}
+
 /* Equation of Time
  *
  * The function returns the difference between 
@@ -673,7 +673,15 @@ extern int swi_intp_apsides(double J, double *pol, int ipli);
 extern int swi_moshplan(double tjd, int ipli, AS_BOOL do_save, double *xpret, double *xeret, char *serr);
 extern int swi_moshplan2(double J, int iplm, double *pobj);
 extern int swi_osc_el_plan(double tjd, double *xp, int ipl, int ipli, double *xearth, double *xsun, char *serr);
+extern void swi_close_fict_elements(void);
+extern void swi_close_ecl_catalog(void);
+extern void swi_ecl_track_clear(void);
+extern double swi_refrac_table(double inalt, double atpress, double attemp, int32 calc_flag);
+extern void swi_refrac_table_close(void);
+extern void swi_hel_memo_close(void);
 extern FILE *swi_fopen(int ifno, char *fname, char *ephepath, char *serr);
+extern const char *swi_ephe_write_dir(const char *dir, char *s);
+extern void swi_fopen_cache_clear(void);
 extern int32 swi_init_swed_if_start(void);
 extern int32 swi_set_tid_acc(double tjd_ut, int32 iflag, int32 denum, char *serr);
 extern int32 swi_get_tid_acc(double tjd_ut, int32 iflag, int32 denum, int32 *denumret, double *tid_acc, char *serr);
@@ -719,6 +727,19 @@ struct file_data {
   int ipl[SEI_FILE_NMAXPLAN];	/* planet numbers */
 };
  
+/* Asteroid and planetary moon files share the slots 
+ * fidat[SEI_FILE_ANY_AST] and pldat[SEI_ANYBODY]. If another body is
+ * wanted, the open file of the current body, its constants and its
+ * current segment are kept in a pool of SEI_NAST_POOL entries, which
+ * is allocated when it is first needed. */
+#define SEI_NAST_POOL	32
+
+struct ast_pool_entry {
+  struct file_data fd;	/* fd.fptr == NULL if entry is free */
+  struct plan_data pd;
+  uint32 last_use;	/* for replacement of least recently used entry */
+};
+
 struct gen_const {
  double clight, 
 	aunit, 
@@ -727,10 +748,22 @@ struct gen_const {
 	sunradius;
 };
 
+/* Results of swe_calc() are kept in a set-associative cache of
+ * SEI_CALC_CACHE_WAYS entries per set; a new result replaces the least
+ * recently used entry of its set. swe_set_calc_cache() chooses the
+ * number of sets, up to SEI_CALC_CACHE_NSETS. The default number of
+ * sets is part of swed, more are allocated when first used. */
+#define SEI_CALC_CACHE_WAYS	4
+#define SEI_CALC_CACHE_NSETS	64
+#define SEI_CALC_CACHE_NSETS_DEFAULT	16
+
 struct save_positions {
   int ipl;
+  int iplmoon;		/* planetary moon or center of body, or 0 */
   double tsave;
-  int32 iflgsave;
+  int32 iflag;		/* flags of the call, without coordinate system flags */
+  int32 iflgsave;	/* flags returned */
+  uint32 last_use;	/* 0 if entry is free */
   /* position at t = tsave,
    * in ecliptic polar (offset 0),
    *    ecliptic cartesian (offset 6), 
@@ -760,6 +793,7 @@ struct topo_data {
   double teval;
   double tjd_ut;
   double xobs[6];
+  double xacc[3];	/* acceleration of observer by earth rotation, AU/day^2 */
 };
 
 struct sid_data {
@@ -787,6 +821,28 @@ struct interpol {
   double nut_deps0, nut_deps1, nut_deps2;
 };
 
+/* Delta T spline table, see swe_set_interpolate_deltat().
+ * Delta T is sampled for one Delta T model and tidal acceleration
+ * in three regions: a coarse one before DTSPL_TJD_FINE0, a fine one 
+ * covering the tabulated values and their extrapolation, and a coarse
+ * one after DTSPL_TJD_FINE1. */
+#define DTSPL_TJD_START   MOSHNDEPH_START
+#define DTSPL_TJD_FINE0   2305447.5   /* 1 Jan. 1600 */
+#define DTSPL_TJD_FINE1   2524593.5   /* 1 Jan. 2200 */
+#define DTSPL_TJD_END     MOSHNDEPH_END
+#define DTSPL_STEP_FINE   (365.25 / 16.0)
+#define DTSPL_STEP_COARSE (365.25 * 2.0)
+#define DTSPL_NREGIONS    3
+struct deltat_spline {
+  int deltat_model;	/* model and tidal acceleration the table is made for */
+  double tid_acc;
+  int tabsiz;		/* size of table dt[] when the table was made */
+  double tstart[DTSPL_NREGIONS];
+  double step[DTSPL_NREGIONS];
+  int n[DTSPL_NREGIONS];	/* number of intervals in region */
+  double *f[DTSPL_NREGIONS];	/* n + 3 values, starting one step before tstart */
+};
+
 /* if this is changed, then also update initialisation in sweph.c */
 struct swe_data {
   AS_BOOL ephe_path_is_set;
@@ -824,6 +880,12 @@ struct swe_data {
   int32 astro_models[SEI_NMODELS];
   AS_BOOL do_interpolate_nut;
   struct interpol interpol;
+  AS_BOOL do_interpolate_deltat;
+  struct deltat_spline dtspl;
+  AS_BOOL do_interpolate_ecl;
+  AS_BOOL read_table_files;
+  struct ast_pool_entry *astpool;	/* SEI_NAST_POOL entries, or NULL */
+  uint32 astpool_clock;
   struct file_data fidat[SEI_NEPHFILES];
   struct gen_const gcdat;
   struct plan_data pldat[SEI_NPLANETS];
@@ -832,7 +894,11 @@ struct swe_data {
 #else
   struct plan_data nddat[SEI_NNODE_ETC];
 #endif
-  struct save_positions savedat[SE_NPLANETS+1];
+  struct save_positions savedat[SEI_CALC_CACHE_NSETS_DEFAULT * SEI_CALC_CACHE_WAYS];
+  struct save_positions *savedat_large;	/* SEI_CALC_CACHE_NSETS sets, or NULL */
+  int32 calc_cache_nsets;	/* 0: default, -1: no cache */
+  uint32 calc_cache_clock;
+  int64 calc_cache_stats[2];	/* SE_STAT_CALC, SE_STAT_CALC_CACHED */
   struct epsilon oec;
   struct epsilon oec2000;
   struct nut nut;
@@ -847,3 +913,28 @@ struct swe_data {
 };
 
 extern TLS struct swe_data swed;
+
+/* settings of a thread, passed on to worker threads by swi_parallel_for() */
+struct swe_settings {
+  AS_BOOL ephe_path_is_set;
+  char ephepath[AS_MAXCH];
+  char jplfnam[AS_MAXCH];
+  AS_BOOL is_tid_acc_manual;
+  double tid_acc;
+  AS_BOOL delta_t_userdef_is_set;
+  double delta_t_userdef;
+  int32 astro_models[SEI_NMODELS];
+  AS_BOOL do_interpolate_nut;
+  AS_BOOL do_interpolate_deltat;
+  AS_BOOL do_interpolate_ecl;
+  AS_BOOL read_table_files;
+  AS_BOOL geopos_is_set;
+  struct topo_data topd;
+  AS_BOOL ayana_is_set;
+  struct sid_data sidd;
+  int32 calc_cache_nsets;
+};
+
+extern void swi_get_settings(struct swe_settings *s);
+extern void swi_set_settings(const struct swe_settings *s);
+extern int32 swi_parallel_for(int32 nthreads, int32 n, void (*fn)(int32 i, void *arg), void *arg);
@@ -369,6 +369,10 @@ extern "C" {
 /* for swe_refrac() */
 #define SE_TRUE_TO_APP	0
 #define SE_APP_TO_TRUE	1
+/* to be or'ed to the calc_flag of swe_refrac_extended() and swe_azalt*():
+ * interpolate refraction in a table per pressure and temperature,
+ * accurate to 5e-6 degrees */
+#define SE_REFRAC_TABLE	2
 
 /*
  * only used for experimenting with various JPL ephemeris files
@@ -387,6 +391,7 @@ extern "C" {
 #define SE_STARFILE     "sefstars.txt"
 #define SE_ASTNAMFILE   "seasnam.txt"
 #define SE_FICTFILE     "seorbel.txt"
+#define SE_ECLCATFILE   "seeclcat.bin"
 
 /*
  * ephemeris path
@@ -452,6 +457,7 @@ extern "C" {
 #define SE_HELFLAG_AVKIND_MIN7 		(1 << 18)
 #define SE_HELFLAG_AVKIND_MIN9 		(1 << 19)
 #define SE_HELFLAG_AVKIND (SE_HELFLAG_AVKIND_VR|SE_HELFLAG_AVKIND_PTO|SE_HELFLAG_AVKIND_MIN7|SE_HELFLAG_AVKIND_MIN9)
+#define SE_HELFLAG_REFRAC_TABLE		(1 << 20)  /* refraction from a table, see SE_REFRAC_TABLE */
 #define TJD_INVALID		 	99999999.0
 #define SIMULATE_VICTORVB               1
 
@@ -682,6 +688,27 @@ ext_def(int32) swe_heliacal_ut(double tjdstart_ut, double *geopos, double *datm,
 ext_def(int32) swe_heliacal_pheno_ut(double tjd_ut, double *geopos, double *datm, double *dobs, char *ObjectName, int32 TypeEvent, int32 helflag, double *darr, char *serr);
 ext_def(int32) swe_vis_limit_mag(double tjdut, double *geopos, double *datm, double *dobs, char *ObjectName, int32 helflag, double *dret, char *serr);
 
+/* statistics of the last swe_heliacal_ut() call, see swe_heliacal_stats() */
+#define SE_HELSTAT_TIME		0	/* processor time of the search in the calling thread, seconds */
+#define SE_HELSTAT_TIME_CONJ	1	/* ... spent near the conjunction with the sun */
+#define SE_HELSTAT_TIME_DAY	2	/* ... spent finding the day of the event */
+#define SE_HELSTAT_TIME_DETAILS	3	/* ... spent on the details of the event */
+#define SE_HELSTAT_NVISLIM	4	/* calls of swe_vis_limit_mag() */
+#define SE_HELSTAT_NVISLIM_MEMO	5	/* ... of which were remembered */
+#define SE_HELSTAT_NLOC		6	/* object positions */
+#define SE_HELSTAT_NLOC_MEMO	7	/* ... of which were remembered */
+#define SE_HELSTAT_NMAG		8	/* object magnitudes */
+#define SE_HELSTAT_NMAG_MEMO	9	/* ... of which were remembered */
+#define SE_HELSTAT_NSKY		10	/* extinction and sky brightness evaluations */
+#define SE_HELSTAT_NSKY_MEMO	11	/* ... of which were remembered */
+#define SE_HELSTAT_NRISE	12	/* risings and settings */
+#define SE_HELSTAT_NRISE_MEMO	13	/* ... of which were remembered */
+#define SE_NHELSTATS		14
+ext_def(int32) swe_heliacal_stats(double *dstat, int32 nstat);
+
+/* heliacal events of nobj objects between tjd_start and tjd_end, 5 doubles per event */
+ext_def(int32) swe_heliacal_range(double tjd_start, double tjd_end, double *geopos, double *datm, double *dobs, char *ObjectNames, int32 nobj, int32 *TypeEvents, int32 ntypes, int32 helflag, double *dret, int32 nret, char *serr);
+
 /* the following are secret, for Victor Reijs' */
 ext_def(int32) swe_heliacal_angle(double tjdut, double *dgeo, double *datm, double *dobs, int32 helflag, double mag, double azi_obj, double azi_sun, double azi_moon, double alt_moon, double *dret, char *serr);
 ext_def(int32) swe_topo_arcus_visionis(double tjdut, double *dgeo, double *datm, double *dobs, int32 helflag, double mag, double azi_obj, double alt_obj, double azi_sun, double azi_moon, double alt_moon, double *dret, char *serr);
@@ -745,12 +772,34 @@ ext_def( void ) swe_close(void);
 /* set directory path of ephemeris files */
 ext_def( void ) swe_set_ephe_path(const char *path);
 
+/* counters of the internal caches, see swe_get_cache_stats() */
+#define SE_STAT_FOPEN		0	/* files requested from the ephemeris path */
+#define SE_STAT_FOPEN_MISS	1	/* ... of which were not found */
+#define SE_STAT_FOPEN_PROBE	2	/* fopen() calls on the file system */
+#define SE_STAT_FOPEN_CACHED	3	/* requests resolved by the path cache */
+/* the following count the calling thread only */
+#define SE_STAT_PREC		4	/* precession matrices requested */
+#define SE_STAT_PREC_CACHED	5	/* ... of which were cached */
+#define SE_STAT_OBSERVER	6	/* topocentric observer positions requested */
+#define SE_STAT_OBSERVER_CACHED	7	/* ... of which were cached */
+#define SE_STAT_CALC		8	/* swe_calc() results looked up */
+#define SE_STAT_CALC_CACHED	9	/* ... of which were cached */
+#define SE_NSTATS		10
+ext_def(int32) swe_get_cache_stats(int64 *stats, int32 nstats);
+ext_def(void) swe_reset_cache_stats(void);
+
+/* number of swe_calc() results kept per thread; 0: off, < 0: default */
+ext_def(void) swe_set_calc_cache(int32 nentries);
+
 /* set file name of JPL file */
 ext_def( void ) swe_set_jpl_file(const char *fname);
 
 /* get planet name */
 ext_def( char *) swe_get_planet_name(int ipl, char *spname);
 
+/* get names of n bodies, spname must hold n * AS_MAXCH chars */
+ext_def(void) swe_get_planet_name_arr(int *ipl, int32 n, char *spname);
+
 /* set geographic position of observer */
 ext_def (void) swe_set_topo(double geolon, double geolat, double geoalt);
 
@@ -803,6 +852,13 @@ ext_def(void) swe_jdut1_to_utc(
 	int32 *iyear, int32 *imonth, int32 *iday, 
 	int32 *ihour, int32 *imin, double *dsec);
 
+/* array versions of the above, for many dates at a time */
+ext_def(void) swe_julday_arr(double *date, int32 n, int gregflag, double *tjd);
+ext_def(void) swe_revjul_arr(double *tjd, int32 n, int gregflag, double *date);
+ext_def(int32) swe_utc_to_jd_arr(double *utc, int32 n, int32 gregflag, double *dret, char *serr);
+ext_def(void) swe_jdet_to_utc_arr(double *tjd_et, int32 n, int32 gregflag, double *utc);
+ext_def(void) swe_set_read_table_files(AS_BOOL do_read);
+
 ext_def(void) swe_utc_time_zone(
         int32 iyear, int32 imonth, int32 iday,
 	int32 ihour, int32 imin, double dsec,
@@ -846,6 +902,7 @@ ext_def(const char *) swe_house_name(int hsys);
  ****************************/
 
 ext_def(int32) swe_gauquelin_sector(double t_ut, int32 ipl, char *starname, int32 iflag, int32 imeth, double *geopos, double atpress, double attemp, double *dgsect, char *serr);
+ext_def(int32) swe_gauquelin_sector_arr(double *tjd_ut, double *geopos, int32 nrec, int32 *ipl, int32 nipl, int32 iflag, int32 imeth, double atpress, double attemp, int32 nthreads, double *dgsect, char *serr);
 
 /* computes geographic location and attributes of solar 
  * eclipse at a given tjd */
@@ -884,11 +941,30 @@ ext_def (int32) swe_lun_eclipse_when(double tjd_start, int32 ifl, int32 ifltype,
 ext_def (int32) swe_lun_eclipse_when_loc(double tjd_start, int32 ifl, 
      double *geopos, double *tret, double *attr, int32 backward, char *serr);
 
+/* precomputed catalog of eclipses and occultations, file SE_ECLCATFILE */
+ext_def (int32) swe_ecl_catalog_make(double tjd_start, double tjd_end, 
+     int32 *ipl, int32 nipl, int32 ifl, char *dir, char *serr);
+
+ext_def (int32) swe_ecl_catalog_when(double tjd_start, int32 ipl, int32 ifl, int32 ifltype,
+     double *tret, double *attr, int32 backward, char *serr);
+
+/* all eclipses or occultations in a range of dates, searched by nthreads threads */
+ext_def (int32) swe_ecl_when_range(double tjd_start, double tjd_end, int32 ipl, int32 ifl, 
+     int32 ifltype, int32 nthreads, int32 *retflag, double *tret, int32 nmax, char *serr);
+
+/* local circumstances of a solar eclipse for many observers */
+ext_def (int32) swe_sol_eclipse_loc_arr(double tjd_start, double tjd_end, double dt, int32 ifl,
+     double *geopos, int32 n, double *dret, char *serr);
+
 /* planetary phenomena */
 ext_def (int32) swe_pheno(double tjd, int32 ipl, int32 iflag, double *attr, char *serr);
  
 ext_def(int32) swe_pheno_ut(double tjd_ut, int32 ipl, int32 iflag, double *attr, char *serr);
 
+ext_def(int32) swe_pheno_arr(double tjd, int32 *ipl, int32 nipl, int32 iflag, double *attr, char *serr);
+
+ext_def(int32) swe_pheno_ut_arr(double tjd_ut, int32 *ipl, int32 nipl, int32 iflag, double *attr, char *serr);
+
 ext_def (double) swe_refrac(double inalt, double atpress, double attemp, int32 calc_flag);
 
 ext_def (double) swe_refrac_extended(double inalt, double geoalt, double atpress, double attemp, double lapse_rate, int32 calc_flag, double *dret);
@@ -911,6 +987,28 @@ ext_def (void) swe_azalt_rev(
       double *xin, 
       double *xout); 
 
+/* swe_azalt() for many positions at one date, or for one position per date;
+ * xin and xaz hold 3 doubles per position */
+ext_def (void) swe_azalt_arr(
+      double tjd_ut,
+      int32 calc_flag,
+      double *geopos,
+      double atpress,
+      double attemp,
+      double *xin, 
+      int32 n,
+      double *xaz); 
+
+ext_def (void) swe_azalt_times(
+      double *tjd_ut,
+      int32 n,
+      int32 calc_flag,
+      double *geopos,
+      double atpress,
+      double attemp,
+      double *xin, 
+      double *xaz); 
+
 ext_def (int32) swe_rise_trans_true_hor(
                double tjd_ut, int32 ipl, char *starname, 
 	       int32 epheflag, int32 rsmi,
@@ -939,11 +1037,26 @@ ext_def (int32) swe_nod_aps_ut(double tjd_ut, int32 ipl, int32 iflag,
                       double *xnasc, double *xndsc, 
                       double *xperi, double *xaphe, 
                       char *serr);
+
+/* nodes and apsides of many planets at one date, or of one planet at many
+ * dates; xret holds 24 doubles per planet or date */
+ext_def (int32) swe_nod_aps_arr(double tjd_et, int32 *ipl, int32 nipl, 
+                      int32 iflag, int32 method, double *xret, char *serr);
+
+ext_def (int32) swe_nod_aps_times(double *tjd_et, int32 n, int32 ipl, 
+                      int32 iflag, int32 method, double *xret, char *serr);
+
 ext_def (int32) swe_get_orbital_elements(
   double tjd_et, int32 ipl, int32 iflag, double *dret, char *serr);
 
 ext_def (int32) swe_orbit_max_min_true_distance(double tjd_et, int32 ipl, int32 iflag, double *dmax, double *dmin, double *dtrue, char *serr);
 
+ext_def (int32) swe_get_orbital_elements_arr(double tjd_et, int32 *ipl, int32 nipl, 
+                      int32 iflag, double *dret, char *serr);
+
+ext_def (int32) swe_orbit_max_min_true_distance_arr(double tjd_et, int32 *ipl, int32 nipl, 
+                      int32 iflag, double *dret, char *serr);
+
 /**************************** 
  * exports from swephlib.c 
  ****************************/
@@ -974,6 +1087,12 @@ ext_def( void ) swe_set_tid_acc(double t_acc);
  * swe_deltat() and swe_deltat_ex() */
 ext_def (void) swe_set_delta_t_userdef(double dt);
 
+/* interpolate delta t from a precomputed spline table */
+ext_def( void ) swe_set_interpolate_deltat(AS_BOOL do_interpolate);
+
+/* interpolate sun and moon in eclipse and occultation searches */
+ext_def( void ) swe_set_interpolate_ecl(AS_BOOL do_interpolate);
+
 ext_def( double ) swe_degnorm(double x);
 ext_def( double ) swe_radnorm(double x);
 ext_def( double ) swe_rad_midp(double x1, double x0);
@@ -77,6 +77,9 @@
 #include "swephexp.h"
 #include "sweph.h"
 #include "swephlib.h"
+#ifdef SE_BUILTIN_TABLES
+# include "sedeltat.h"
+#endif
 #if MSDOS
 # include <process.h>
 # define strdup _strdup
@@ -98,6 +101,8 @@ static double deltat_longterm_morrison_stephenson(double tjd);
 static double deltat_stephenson_morrison_2004_1600(double tjd, double tid_acc);
 static double deltat_stephenson_morrison_1997_1600(double tjd, double tid_acc);
 static double deltat_aa(double tjd, double tid_acc);
+static double deltat_by_model(double tjd, int32 iflag, int deltat_model, double tid_acc);
+static int deltat_from_spline(double tjd, int deltat_model, double tid_acc, double *deltat);
 
 #define SEFLG_EPHMASK   (SEFLG_JPLEPH|SEFLG_SWIEPH|SEFLG_MOSEPH)
 
@@ -1358,19 +1363,8 @@ static int precess_3(double *R, double J, int direction, int iflag, int prec_met
   return(0);
 }
 
-/* Subroutine arguments:
- *
- * R = rectangular equatorial coordinate vector to be precessed.
- *     The result is written back into the input vector.
- * J = Julian date
- * direction =
- *      Precess from J to J2000: direction = 1
- *      Precess from J2000 to J: direction = -1
- * Note that if you want to precess from J1 to J2, you would
- * first go from J1 to J2000, then call the program again
- * to go from J2000 to J2.
- */
-int swi_precess(double *R, double J, int32 iflag, int direction )
+/* the precession model used for date J */
+static int precess_method(double J, int32 iflag)
 {
   double T = (J - J2000)/36525.0;
   int prec_model = swed.astro_models[SE_MODEL_PREC_LONGTERM];
@@ -1390,43 +1384,224 @@ int swi_precess(double *R, double J, int32 iflag, int direction )
    * some correction to nutation, arriving at extremely high precision */
   if (is_jplhor) {
     if (J > 2378131.5 && J < 2525323.5) { // between 1.1.1799 and 1.1.2202
-      return precess_1(R, J, direction, SEMOD_PREC_IAU_1976);
+      return SEMOD_PREC_IAU_1976;
     } else { 
-      return precess_3(R, J, direction, iflag, SEMOD_PREC_OWEN_1990);
+      return SEMOD_PREC_OWEN_1990;
     }
   /* Use IAU 1976 formula for a few centuries.  */
   } else if (prec_model_short == SEMOD_PREC_IAU_1976 && fabs(T) <= PREC_IAU_1976_CTIES) {
-    return precess_1(R, J, direction, SEMOD_PREC_IAU_1976);
+    return SEMOD_PREC_IAU_1976;
   } else if (prec_model == SEMOD_PREC_IAU_1976) {
-    return precess_1(R, J, direction, SEMOD_PREC_IAU_1976);
+    return SEMOD_PREC_IAU_1976;
   /* Use IAU 2000 formula for a few centuries.  */
   } else if (prec_model_short == SEMOD_PREC_IAU_2000 && fabs(T) <= PREC_IAU_2000_CTIES) {
-    return precess_1(R, J, direction, SEMOD_PREC_IAU_2000);
+    return SEMOD_PREC_IAU_2000;
   } else if (prec_model == SEMOD_PREC_IAU_2000) {
-    return precess_1(R, J, direction, SEMOD_PREC_IAU_2000);
+    return SEMOD_PREC_IAU_2000;
   /* Use IAU 2006 formula for a few centuries.  */
   } else if (prec_model_short == SEMOD_PREC_IAU_2006 && fabs(T) <= PREC_IAU_2006_CTIES) {
-    return precess_1(R, J, direction, SEMOD_PREC_IAU_2006);
+    return SEMOD_PREC_IAU_2006;
   } else if (prec_model == SEMOD_PREC_IAU_2006) {
-    return precess_1(R, J, direction, SEMOD_PREC_IAU_2006);
+    return SEMOD_PREC_IAU_2006;
   } else if (prec_model == SEMOD_PREC_BRETAGNON_2003) {
-    return precess_1(R, J, direction, SEMOD_PREC_BRETAGNON_2003);
+    return SEMOD_PREC_BRETAGNON_2003;
   } else if (prec_model == SEMOD_PREC_NEWCOMB) {
-    return precess_1(R, J, direction, SEMOD_PREC_NEWCOMB);
+    return SEMOD_PREC_NEWCOMB;
   } else if (prec_model == SEMOD_PREC_LASKAR_1986) {
-    return precess_2(R, J, iflag, direction, SEMOD_PREC_LASKAR_1986);
+    return SEMOD_PREC_LASKAR_1986;
   } else if (prec_model == SEMOD_PREC_SIMON_1994) {
-    return precess_2(R, J, iflag, direction, SEMOD_PREC_SIMON_1994);
+    return SEMOD_PREC_SIMON_1994;
   } else if (prec_model == SEMOD_PREC_WILLIAMS_1994 || prec_model == SEMOD_PREC_WILL_EPS_LASK) {
-    return precess_2(R, J, iflag, direction, SEMOD_PREC_WILLIAMS_1994);
+    return SEMOD_PREC_WILLIAMS_1994;
   } else if (prec_model == SEMOD_PREC_OWEN_1990) { 
-    return precess_3(R, J, direction, iflag, SEMOD_PREC_OWEN_1990);
+    return SEMOD_PREC_OWEN_1990;
   } else { /* SEMOD_PREC_VONDRAK_2011 */
-    //int i;
-    //int retval = precess_3(R, J, direction, iflag, SEMOD_PREC_VONDRAK_2011);
-    // for (i = 0; i < 3; i++) printf("%.9f, ", R[i]);
-    return precess_3(R, J, direction, iflag, SEMOD_PREC_VONDRAK_2011);
+    return SEMOD_PREC_VONDRAK_2011;
+  }
+}
+
+static int precess_uncached(double *R, double J, int32 iflag, int direction)
+{
+  int prec_method = precess_method(J, iflag);
+  switch (prec_method) {
+    case SEMOD_PREC_LASKAR_1986:
+    case SEMOD_PREC_SIMON_1994:
+    case SEMOD_PREC_WILLIAMS_1994:
+      return precess_2(R, J, iflag, direction, prec_method);
+    case SEMOD_PREC_OWEN_1990:
+    case SEMOD_PREC_VONDRAK_2011:
+      return precess_3(R, J, direction, iflag, prec_method);
+    default:
+      return precess_1(R, J, direction, prec_method);
+  }
+}
+
+/* 
+ * Cache of precession matrices.
+ * Within one swe_calc() and for all bodies computed at the same date,
+ * swi_precess() is called many times with the same date and direction,
+ * and with dates that differ from it by the light-time or by the
+ * interval of the speed computation. The matrix of the rotation is 
+ * built once and kept with its time derivative, keyed on everything 
+ * that selects the precession model. Dates within PREC_CACHE_DT days 
+ * of a cached one are served by the linear term; the error of this is 
+ * below 1e-12 radians.
+ */
+#define PREC_CACHE_N	4
+#define PREC_CACHE_DT	1.0
+struct prec_cache_entry {
+  double J;
+  int32 direction, key[4];
+  double m[9];		/* x_out[i] = sum m[i*3+j] * x_in[j] */
+  double dm[9];		/* derivative of m per day */
+  AS_BOOL have_dm;
+  double rate;		/* precession in longitude, radians per day, or 0 */
+};
+static TLS struct {
+  int n, next;
+  struct prec_cache_entry e[PREC_CACHE_N];
+  struct prec_cache_entry near;	/* result for a date near a cached one */
+  int64 stats[2];	/* SE_STAT_PREC, SE_STAT_PREC_CACHED */
+} prec_cache;
+
+void swi_prec_cache_clear(void)
+{
+  prec_cache.n = 0;
+  prec_cache.next = 0;
+}
+
+void swi_prec_cache_stats(int64 *stats, AS_BOOL reset)
+{
+  if (stats != NULL) {
+    stats[0] = prec_cache.stats[0];
+    stats[1] = prec_cache.stats[1];
+  }
+  if (reset)
+    prec_cache.stats[0] = prec_cache.stats[1] = 0;
+}
+
+/* builds the precession matrix for J and direction */
+static void prec_matrix(double J, int32 iflag, int direction, double *m)
+{
+  int i, prec_method;
+  double x[3], pmat[9];
+  prec_method = precess_method(J, iflag);
+  if (prec_method == SEMOD_PREC_OWEN_1990 || prec_method == SEMOD_PREC_VONDRAK_2011) {
+    /* as in precess_3() */
+    if (prec_method == SEMOD_PREC_OWEN_1990)
+      owen_pre_matrix(J, pmat, iflag);
+    else
+      pre_pmat(J, pmat);
+    for (i = 0; i < 9; i++)
+      m[i] = (direction == -1) ? pmat[i] : pmat[(i % 3) * 3 + i / 3];
+    return;
+  }
+  /* columns of the matrix are the images of the unit vectors */
+  for (i = 0; i < 3; i++) {
+    x[0] = x[1] = x[2] = 0;
+    x[i] = 1;
+    precess_uncached(x, J, iflag, direction);
+    m[i] = x[0];
+    m[3 + i] = x[1];
+    m[6 + i] = x[2];
+  }
+}
+
+static struct prec_cache_entry *prec_cache_get(double J, int32 iflag, int direction)
+{
+  int i;
+  int32 key[4];
+  double m2[9];
+  struct prec_cache_entry *e, *near = NULL;
+  key[0] = swed.astro_models[SE_MODEL_PREC_LONGTERM];
+  key[1] = swed.astro_models[SE_MODEL_PREC_SHORTTERM];
+  key[2] = swed.astro_models[SE_MODEL_JPLHORA_MODE];
+  key[3] = iflag & (SEFLG_JPLHOR | SEFLG_JPLHOR_APPROX);
+  prec_cache.stats[0]++;
+  for (i = 0; i < prec_cache.n; i++) {
+    e = &prec_cache.e[i];
+    if (e->direction != direction || e->key[0] != key[0] || e->key[1] != key[1]
+      || e->key[2] != key[2] || e->key[3] != key[3])
+      continue;
+    if (e->J == J) {
+      prec_cache.stats[1]++;
+      return e;
+    }
+    /* the model may change with the date, see precess_method() */
+    if (near == NULL && fabs(J - e->J) <= PREC_CACHE_DT
+      && precess_method(J, iflag) == precess_method(e->J, iflag))
+      near = e;
+  }
+  if (near != NULL) {
+    prec_cache.stats[1]++;
+    if (!near->have_dm) {
+      prec_matrix(near->J + PREC_CACHE_DT, iflag, direction, m2);
+      for (i = 0; i < 9; i++)
+        near->dm[i] = (m2[i] - near->m[i]) / PREC_CACHE_DT;
+      near->have_dm = TRUE;
+    }
+    e = &prec_cache.near;
+    for (i = 0; i < 9; i++)
+      e->m[i] = near->m[i] + near->dm[i] * (J - near->J);
+    e->J = J;
+    e->rate = 0;
+    return e;
+  }
+  e = &prec_cache.e[prec_cache.next];
+  prec_cache.next = (prec_cache.next + 1) % PREC_CACHE_N;
+  if (prec_cache.n < PREC_CACHE_N)
+    prec_cache.n++;
+  prec_matrix(J, iflag, direction, e->m);
+  e->J = J;
+  e->direction = direction;
+  for (i = 0; i < 4; i++)
+    e->key[i] = key[i];
+  e->have_dm = FALSE;
+  e->rate = 0;
+  return e;
+}
+
+/* Subroutine arguments:
+ *
+ * R = rectangular equatorial coordinate vector to be precessed.
+ *     The result is written back into the input vector.
+ * J = Julian date
+ * direction =
+ *      Precess from J to J2000: direction = 1
+ *      Precess from J2000 to J: direction = -1
+ * Note that if you want to precess from J1 to J2, you would
+ * first go from J1 to J2000, then call the program again
+ * to go from J2000 to J2.
+ */
+int swi_precess(double *R, double J, int32 iflag, int direction )
+{
+  double x[3];
+  double *m;
+  int i;
+  if (J == J2000)
+    return(0);
+  m = prec_cache_get(J, iflag, direction)->m;
+  for (i = 0; i < 3; i++)
+    x[i] = m[i * 3] * R[0] + m[i * 3 + 1] * R[1] + m[i * 3 + 2] * R[2];
+  for (i = 0; i < 3; i++)
+    R[i] = x[i];
+  return(0);
+}
+
+/* 
+ * Rate of the Vondrak 2011 precession in longitude at J, radians per day,
+ * as used by swi_precess_speed()
+ */
+double swi_precess_rate(double J, int32 iflag, int direction)
+{
+  double dpre, dpre2;
+  struct prec_cache_entry *e = prec_cache_get(J, iflag, direction);
+  if (e->rate == 0) {
+    swi_ldp_peps(J, &dpre, NULL);
+    swi_ldp_peps(J + 1, &dpre2, NULL);
+    e->rate = dpre2 - dpre;
   }
+  return e->rate;
 }
 
 /* Nutation in longitude and obliquity
@@ -2428,6 +2603,9 @@ void swi_icrs2fk5(double *x, int32 iflag, AS_BOOL backward)
 #define TABSIZ 		(TABEND-TABSTART+1) 
 /* we make the table greater for additional values read from external file */
 #define TABSIZ_SPACE 	(TABSIZ+100)
+/* the table as compiled, before values from file were merged */
+static TLS double dt_saved[TABSIZ_SPACE];
+static TLS AS_BOOL dt_is_saved = FALSE;
 static TLS double dt[TABSIZ_SPACE] = {
 /* 1620.0 - 1659.0 */
 124.00, 119.00, 115.00, 110.00, 106.00, 102.00, 98.00, 95.00, 91.00, 88.00,
@@ -2544,9 +2722,6 @@ static const short dt97[TAB97_SIZ] = {
 #define DEMO 0
 static int32 calc_deltat(double tjd, int32 iflag, double *deltat, char *serr)
 {
-  double ans = 0;
-  double B, Y, Ygreg, dd;
-  int iy;
   int32 retc;
   int deltat_model = swed.astro_models[SE_MODEL_DELTAT];
   double tid_acc;
@@ -2573,6 +2748,21 @@ static int32 calc_deltat(double tjd, int32 iflag, double *deltat, char *serr)
     tid_acc = swed.tid_acc;
   }
   iflag = otherflag | retc;
+  if (swed.do_interpolate_deltat 
+    && deltat_from_spline(tjd, deltat_model, tid_acc, deltat) == OK)
+    return iflag;
+  *deltat = deltat_by_model(tjd, iflag, deltat_model, tid_acc);
+  return iflag;
+}
+
+/* Delta T according to model deltat_model, for a given tidal acceleration.
+ * This is called by calc_deltat() and when the Delta T spline table 
+ * is made. */
+static double deltat_by_model(double tjd, int32 iflag, int deltat_model, double tid_acc)
+{
+  double ans = 0;
+  double B, Y, Ygreg, dd;
+  int iy;
   Y = 2000.0 + (tjd - J2000)/365.25;
   Ygreg = 2000.0 + (tjd - J2000)/365.2425;
   /* Model for epochs before 1955, currently default in Swiss Ephemeris:
@@ -2587,11 +2777,11 @@ static int32 calc_deltat(double tjd, int32 iflag, double *deltat, char *serr)
    * (or Astronomical Almanac K8-K9).
    */
   if (deltat_model == SEMOD_DELTAT_STEPHENSON_ETC_2016 && tjd < 2435108.5) { // tjd < 2432521.453645833) {
-    *deltat = deltat_stephenson_etc_2016(tjd, tid_acc);
+    ans = deltat_stephenson_etc_2016(tjd, tid_acc);
     if (tjd >= 2434108.5) {
-      *deltat += (1.0 - (2435108.5 - tjd) / 1000.0) * 0.6610218 / 86400.0;
+      ans += (1.0 - (2435108.5 - tjd) / 1000.0) * 0.6610218 / 86400.0;
     }
-    return iflag;
+    return ans;
   }
   /* Model used SE 1.77 - 2.05.01, for epochs before 1633:
    * Polynomials by Espenak & Meeus 2006, 
@@ -2601,8 +2791,7 @@ static int32 calc_deltat(double tjd, int32 iflag, double *deltat, char *serr)
    * epochs, we use the data provided by Astronomical Almanac K8-K9.)
    */
   if (deltat_model == SEMOD_DELTAT_ESPENAK_MEEUS_2006 && tjd < 2317746.13090277789) {
-    *deltat = deltat_espenak_meeus_1620(tjd, tid_acc);
-    return iflag;
+    return deltat_espenak_meeus_1620(tjd, tid_acc);
   }
   /* delta t model used in SE 1.72 - 1.76:
    * Stephenson & Morrison 2004;
@@ -2610,8 +2799,7 @@ static int32 calc_deltat(double tjd, int32 iflag, double *deltat, char *serr)
   if (deltat_model == SEMOD_DELTAT_STEPHENSON_MORRISON_2004 && Y < TABSTART) {
     // before 1600: 
     if (Y < TAB2_END) {
-      *deltat = deltat_stephenson_morrison_2004_1600(tjd, tid_acc);
-      return iflag;
+      return deltat_stephenson_morrison_2004_1600(tjd, tid_acc);
     } else {
       /* between 1600 and 1620:
        * linear interpolation between 
@@ -2622,8 +2810,7 @@ static int32 calc_deltat(double tjd, int32 iflag, double *deltat, char *serr)
 	dd = (Y - TAB2_END) / B;
 	ans = dt2[iy] + dd * (dt[0] - dt2[iy]);
 	ans = adjust_for_tidacc(ans, Ygreg, tid_acc, SE_TIDAL_26, FALSE);
-	*deltat = ans / 86400.0;
-	return iflag;
+	return ans / 86400.0;
       }
     }
   }
@@ -2633,8 +2820,7 @@ static int32 calc_deltat(double tjd, int32 iflag, double *deltat, char *serr)
   if (deltat_model == SEMOD_DELTAT_STEPHENSON_1997 && Y < TABSTART) {
     // before 1600: 
     if (Y < TAB97_END) {
-      *deltat = deltat_stephenson_morrison_1997_1600(tjd, tid_acc);
-      return iflag;
+      return deltat_stephenson_morrison_1997_1600(tjd, tid_acc);
     } else {
       /* between 1600 and 1620:
        * linear interpolation between 
@@ -2645,8 +2831,7 @@ static int32 calc_deltat(double tjd, int32 iflag, double *deltat, char *serr)
 	dd = (Y - TAB97_END) / B;
 	ans = dt97[iy] + dd * (dt[0] - dt97[iy]);
 	ans = adjust_for_tidacc(ans, Ygreg, tid_acc, SE_TIDAL_26, FALSE);
-	*deltat = ans / 86400.0;
-	return iflag;
+	return ans / 86400.0;
       }
     }
   }
@@ -2664,8 +2849,7 @@ static int32 calc_deltat(double tjd, int32 iflag, double *deltat, char *serr)
       B = 0.01 * (Y - 2000.0)  +  3.75;
       ans = 35.0 * B * B  +  40.;
     }
-    *deltat = ans / 86400.0;
-    return iflag;
+    return ans / 86400.0;
   }
   /* 1620 - today + a few years (tabend):
    * Tabulated values of deltaT from Astronomical Almanac 
@@ -2673,8 +2857,7 @@ static int32 calc_deltat(double tjd, int32 iflag, double *deltat, char *serr)
    * (http://maia.usno.navy.mil/ser7/deltat.data).
    */
   if (Y >= TABSTART) {
-    *deltat = deltat_aa(tjd, tid_acc);
-    return iflag;
+    return deltat_aa(tjd, tid_acc);
   }
 #ifdef TRACE
   swi_open_trace(NULL);
@@ -2694,8 +2877,7 @@ static int32 calc_deltat(double tjd, int32 iflag, double *deltat, char *serr)
     }
   }
 #endif
-  *deltat = ans / 86400.0;
-  return iflag;
+  return ans / 86400.0;
 }
 
 double CALL_CONV swe_deltat_ex(double tjd, int32 iflag, char *serr)
@@ -3097,6 +3279,25 @@ char s[AS_MAXCH];
 char *sp;
 if (!swed.init_dt_done) {
   swed.init_dt_done = TRUE;
+  /* values from an earlier initialisation are replaced */
+  if (!dt_is_saved) {
+    memcpy(dt_saved, dt, sizeof(dt));
+    dt_is_saved = TRUE;
+  } else {
+    memcpy(dt, dt_saved, sizeof(dt));
+  }
+  swi_free_deltat_spline();
+#ifdef SE_BUILTIN_TABLES
+  /* delta t values compiled in from swe_deltat.txt by gen_tables.rb */
+  for (i = 0; i < SWI_BUILTIN_NDELTAT; i++) {
+    tab_index = (int) swi_builtin_deltat[i][0] - TABSTART;
+    if (tab_index >= 0 && tab_index < TABSIZ_SPACE)
+      dt[tab_index] = swi_builtin_deltat[i][1];
+  }
+  /* the file is only read if swe_set_read_table_files(TRUE) was called */
+  if (!swed.read_table_files)
+    goto find_tabsiz;
+#endif
   /* no error message if file is missing */
   if ((fp = swi_fopen(-1, "swe_deltat.txt", swed.ephepath, NULL)) == NULL
     && (fp = swi_fopen(-1, "sedeltat.txt", swed.ephepath, NULL)) == NULL)
@@ -3120,6 +3321,9 @@ if (!swed.init_dt_done) {
   }
   fclose(fp);
 }
+#ifdef SE_BUILTIN_TABLES
+find_tabsiz:
+#endif
 /* find table size */
 tabsiz = 2001 - TABSTART + 1;
 for (i = tabsiz - 1; i < TABSIZ_SPACE; i++) {
@@ -3164,6 +3368,9 @@ double CALL_CONV swe_get_tid_acc()
  */
 void CALL_CONV swe_set_tid_acc(double t_acc)
 {
+  double t_new = (t_acc == SE_TIDAL_AUTOMATIC) ? SE_TIDAL_DEFAULT : t_acc;
+  if (t_new != swed.tid_acc)
+    swi_free_deltat_spline();
   if (t_acc == SE_TIDAL_AUTOMATIC) {
     swed.tid_acc = SE_TIDAL_DEFAULT;
     swed.is_tid_acc_manual = FALSE;
@@ -3183,6 +3390,114 @@ void CALL_CONV swe_set_delta_t_userdef(double dt)
   }
 }
 
+/* Delta T spline table.
+ * With swe_set_interpolate_deltat(TRUE), Delta T is not computed from
+ * the models above with every call but interpolated from a table of
+ * values which is made once for the current Delta T model and tidal 
+ * acceleration. The table has nodes in steps of 1/16 year between 
+ * 1600 and 2200 and in steps of 2 years before and after. Interpolation 
+ * is done with a cubic (Catmull-Rom) spline through four nodes. 
+ * Compared with the default model (Stephenson/Morrison/Hohenkerk 2016),
+ * the error is below 0.002 sec after 1600 and below 1 sec before.
+ * With the older models, it is below 0.01 sec after 1620, but errors
+ * of a few seconds occur before 1600,
+ * near the kinks of their linearly interpolated tables, and within
+ * one step of the discontinuity in 1620.
+ * The table is made per thread, like the table dt[], which can be 
+ * extended from file swe_deltat.txt in the ephemeris path.
+ * It is freed by swe_close() and whenever the source of Delta T
+ * (model, tidal acceleration, table dt[]) changes.
+ */
+void swi_free_deltat_spline(void)
+{
+  int i;
+  for (i = 0; i < DTSPL_NREGIONS; i++) {
+    if (swed.dtspl.f[i] != NULL)
+      free(swed.dtspl.f[i]);
+    swed.dtspl.f[i] = NULL;
+  }
+  swed.dtspl.deltat_model = 0;
+}
+
+static int make_deltat_spline(int deltat_model, double tid_acc, int tabsiz)
+{
+  int i, j;
+  double tend, *f;
+  struct deltat_spline *dsp = &swed.dtspl;
+  swi_free_deltat_spline();
+  dsp->tstart[0] = DTSPL_TJD_START;
+  dsp->step[0] = DTSPL_STEP_COARSE;
+  dsp->tstart[1] = DTSPL_TJD_FINE0;
+  dsp->step[1] = DTSPL_STEP_FINE;
+  dsp->tstart[2] = DTSPL_TJD_FINE1;
+  dsp->step[2] = DTSPL_STEP_COARSE;
+  for (i = 0; i < DTSPL_NREGIONS; i++) {
+    if (i < DTSPL_NREGIONS - 1)
+      tend = dsp->tstart[i+1];
+    else
+      tend = DTSPL_TJD_END;
+    dsp->n[i] = (int) ceil((tend - dsp->tstart[i]) / dsp->step[i]);
+    /* one additional node before and two after the region */
+    if ((f = (double *) malloc((size_t) (dsp->n[i] + 3) * sizeof(double))) == NULL) {
+      swi_free_deltat_spline();
+      return ERR;
+    }
+    for (j = 0; j < dsp->n[i] + 3; j++)
+      f[j] = deltat_by_model(dsp->tstart[i] + (j - 1) * dsp->step[i], 0, deltat_model, tid_acc);
+    dsp->f[i] = f;
+  }
+  dsp->deltat_model = deltat_model;
+  dsp->tid_acc = tid_acc;
+  dsp->tabsiz = tabsiz;
+  return OK;
+}
+
+/* returns ERR if tjd is outside the table or the table cannot be made;
+ * Delta T must then be computed from the model. */
+static int deltat_from_spline(double tjd, int deltat_model, double tid_acc, double *deltat)
+{
+  int i, j;
+  double p, *f;
+  struct deltat_spline *dsp = &swed.dtspl;
+  /* init_dt() may extend table dt[] from file */
+  int tabsiz = init_dt();
+  if (tjd < DTSPL_TJD_START || tjd >= DTSPL_TJD_END)
+    return ERR;
+  if (dsp->deltat_model != deltat_model || dsp->tid_acc != tid_acc 
+    || dsp->tabsiz != tabsiz) {
+    if (make_deltat_spline(deltat_model, tid_acc, tabsiz) == ERR)
+      return ERR;
+  }
+  if (tjd < DTSPL_TJD_FINE0) 
+    i = 0;
+  else if (tjd < DTSPL_TJD_FINE1) 
+    i = 1;
+  else 
+    i = 2;
+  p = (tjd - dsp->tstart[i]) / dsp->step[i];
+  j = (int) floor(p);
+  if (j >= dsp->n[i]) j = dsp->n[i] - 1;
+  p -= j;
+  /* nodes j-1, j, j+1, j+2 are at f[j], ... f[j+3] */
+  f = dsp->f[i] + j;
+  *deltat = f[1] + 0.5 * p * (f[2] - f[0] 
+     + p * (2.0 * f[0] - 5.0 * f[1] + 4.0 * f[2] - f[3] 
+     + p * (3.0 * (f[1] - f[2]) + f[3] - f[0])));
+  return OK;
+}
+
+/* switches interpolation of Delta T from a spline table on or off,
+ * see comment on swi_free_deltat_spline() */
+void CALL_CONV swe_set_interpolate_deltat(AS_BOOL do_interpolate)
+{
+  if (do_interpolate) {
+    swed.do_interpolate_deltat = TRUE;
+  } else {
+    swed.do_interpolate_deltat = FALSE;
+    swi_free_deltat_spline();
+  }
+}
+
 int32 swi_guess_ephe_flag()
 {
   int32 iflag = SEFLG_SWIEPH;
@@ -4121,6 +4436,10 @@ void set_astro_models(char *samod)
   char *sp, *sp2;
   int i = 0;
   swi_init_swed_if_start();
+  swi_ecl_track_clear();
+  swi_prec_cache_clear();
+  swi_observer_cache_clear();
+  swi_free_deltat_spline();
   sp = samod;
   pmodel[0] = atoi(sp);
   i++;
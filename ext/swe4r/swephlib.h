@@ -114,6 +114,9 @@ extern void swi_icrs2fk5(double *x, int32 iflag, AS_BOOL backward);
 
 /* precession */
 extern int swi_precess(double *R, double J, int32 iflag, int direction );
+extern double swi_precess_rate(double J, int32 iflag, int direction);
+extern void swi_prec_cache_clear(void);
+extern void swi_prec_cache_stats(int64 *stats, AS_BOOL reset);
 extern void swi_precess_speed(double *xx, double t, int32 iflag, int direction);
 
 extern int32 swi_guess_ephe_flag(void);
@@ -126,7 +129,10 @@ extern int swi_trop_ra2sid_lon(double *xin, double *xout, double *xoutr, int32 i
 extern int swi_trop_ra2sid_lon_sosy(double *xin, double *xout, int32 iflag);
 extern int swi_get_observer(double tjd, int32 iflag, 
 	AS_BOOL do_save, double *xobs, char *serr);
+extern void swi_observer_cache_clear(void);
+extern void swi_observer_cache_stats(int64 *stats, AS_BOOL reset);
 extern void swi_force_app_pos_etc(void);
+extern int32 swi_calc_save_area(double tjd, int ipl, int32 iflag, double *xx, char *serr);
 
 /* obliquity of ecliptic */
 extern void swi_check_ecliptic(double tjd, int32 iflag);
@@ -174,6 +180,7 @@ extern char *swi_strcpy(char *to, char *from);
 extern char *swi_strncpy(char *to, char *from, size_t n);
 
 extern double swi_deltat_ephe(double tjd_ut, int32 epheflag);
+extern void swi_free_deltat_spline(void);
 
 #ifdef TRACE
 #  define TRACE_COUNT_MAX         10000
@@ -1,4 +1,6 @@
 require 'test/unit'
+require 'tmpdir'
+require 'fileutils'
 require 'swe4r'
 
 class Swe4rTest < Test::Unit::TestCase
@@ -15,10 +17,554 @@ class Swe4rTest < Test::Unit::TestCase
     assert_equal( [1981, 8, 22, 11.350000005215406], Swe4r::swe_revjul(2444838.972916667) )
   end
   
+  def test_swe_julday_arr
+    dates = [1981, 8, 22, 11.35, -500, 2, 28, 0.0]
+    jds = Swe4r::swe_julday_arr(dates.pack('d*')).unpack('d*')
+    assert_equal([Swe4r::swe_julday(1981, 8, 22, 11.35), Swe4r::swe_julday(-500, 2, 28, 0.0)], jds)
+    assert_equal(Swe4r::swe_julday(-500, 2, 28, 0.0, Swe4r::SE_JUL_CAL), Swe4r::swe_julday_arr(dates.pack('d*'), Swe4r::SE_JUL_CAL).unpack('d*')[1])
+  end
+
+  def test_swe_revjul_arr
+    dates = Swe4r::swe_revjul_arr([2444838.972916667].pack('d*')).unpack('d*')
+    assert_equal(Swe4r::swe_revjul(2444838.972916667), dates)
+  end
+
+  def test_swe_utc_to_jd_arr
+    utc = [2016, 12, 31, 23, 59, 60.5, 2017, 2, 30, 0, 0, 0]
+    jds = Swe4r::swe_utc_to_jd_arr(utc.pack('d*')).unpack('d*')
+    assert_in_delta(2457754.5 + (69.184 - 0.5) / 86400.0, jds[0], 1e-8)
+    assert_equal([0.0, 0.0], jds[2, 2])
+    back = Swe4r::swe_jdet_to_utc_arr([jds[0]].pack('d*')).unpack('d*')
+    assert_equal([2016, 12, 31, 23, 59], back[0, 5])
+    assert_in_delta(60.5, back[5], 1e-3)
+  end
+
+  def test_swe_set_read_table_files
+    utc = [2020, 7, 1, 0, 0, 0].pack('d*')
+    Dir.mktmpdir do |dir|
+      File.write(File.join(dir, 'swe_deltat.txt'), "# test\n2020 100.0\n")
+      Swe4r::swe_set_ephe_path(dir)
+      # also with the spline table, which must be made again
+      [false, true].each do |interpolate|
+        Swe4r::swe_set_interpolate_deltat(interpolate)
+        assert_equal(nil, Swe4r::swe_set_read_table_files(false))
+        builtin = Swe4r::swe_utc_to_jd_arr(utc).unpack('d*')
+        Swe4r::swe_set_read_table_files(true)
+        from_file = Swe4r::swe_utc_to_jd_arr(utc).unpack('d*')
+        # delta t from 69 to about 85 seconds
+        assert_operator((from_file[0] - from_file[1]) - (builtin[0] - builtin[1]), :>, 10.0 / 86400)
+        Swe4r::swe_set_read_table_files(false)
+        assert_equal(builtin, Swe4r::swe_utc_to_jd_arr(utc).unpack('d*'))
+      end
+      Swe4r::swe_set_interpolate_deltat(false)
+    end
+    Swe4r::swe_set_ephe_path('path')
+  end
+
+  def test_builtin_tables
+    utc = [2020, 7, 1, 0, 0, 0].pack('d*')
+    Dir.mktmpdir do |dir|
+      File.write(File.join(dir, 'swe_deltat.txt'), "# test\n2020 100.0\n")
+      File.write(File.join(dir, 'seleapsec.txt'), "# test\n20191231\n")
+      # a new thread uses the compiled-in tables and reads no file
+      Thread.new do
+        Swe4r::swe_set_ephe_path(dir)
+        Swe4r::swe_reset_cache_stats
+        jds = Swe4r::swe_utc_to_jd_arr(utc).unpack('d*')
+        assert_in_delta(69.4 / 86400, jds[0] - jds[1], 1.0 / 86400)
+        assert_equal(0, Swe4r::swe_get_cache_stats[Swe4r::SE_STAT_FOPEN])
+      end.join
+    end
+    Swe4r::swe_set_ephe_path('path')
+  end
+
+  def test_gen_tables
+    require_relative '../ext/swe4r/gen_tables'
+    Dir.mktmpdir do |dir|
+      File.write("#{dir}/seleapsec.txt", "# test\n20081231\n20991231\n")
+      File.write("#{dir}/sedeltat.txt", "# test\n2030 80.5\n2031 81\n")
+      # 20081231 is in swedate.c already
+      assert_equal(3, Swe4rTables.generate(dir, dir))
+      File.write("#{dir}/t.c", <<~C)
+        #include "seleapsec.h"
+        #include "sedeltat.h"
+        int main(void) {
+          return !(SWI_BUILTIN_NLEAPSEC == 1 && swi_builtin_leapsec[0] == 20991231
+            && SWI_BUILTIN_NDELTAT == 2 && swi_builtin_deltat[1][0] == 2031 && swi_builtin_deltat[1][1] == 81);
+        }
+      C
+      assert(system(RbConfig::CONFIG['CC'], '-o', "#{dir}/t", "#{dir}/t.c"))
+      assert(system("#{dir}/t"))
+      # no table files give empty tables that compile as well
+      FileUtils.rm(["#{dir}/seleapsec.txt", "#{dir}/sedeltat.txt"])
+      assert_equal(0, Swe4rTables.generate(dir, dir))
+      File.write("#{dir}/t.c", <<~C)
+        #include "seleapsec.h"
+        #include "sedeltat.h"
+        int main(void) { return SWI_BUILTIN_NLEAPSEC + SWI_BUILTIN_NDELTAT; }
+      C
+      assert(system(RbConfig::CONFIG['CC'], '-o', "#{dir}/t", "#{dir}/t.c"))
+      assert(system("#{dir}/t"))
+    end
+  end
+
+  def test_swe_get_cache_stats
+    Dir.mktmpdir do |dir|
+      path = "#{dir}/a:#{dir}/b"
+      Swe4r::swe_set_ephe_path(path)
+      Swe4r::swe_reset_cache_stats
+      assert_equal([0] * Swe4r::SE_NSTATS, Swe4r::swe_get_cache_stats)
+      Swe4r::swe_calc_ut(2451545.0, Swe4r::SE_MARS, Swe4r::SEFLG_SWIEPH)
+      first = Swe4r::swe_get_cache_stats
+      assert(first[Swe4r::SE_STAT_FOPEN_MISS] > 0)
+      Swe4r::swe_calc_ut(2451545.0, Swe4r::SE_MARS, Swe4r::SEFLG_SWIEPH)
+      second = Swe4r::swe_get_cache_stats
+      assert(second[Swe4r::SE_STAT_FOPEN_CACHED] > first[Swe4r::SE_STAT_FOPEN_CACHED])
+      assert_equal(first[Swe4r::SE_STAT_FOPEN_PROBE], second[Swe4r::SE_STAT_FOPEN_PROBE])
+      # a file that appears later is found once the path is set again, also the same path
+      FileUtils.mkdir_p("#{dir}/b")
+      %w[sepl_18.se1 semo_18.se1].each do |f|
+        FileUtils.cp(File.expand_path("../ext/swe4r/#{f}", __dir__), "#{dir}/b")
+      end
+      Swe4r::swe_set_ephe_path(path)
+      Swe4r::swe_reset_cache_stats
+      Swe4r::swe_calc_ut(2451545.0, Swe4r::SE_MARS, Swe4r::SEFLG_SWIEPH)
+      assert_equal(0, Swe4r::swe_get_cache_stats[Swe4r::SE_STAT_FOPEN_MISS])
+      # worker threads take the path of the calling thread and keep the cache
+      Swe4r::swe_ecl_when_range(2451545.0, 2451545.0 + 1500, Swe4r::SE_SUN, Swe4r::SEFLG_SWIEPH, 0, 4)
+      Swe4r::swe_reset_cache_stats
+      Swe4r::swe_ecl_when_range(2451545.0, 2451545.0 + 1500, Swe4r::SE_SUN, Swe4r::SEFLG_SWIEPH, 0, 4)
+      stats = Swe4r::swe_get_cache_stats
+      assert(stats[Swe4r::SE_STAT_FOPEN] > 0)
+      assert_equal(stats[Swe4r::SE_STAT_FOPEN], stats[Swe4r::SE_STAT_FOPEN_CACHED])
+    end
+    Swe4r::swe_set_ephe_path('path')
+  end
+
+  def test_precession_cache
+    flags = Swe4r::SEFLG_MOSEPH | Swe4r::SEFLG_SPEED | Swe4r::SEFLG_EQUATORIAL
+    Swe4r::swe_set_ephe_path('path')
+    alone = Swe4r::swe_calc_ut(2460000.5, Swe4r::SE_SATURN, flags)
+    Swe4r::swe_reset_cache_stats
+    # the matrices of nearby dates are derived from the cached ones
+    Swe4r::swe_calc_ut(2460000.3, Swe4r::SE_MARS, flags)
+    shared = Swe4r::swe_calc_ut(2460000.5, Swe4r::SE_SATURN, flags)
+    alone.zip(shared).each { |a, b| assert_in_delta(a, b, 1e-9) }
+    stats = Swe4r::swe_get_cache_stats
+    assert(stats[Swe4r::SE_STAT_PREC] > 0)
+    assert(stats[Swe4r::SE_STAT_PREC_CACHED] > stats[Swe4r::SE_STAT_PREC] / 2)
+  end
+
+  def test_swe_get_planet_name
+    assert_equal('Mars', Swe4r::swe_get_planet_name(Swe4r::SE_MARS))
+    Dir.mktmpdir do |dir|
+      File.write("#{dir}/seasnam.txt", <<~NAMES)
+        # catalog number and name
+        (433) Eros
+        (10000) Myriostos  # comment
+        [2060]	Chiron
+        10000 Duplicate
+        99942 Apophis
+      NAMES
+      Swe4r::swe_set_ephe_path(dir)
+      ast = Swe4r::SE_AST_OFFSET
+      assert_equal('Eros', Swe4r::swe_get_planet_name(ast + 433))
+      assert_equal(%w[Apophis Myriostos Chiron],
+                   Swe4r::swe_get_planet_name_arr([ast + 99942, ast + 10000, ast + 2060]))
+      assert_match(/not found/, Swe4r::swe_get_planet_name(ast + 12345))
+      # the index is read again when the path is set again
+      File.write("#{dir}/seasnam.txt", "12345 Added\n", mode: 'a')
+      assert_match(/not found/, Swe4r::swe_get_planet_name(ast + 12345))
+      Swe4r::swe_set_ephe_path(dir)
+      assert_equal('Added', Swe4r::swe_get_planet_name(ast + 12345))
+    end
+    Swe4r::swe_set_ephe_path('path')
+  end
+
+  def test_fictitious_elements_file
+    Dir.mktmpdir do |dir|
+      File.write("#{dir}/seorbel.txt", <<~ELEMENTS)
+        # fixture for the parser of seorbel.txt
+
+        J2000, J2000, 101.5 + 35999.05 * T, 40.0 + 0.5 * T, 0.2 - 0.01 * T, 10.0, 20.0 + 1.2 * T - 0.0003 * T2, 5.0, Alpha  # T terms
+           # indented comment
+        2451545.0, JDATE, 50.0, 30.0, 0.1, 100.0, 80.0, 2.0, Beta
+        J1900, B1950, 12.0, 0.003, 0.05, 15.0, 25.0, 5.1, Gamma, geo
+
+        J2000, J2000, 10.0, 1.5, 0.1, 20.0, 30.0
+        J2000, J2000, 10.0, 1.5, 0.1, 20.0, 30.0, 1.0, Delta
+      ELEMENTS
+      Swe4r::swe_set_ephe_path(dir)
+      fict = Swe4r::SE_FICT_OFFSET
+      iflag = Swe4r::SEFLG_MOSEPH | Swe4r::SEFLG_SPEED
+      # lon, lat, distance, lon speed from the parser before it kept the file in memory
+      expected = {
+        [fict, 2415020.5] => [152.940224483828, 3.617573140173, 42.235770565781, -0.010890001339],
+        [fict, 2460000.5] => [194.139843077443, 0.637621051640, 46.737318543040, -0.013791042627],
+        [fict + 1, 2415020.5] => [7.291978241178, -1.889374047320, 32.989582971984, 0.006452145438],
+        [fict + 1, 2460000.5] => [292.890662493838, -1.025601565087, 31.551592218321, 0.028881112747],
+        [fict + 2, 2415020.5] => [58.199703668235, 2.843269832386, 0.002857604679, 11.427368435299],
+        [fict + 2, 2460000.5] => [352.847589551436, -2.796065933368, 0.002896212828, 11.122513652804]
+      }
+      expected.each do |(ipl, tjd), x|
+        body = Swe4r::swe_calc_ut(tjd, ipl, iflag)
+        3.times { |i| assert_in_delta(x[i], body[i], 1e-9) }
+        # precession matrices are cached since, see test_precession_cache
+        assert_in_delta(x[3], body[3], 1e-7)
+      end
+      assert_equal(%w[Alpha Beta Gamma], (0..2).map { |i| Swe4r::swe_get_planet_name(fict + i) })
+      # the line with eight elements ends the file
+      [fict + 3, fict + 4].each do |ipl|
+        error = assert_raise(RuntimeError) { Swe4r::swe_calc_ut(2415020.5, ipl, iflag) }
+        assert_equal('error in file seorbel.txt, line       8: nine elements required', error.message)
+      end
+    end
+    Swe4r::swe_set_ephe_path('path')
+  end
+
+  # CRC of the header of an ephemeris file, see swi_crc32()
+  def se1_crc32(s)
+    crc = 0xffffffff
+    s.each_byte do |b|
+      crc ^= b << 24
+      8.times { crc = (crc & 0x80000000 != 0 ? (crc << 1) ^ 0x04c11db7 : crc << 1) & 0xffffffff }
+    end
+    ~crc & 0xffffffff
+  end
+
+  # writes dir/ast0/seNNNNNs.se1 for asteroid number with the ephemeris 
+  # of body k of seas_18.se1
+  def write_asteroid_file(dir, number, k)
+    src = File.binread(File.expand_path('../ext/swe4r/seas_18.se1', __dir__))
+    pos = 0
+    3.times { pos = src.index("\r\n", pos) + 2 }
+    denum, tfstart, tfend, nplan = src[pos + 8, 22].unpack('l<E2s<')
+    pos += 30 + 2 * nplan + 4
+    gen = src[pos, 40]
+    pos += 40
+    const = nil
+    nplan.times do |i|
+      iflg, ncoe = src[pos + 4, 2].unpack('CC')
+      len = 90 + (iflg & 4 != 0 ? 16 * ncoe : 0)
+      const = src[pos, len] if i == k
+      pos += len
+    end
+    name = format('se%05ds.se1', number)
+    text = "SWISSEPH 1\r\n#{name}\r\ntest file\r\n" + format('%5d Test%-60d', number, number) + "\r\n"
+    hsize = text.size + 30 + 2 + 30
+    # the segments of all bodies follow the constants; move them and the index of body k
+    delta = hsize + 4 + 40 + const.size - pos
+    data = src[pos..]
+    lndx0 = const.unpack1('l<')
+    tstart, tend, dseg = const[10, 24].unpack('E3')
+    ((tend - tstart + 0.1) / dseg).to_i.times do |i|
+      at = lndx0 - pos + 3 * i
+      data[at, 3] = [(data[at, 3] + "\0").unpack1('L<') + delta].pack('L<')[0, 3]
+    end
+    const[0, 4] = [lndx0 + delta].pack('l<')
+    head = text.b + [0x616263, hsize + 4 + 40 + const.size + data.size, denum, tfstart, tfend, 1,
+                     Swe4r::SE_AST_OFFSET + number].pack('l<3E2s<2') + ' ' * 30
+    FileUtils.mkdir_p("#{dir}/ast0")
+    File.binwrite("#{dir}/ast0/#{name}", head + [se1_crc32(head)].pack('L<') + gen + const + data)
+  end
+
+  def test_asteroid_pool
+    ephe = File.expand_path('../ext/swe4r', __dir__)
+    ast = Swe4r::SE_AST_OFFSET
+    iflag = Swe4r::SEFLG_SWIEPH | Swe4r::SEFLG_SPEED
+    Dir.mktmpdir do |dir|
+      path = dir + File::PATH_SEPARATOR + ephe
+      # more asteroids than the pool keeps open, with six different orbits
+      numbers = (900...940).to_a
+      numbers.each { |n| write_asteroid_file(dir, n, n % 6) }
+      order = numbers + numbers.reverse + numbers.select(&:even?) + numbers.select(&:odd?)
+      fresh = order.each_with_index.map do |n, i|
+        Swe4r::swe_set_ephe_path(path)
+        Swe4r::swe_calc_ut(2451545.0 + i, ast + n, iflag)
+      end
+      Swe4r::swe_set_ephe_path(path)
+      order.each_with_index do |n, i|
+        assert_equal(fresh[i], Swe4r::swe_calc_ut(2451545.0 + i, ast + n, iflag), "asteroid #{n}")
+      end
+      assert_equal('Test917', Swe4r::swe_get_planet_name(ast + 917))
+      assert_not_equal(fresh[0], fresh[1])
+    end
+    Swe4r::swe_set_ephe_path('path')
+  end
+
   def test_swe_set_topo
     assert_equal(nil, Swe4r::swe_set_topo(-112.183333, 45.45, 1524))
-  end 
+  end
+
+  def test_calc_cache
+    flags = Swe4r::SEFLG_MOSEPH | Swe4r::SEFLG_SPEED
+    Swe4r::swe_set_calc_cache(0)
+    uncached = Swe4r::swe_calc_ut(2460000.5, Swe4r::SE_MARS, flags)
+    # a single set of 4 entries: the 5th body replaces the least recently used
+    Swe4r::swe_set_calc_cache(4)
+    Swe4r::swe_reset_cache_stats
+    (Swe4r::SE_MARS..Swe4r::SE_NEPTUNE).each { |ipl| Swe4r::swe_calc_ut(2460000.5, ipl, flags) }
+    assert_equal([5, 0], Swe4r::swe_get_cache_stats.values_at(Swe4r::SE_STAT_CALC, Swe4r::SE_STAT_CALC_CACHED))
+    Swe4r::swe_calc_ut(2460000.5, Swe4r::SE_NEPTUNE, flags | Swe4r::SEFLG_EQUATORIAL)
+    cached = Swe4r::swe_calc_ut(2460000.5, Swe4r::SE_MARS, flags)
+    assert_equal([7, 1], Swe4r::swe_get_cache_stats.values_at(Swe4r::SE_STAT_CALC, Swe4r::SE_STAT_CALC_CACHED))
+    uncached.zip(cached).each { |a, b| assert_in_delta(a, b, 1e-9) }
+    Swe4r::swe_set_calc_cache(-1)
+  end
+
+  def test_observer_cache
+    flags = Swe4r::SEFLG_MOSEPH | Swe4r::SEFLG_SPEED | Swe4r::SEFLG_TOPOCTR
+    Swe4r::swe_set_topo(8.55, 47.37, 400)
+    zurich = Swe4r::swe_calc_ut(2460000.5, Swe4r::SE_MOON, flags)
+    Swe4r::swe_set_topo(-74.0, 40.7, 10)
+    Swe4r::swe_calc_ut(2460000.5, Swe4r::SE_MOON, flags)
+    Swe4r::swe_reset_cache_stats
+    # back to the first place, the observer is taken from the cache
+    Swe4r::swe_set_topo(8.55, 47.37, 400)
+    assert_equal(zurich, Swe4r::swe_calc_ut(2460000.5, Swe4r::SE_MOON, flags))
+    stats = Swe4r::swe_get_cache_stats
+    assert(stats[Swe4r::SE_STAT_OBSERVER] > 0)
+    assert_equal(stats[Swe4r::SE_STAT_OBSERVER], stats[Swe4r::SE_STAT_OBSERVER_CACHED])
+  end
+
+  def test_topocentric_speed
+    # analytic topocentric speed against the speed from three positions
+    Swe4r::swe_set_topo(8.55, 47.37, 400)
+    flags = Swe4r::SEFLG_MOSEPH | Swe4r::SEFLG_TOPOCTR
+    [2444838.972916667, 2460000.3].each do |tjd|
+      (Swe4r::SE_SUN..Swe4r::SE_PLUTO).each do |ipl|
+        fast = Swe4r::swe_calc_ut(tjd, ipl, flags | Swe4r::SEFLG_SPEED)
+        slow = Swe4r::swe_calc_ut(tjd, ipl, flags | Swe4r::SEFLG_SPEED3)
+        delta = ipl == Swe4r::SE_MOON ? 2e-3 : 2e-4
+        (3..5).each { |i| assert_in_delta(slow[i], fast[i], delta) }
+      end
+    end
+  end
   
+  def test_swe_set_interpolate_deltat
+    exact = Swe4r::swe_calc_ut(2444838.972916667, Swe4r::SE_MOON, Swe4r::SEFLG_MOSEPH)
+    assert_equal(nil, Swe4r::swe_set_interpolate_deltat(true))
+    body = Swe4r::swe_calc_ut(2444838.972916667, Swe4r::SE_MOON, Swe4r::SEFLG_MOSEPH)
+    Swe4r::swe_set_interpolate_deltat(false)
+    assert_in_delta(exact[0], body[0], 1e-6)
+    assert_in_delta(exact[1], body[1], 1e-6)
+  end
+
+  def test_ep4_calc
+    Dir.mktmpdir do |dir|
+      Swe4r::swe_set_ephe_path("#{dir}:#{File.expand_path('../ext/swe4r', __dir__)}")
+      assert_equal(nil, Swe4r::ep4_make_file(244, Swe4r::SEFLG_SWIEPH, dir))
+      tjd_et = 2444838.972916667 + 51.4 / 86400.0
+      exact = Swe4r::swe_calc_ut(2444838.972916667, Swe4r::SE_MOON, Swe4r::SEFLG_MOSEPH|Swe4r::SEFLG_SPEED)
+      body = Swe4r::ep4_calc(tjd_et, Swe4r::SE_MOON)
+      assert_in_delta(exact[0], body[0], 0.001)
+      assert_in_delta(exact[3], body[1], 0.001)
+      scan = Swe4r::ep4_calc_arr([tjd_et, tjd_et + 1].pack('d*'), Swe4r::SE_MOON).unpack('d*')
+      assert_equal(body, scan[0, 2])
+      # documented accuracy, against the swe_calc() fallback without the file
+      dates = (0...100).map { |i| 2440010.3 + i * 99.7 }.pack('d*')
+      fast = [Swe4r::SE_SUN, Swe4r::SE_MOON].map { |ipl| Swe4r::ep4_calc_arr(dates, ipl).unpack('d*') }
+      Swe4r::swe_set_ephe_path(File.expand_path('../ext/swe4r', __dir__))
+      exact = [Swe4r::SE_SUN, Swe4r::SE_MOON].map { |ipl| Swe4r::ep4_calc_arr(dates, ipl).unpack('d*') }
+      [[0.01, 1e-5], [0.5, 1e-3]].each_with_index do |(arcsec, speed), k|
+        fast[k].each_slice(2).zip(exact[k].each_slice(2)) do |(lon, lon_speed), (lon_exact, speed_exact)|
+          assert_in_delta(0, (lon - lon_exact + 180) % 360 - 180, arcsec / 3600.0)
+          assert_in_delta(speed_exact, lon_speed, speed)
+        end
+      end
+      assert_equal(nil, Swe4r::ep4_close)
+      assert_raise(TypeError) { Swe4r::ep4_calc_arr(5, Swe4r::SE_SUN) }
+    end
+    Swe4r::swe_set_ephe_path('path')
+  end
+
+  def test_swe_ecl_catalog
+    start = 2458849.5 # 2020-01-01
+    Dir.mktmpdir do |dir|
+      Swe4r::swe_set_ephe_path(dir)
+      assert_equal(nil, Swe4r::swe_ecl_catalog_make(start, start + 3653, [Swe4r::SE_SUN, Swe4r::SE_MOON, Swe4r::SE_VENUS],
+                                                    Swe4r::SEFLG_MOSEPH, dir))
+      # total solar eclipse of 2024-04-08, saros 139
+      total = Swe4r::swe_ecl_catalog_when(start + 1000, Swe4r::SE_SUN, Swe4r::SEFLG_MOSEPH, Swe4r::SE_ECL_TOTAL, false)
+      assert_equal(Swe4r::SE_ECL_TOTAL, total[0] & Swe4r::SE_ECL_TOTAL)
+      assert_in_delta(2460409.26, total[1], 0.01)
+      assert_equal(139, total[3])
+      previous = Swe4r::swe_ecl_catalog_when(total[1], Swe4r::SE_SUN, Swe4r::SEFLG_MOSEPH, 0, true)
+      assert(previous[1] < total[1])
+      Swe4r::swe_set_ephe_path(File.expand_path('../ext/swe4r', __dir__)) # no catalog: live search
+      [[start + 1000, Swe4r::SE_SUN], [start + 500, Swe4r::SE_MOON], [start + 200, Swe4r::SE_VENUS]].each do |t, ipl|
+        live = Swe4r::swe_ecl_catalog_when(t, ipl, Swe4r::SEFLG_MOSEPH, 0, false)
+        Swe4r::swe_set_ephe_path(dir)
+        cat = Swe4r::swe_ecl_catalog_when(t, ipl, Swe4r::SEFLG_MOSEPH, 0, false)
+        Swe4r::swe_set_ephe_path(File.expand_path('../ext/swe4r', __dir__))
+        assert_equal(live[0], cat[0])
+        assert_in_delta(live[1], cat[1], 1e-6)
+        assert_in_delta(live[2], cat[2], 1e-5)
+      end
+      # a body and an ephemeris that are not in the catalog
+      ephe = File.expand_path('../ext/swe4r', __dir__)
+      live = [Swe4r::swe_ecl_catalog_when(start, Swe4r::SE_MARS, Swe4r::SEFLG_MOSEPH, 0, false),
+              Swe4r::swe_ecl_catalog_when(start + 1000, Swe4r::SE_SUN, Swe4r::SEFLG_SWIEPH, 0, false)]
+      Swe4r::swe_set_ephe_path(dir + File::PATH_SEPARATOR + ephe)
+      assert_equal(live, [Swe4r::swe_ecl_catalog_when(start, Swe4r::SE_MARS, Swe4r::SEFLG_MOSEPH, 0, false),
+                          Swe4r::swe_ecl_catalog_when(start + 1000, Swe4r::SE_SUN, Swe4r::SEFLG_SWIEPH, 0, false)])
+      assert(live[0][1] < start + 3653)
+      # beyond the end of the catalog
+      Swe4r::swe_set_ephe_path(dir)
+      after = Swe4r::swe_ecl_catalog_when(start + 3650, Swe4r::SE_MOON, Swe4r::SEFLG_MOSEPH, 0, false)
+      assert(after[1] > start + 3653)
+    end
+    Swe4r::swe_set_ephe_path('path')
+  end
+
+  def test_swe_ecl_when_range
+    start = 2458849.5 # 2020-01-01
+    solar = Swe4r::swe_ecl_when_range(start, start + 3653, Swe4r::SE_SUN, Swe4r::SEFLG_MOSEPH, 0, 1)
+    # the event list must not depend on the number of threads, also with more threads than blocks;
+    # the contacts of occultations can differ in the last bit with the state of the position caches
+    [Swe4r::SE_SUN, Swe4r::SE_MOON, Swe4r::SE_VENUS].each do |ipl|
+      single = ipl == Swe4r::SE_SUN ? solar : Swe4r::swe_ecl_when_range(start, start + 3653, ipl, Swe4r::SEFLG_MOSEPH, 0, 1)
+      [2, 3, 4, 16].each do |nthreads|
+        events = Swe4r::swe_ecl_when_range(start, start + 3653, ipl, Swe4r::SEFLG_MOSEPH, 0, nthreads)
+        assert_equal(single.size, events.size)
+        single.zip(events).each do |s, e|
+          assert_equal(s[0], e[0])
+          s[1..].zip(e[1..]).each { |a, b| assert_in_delta(a, b, 1e-8) }
+        end
+      end
+    end
+    # the same events as one sequential search
+    t = start
+    solar.each do |event|
+      live = Swe4r::swe_ecl_catalog_when(t, Swe4r::SE_SUN, Swe4r::SEFLG_MOSEPH, 0, false)
+      assert_in_delta(live[1], event[1], 1e-6)
+      t = event[1]
+    end
+    assert(Swe4r::swe_ecl_catalog_when(t, Swe4r::SE_SUN, Swe4r::SEFLG_MOSEPH, 0, false)[1] > start + 3653)
+    total = Swe4r::swe_ecl_when_range(start, start + 3653, Swe4r::SE_MOON, Swe4r::SEFLG_MOSEPH, Swe4r::SE_ECL_TOTAL, 3)
+    assert(total.all? { |event| event[0] & Swe4r::SE_ECL_TOTAL != 0 })
+    assert(total.size > 3)
+  end
+
+  def test_swe_set_interpolate_ecl
+    start = 2451545.0
+    search = lambda do
+      t = start
+      local = Array.new(8) do
+        eclipse = Swe4r::swe_sol_eclipse_when_loc(t, Swe4r::SEFLG_MOSEPH, 13.4, 52.5, 50, false)
+        t = eclipse[1][0] + 1
+        eclipse
+      end
+      [local, Swe4r::swe_ecl_when_range(start, start + 3653, Swe4r::SE_VENUS, Swe4r::SEFLG_MOSEPH, 0, 1)]
+    end
+    exact = search.call
+    Swe4r::swe_set_interpolate_ecl(true)
+    interpolated = search.call
+    # same events, with contacts within 0.01 seconds
+    exact[0].zip(interpolated[0]).each do |e, i|
+      assert_equal(e[0], i[0])
+      e[1].zip(i[1]).each { |a, b| assert_in_delta(a, b, 0.01 / 86400) }
+      assert_in_delta(e[2][0], i[2][0], 1e-6)
+    end
+    assert_equal(exact[1].size, interpolated[1].size)
+    exact[1].zip(interpolated[1]).each do |e, i|
+      assert_equal(e[0], i[0])
+      e[1..].zip(i[1..]).each { |a, b| assert_in_delta(a, b, 0.01 / 86400) }
+    end
+  ensure
+    Swe4r::swe_set_interpolate_ecl(false)
+  end
+
+  def test_swe_heliacal_ut
+    # heliacal rising of Venus at Zurich in March 2025
+    dret = Swe4r::swe_heliacal_ut(2460310.5, 8.55, 47.37, 400, 'venus', Swe4r::SE_HELIACAL_RISING, Swe4r::SEFLG_MOSEPH, [1013.25, 15, 40, 0], [36, 1])
+    assert_in_delta(2460759.697744, dret[0], 1e-5)
+    assert(dret[0] < dret[1] && dret[1] < dret[2])
+    stats = Swe4r::swe_heliacal_stats
+    assert_equal(Swe4r::SE_NHELSTATS, stats.size)
+    assert(stats[Swe4r::SE_HELSTAT_TIME] >= stats[Swe4r::SE_HELSTAT_TIME_DAY])
+    assert(stats[Swe4r::SE_HELSTAT_NVISLIM_MEMO] > 0)
+    assert(stats[Swe4r::SE_HELSTAT_NLOC_MEMO] > 0)
+    assert(stats[Swe4r::SE_HELSTAT_NLOC] >= stats[Swe4r::SE_HELSTAT_NLOC_MEMO])
+    assert(stats[Swe4r::SE_HELSTAT_NSKY] > 0)
+  end
+
+  def test_swe_heliacal_ut_baseline
+    # event times before the searches were memoized and the magnitudes interpolated
+    datm = [1013.25, 15, 40, 0]
+    dobs = [36, 1]
+    south = [2443704.0, -51, -16, 300]
+    north = [2448642.0, 41, 16, 700]
+    {
+      [south, 'venus', Swe4r::SE_HELIACAL_RISING] => [2443825.84754193, 2443825.84905814, 2443825.85086369],
+      [south, 'venus', Swe4r::SE_HELIACAL_SETTING] => [2443814.40451842, 2443814.40972675, 2443814.41399758],
+      [south, 'venus', Swe4r::SE_EVENING_FIRST] => [2444145.40056822, 2444145.40410988, 2444145.40711914],
+      [south, 'venus', Swe4r::SE_MORNING_LAST] => [2444075.89372794, 2444075.89510525, 2444075.89751266],
+      [south, 'mercury', Swe4r::SE_HELIACAL_RISING] => [2443753.86877148, 2443753.87117889, 2443753.87290343],
+      [south, 'mercury', Swe4r::SE_HELIACAL_SETTING] => [2443726.40776430, 2443726.41571568, 2443726.42358605],
+      [south, 'saturn', Swe4r::SE_HELIACAL_RISING] => [2443774.85383993, 2443774.85742790, 2443774.86174502],
+      [south, 'moon', Swe4r::SE_EVENING_FIRST] => [2443726.38446568, 2443726.41687309, 2443726.44107447],
+      [north, 'venus', Swe4r::SE_EVENING_FIRST] => [2448823.17400633, 2448823.17541837, 2448823.17691142],
+      [north, 'mercury', Swe4r::SE_MORNING_LAST] => [2448757.58898219, 2448757.59217663, 2448757.59504700],
+      [north, 'saturn', Swe4r::SE_HELIACAL_SETTING] => [2449011.15819362, 2449011.15873760, 2449011.15975612],
+      [north, 'moon', Swe4r::SE_MORNING_LAST] => [2448654.61242804, 2448654.62923359, 2448654.65701137],
+    }.each do |((tjd, lon, lat, height), name, type), expected|
+      dret = Swe4r::swe_heliacal_ut(tjd, lon, lat, height, name, type, Swe4r::SEFLG_MOSEPH, datm, dobs)
+      expected.each_with_index { |t, i| assert_in_delta(t, dret[i], 1e-6, "#{name} #{type} #{i}") }
+    end
+  end
+
+  def test_swe_heliacal_range
+    start = 2460310.5
+    datm = [1013.25, 15, 40, 0]
+    dobs = [36, 1]
+    types = [Swe4r::SE_HELIACAL_RISING, Swe4r::SE_HELIACAL_SETTING, Swe4r::SE_EVENING_FIRST, Swe4r::SE_MORNING_LAST]
+    events = Swe4r::swe_heliacal_range(start, start + 365, 8.55, 47.37, 400, %w[venus jupiter moon], types, Swe4r::SEFLG_MOSEPH, datm, dobs)
+    assert_equal(events, events.sort_by { |e| e[2] })
+    # no evening first or morning last for jupiter
+    assert(events.none? { |e| e[0] == 'jupiter' && e[1] > 2 })
+    assert(events.count { |e| e[0] == 'moon' } >= 24)
+    # same events as one search after the other
+    [['venus', 1], ['jupiter', 2], ['moon', 3]].each do |name, type|
+      t = start
+      expected = []
+      loop do
+        dret = Swe4r::swe_heliacal_ut(t, 8.55, 47.37, 400, name, type, Swe4r::SEFLG_MOSEPH, datm, dobs)
+        break if dret[0] >= start + 365
+        expected << dret
+        t = dret[0] + 1
+      end
+      assert_equal(expected, events.select { |e| e[0] == name && e[1] == type }.map { |e| e[2..] })
+    end
+    assert_equal([], Swe4r::swe_heliacal_range(start, start, 8.55, 47.37, 400, %w[venus], types, Swe4r::SEFLG_MOSEPH, datm, dobs))
+    assert_raise(ArgumentError) do
+      Swe4r::swe_heliacal_range(start, start - 1000, 8.55, 47.37, 400, %w[venus], types, Swe4r::SEFLG_MOSEPH, datm, dobs)
+    end
+  end
+
+  def test_swe_sol_eclipse_loc_arr
+    # total solar eclipse of 2024-04-08
+    event = Swe4r::swe_ecl_when_range(2460401.5, 2460420.5, Swe4r::SE_SUN, Swe4r::SEFLG_MOSEPH, 0, 1).first
+    geopos = [-96.8, 32.8, 0, -75, 40, 0, 0, -60, 0].pack('d*')
+    dret = Swe4r::swe_sol_eclipse_loc_arr(event[3], event[4], 1.0 / 1440, Swe4r::SEFLG_MOSEPH, geopos).unpack('d*')
+    assert_equal(30, dret.size)
+    # Dallas: total, as by swe_sol_eclipse_when_loc()
+    assert_equal(Swe4r::SE_ECL_TOTAL, dret[9].to_i)
+    [2460409.279691, 2460409.224595, 2460409.278358, 2460409.281023, 2460409.335271].each_with_index do |t, i|
+      assert_in_delta(t, dret[i], 2.0 / 86400)
+    end
+    assert_in_delta(1.0151, dret[5], 1e-3)
+    assert_in_delta(64.59, dret[8], 0.01)
+    # Philadelphia: partial, without 2nd and 3rd contact
+    assert_equal(Swe4r::SE_ECL_PARTIAL, dret[19].to_i)
+    assert_in_delta(2460409.308356, dret[10], 2.0 / 86400)
+    assert_equal([0.0, 0.0], dret[12, 2])
+    assert_in_delta(0.8858, dret[16], 1e-3)
+    # no eclipse in the south
+    assert_equal([0.0] * 10, dret[20, 10])
+    assert_raises(ArgumentError) { Swe4r::swe_sol_eclipse_loc_arr(event[3], event[4], 0, 0, [1.0, 2.0].pack('d*')) }
+  end
+
   def test_swe_set_sid_mode
     assert_equal(nil, Swe4r::swe_set_sid_mode(Swe4r::SE_SIDM_LAHIRI, 0, 0)) # Use Lahiri mode
     assert_equal(nil, Swe4r::swe_set_sid_mode(Swe4r::SE_SIDM_USER, 2415020.5, 22.460489112721632)) # Use user defined mode
@@ -109,6 +655,36 @@ class Swe4rTest < Test::Unit::TestCase
     
   end
   
+  def test_swe_calc_ut_into
+    pos = Swe4r::Position.new
+    flags = Swe4r::SEFLG_MOSEPH|Swe4r::SEFLG_SPEED
+    body = Swe4r::swe_calc_ut(2444838.972916667, Swe4r::SE_MOON, flags)
+    assert_same(pos, Swe4r::swe_calc_ut_into(2444838.972916667, Swe4r::SE_MOON, flags, pos))
+    assert_equal(body, pos.to_a)
+    assert_equal(body[0], pos.lon)
+    assert_equal(body[3], pos.lon_speed)
+    assert_equal(body[2], pos[2])
+    loop = -> { 1000.times { Swe4r::swe_calc_ut_into(2444838.972916667, Swe4r::SE_MOON, flags, pos) } }
+    loop.call # warm up
+    allocated = GC.stat(:total_allocated_objects)
+    loop.call
+    assert_operator(GC.stat(:total_allocated_objects) - allocated, :<, 10) # the loop itself only
+  end
+
+  def test_swe_houses_into
+    houses = Swe4r::Houses.new
+    cusps, ascmc = Swe4r::swe_houses(2444838.972916667, 45.45, -112.183333, 'P')
+    assert_same(houses, Swe4r::swe_houses_into(2444838.972916667, 45.45, -112.183333, 'P', houses))
+    assert_equal(cusps, houses.cusps)
+    assert_equal(ascmc[0], houses.asc)
+    assert_equal(ascmc[1], houses.mc)
+    cusps, ascmc, cusps_speed, ascmc_speed = Swe4r::swe_houses_ex2(2444838.972916667, 0, 45.45, -112.183333, 'P')
+    Swe4r::swe_houses_ex2_into(2444838.972916667, 0, 45.45, -112.183333, 'P', houses)
+    assert_equal(cusps_speed[10], houses.cusp_speed(10))
+    assert_equal(ascmc_speed[2], houses.ascmc_speed(2))
+    assert_raise(IndexError) { houses.cusp(13) }
+  end
+
   def test_swe_houses
     
     # Test each house system
@@ -168,6 +744,186 @@ class Swe4rTest < Test::Unit::TestCase
     assert_equal( -15.418741801398292, app_altitude )
   end
 
+  def test_swe_azalt_into
+    pos = Swe4r::Position.new
+    # speeds left over from an earlier call must not survive
+    Swe4r::swe_calc_ut_into(2444838.972916667, Swe4r::SE_MOON, Swe4r::SEFLG_MOSEPH | Swe4r::SEFLG_SPEED, pos)
+    expected = Swe4r::swe_azalt(2444838.972916667, Swe4r::SE_ECL2HOR, -149.894852, 61.2163129, 0, 0, 0, 149.271, -0.00012, 1.0113)
+    assert_same(pos, Swe4r::swe_azalt_into(2444838.972916667, Swe4r::SE_ECL2HOR, -149.894852, 61.2163129, 0, 0, 0, 149.271, -0.00012, 1.0113, pos))
+    assert_equal(expected, pos.to_a[0, 3])
+    assert_equal([0.0, 0.0, 0.0], pos.to_a[3, 3])
+    assert_raise(ArgumentError) { Swe4r::swe_azalt_into(2444838.972916667, Swe4r::SE_ECL2HOR, pos) }
+  end
+
+  def test_swe_azalt_arr
+    lon, lat, height = 8.55, 47.37, 400
+    tjd = 2460000.5
+    xin = (0...36).flat_map { |i| [i * 10.0, i - 18.0, 1.0] }
+    [Swe4r::SE_ECL2HOR, Swe4r::SE_EQU2HOR].each do |flag|
+      xaz = Swe4r::swe_azalt_arr(tjd, flag, lon, lat, height, 1000, 20, xin.pack('d*')).unpack('d*')
+      tjds = (0...36).map { |i| tjd + i * 0.1 }
+      xaz_t = Swe4r::swe_azalt_times(tjds.pack('d*'), flag, lon, lat, height, 1000, 20, xin.pack('d*')).unpack('d*')
+      xin.each_slice(3).with_index do |x, i|
+        expected = Swe4r::swe_azalt(tjd, flag, lon, lat, height, 1000, 20, *x)
+        expected.zip(xaz[3 * i, 3]).each { |a, b| assert_in_delta(a, b, 1e-9) }
+        expected = Swe4r::swe_azalt(tjds[i], flag, lon, lat, height, 1000, 20, *x)
+        expected.zip(xaz_t[3 * i, 3]).each { |a, b| assert_in_delta(a, b, 1e-9) }
+      end
+    end
+  end
+
+  def test_refrac_table
+    [[1013.25, 15], [800, -10]].each do |pres, temp|
+      (-4000..9000).step(7) do |i|
+        alt = i / 100.0
+        [Swe4r::SE_TRUE_TO_APP, Swe4r::SE_APP_TO_TRUE].each do |flag|
+          computed = Swe4r::swe_refrac_extended(alt, 400, pres, temp, 0.0065, flag)
+          table = Swe4r::swe_refrac_extended(alt, 400, pres, temp, 0.0065, flag | Swe4r::SE_REFRAC_TABLE)
+          computed.zip(table).each { |a, b| assert_in_delta(a, b, 5e-6) }
+        end
+      end
+    end
+    xaz = Swe4r::swe_azalt(2444838.9, Swe4r::SE_EQU2HOR, 8.55, 47.37, 400, 1013.25, 15, 120, 10, 1)
+    xaz_t = Swe4r::swe_azalt(2444838.9, Swe4r::SE_EQU2HOR | Swe4r::SE_REFRAC_TABLE, 8.55, 47.37, 400, 1013.25, 15, 120, 10, 1)
+    xaz.zip(xaz_t).each { |a, b| assert_in_delta(a, b, 5e-6) }
+    dret = Swe4r::swe_heliacal_ut(2460310.5, 8.55, 47.37, 400, 'venus', Swe4r::SE_HELIACAL_RISING, Swe4r::SEFLG_MOSEPH | Swe4r::SE_HELFLAG_REFRAC_TABLE, [1013.25, 15, 40, 0], [36, 1])
+    assert_in_delta(2460759.697744, dret[0], 1e-3)
+  end
+
+  def test_swe_nod_aps_calc_cache
+    # swe_nod_aps() reads earth, sun and nutation from the save area of 
+    # swe_calc(), which cached results must not leave at another date
+    flags = [Swe4r::SEFLG_SPEED, Swe4r::SEFLG_SPEED | Swe4r::SEFLG_HELCTR, Swe4r::SEFLG_SPEED | Swe4r::SEFLG_TOPOCTR, Swe4r::SEFLG_HELCTR]
+    Swe4r::swe_set_topo(8.55, 47.37, 400)
+    results = [0, -1].map do |n|
+      Swe4r::swe_set_calc_cache(n)
+      [2415020.5, 2460000.5].product([Swe4r::SE_SUN, Swe4r::SE_MOON, Swe4r::SE_MARS, Swe4r::SE_JUPITER], flags).map do |tjd, ipl, flag|
+        Swe4r::swe_nod_aps(tjd, ipl, Swe4r::SEFLG_MOSEPH | flag, Swe4r::SE_NODBIT_OSCU)
+      end
+    end
+    assert_equal(results[0], results[1])
+  end
+
+  def test_swe_nod_aps_arr
+    planets = [Swe4r::SE_MOON, Swe4r::SE_VENUS, Swe4r::SE_MARS, Swe4r::SE_JUPITER, Swe4r::SE_NEPTUNE]
+    tjd = 2460000.5
+    flag = Swe4r::SEFLG_MOSEPH
+    method = Swe4r::SE_NODBIT_OSCU
+    xret = Swe4r::swe_nod_aps_arr(tjd, planets, flag | Swe4r::SEFLG_SPEED, method).unpack('d*')
+    xpos = Swe4r::swe_nod_aps_arr(tjd, planets, flag, method).unpack('d*')
+    planets.each_with_index do |ipl, i|
+      xt = Swe4r::swe_nod_aps_times([tjd].pack('d*'), ipl, flag | Swe4r::SEFLG_SPEED, method).unpack('d*')
+      assert_equal(xret[24 * i, 24], xt)
+      4.times do |q|
+        3.times { |k| assert_in_delta(xpos[24 * i + 6 * q + k], xret[24 * i + 6 * q + k], 1e-9) }
+      end
+    end
+    # the same as single calls, up to the speed of earth and sun at t - dt,
+    # which the batch extrapolates from the epoch
+    Swe4r::swe_set_topo(8.55, 47.37, 400)
+    planets = [Swe4r::SE_SUN] + planets
+    [Swe4r::SE_NODBIT_MEAN, Swe4r::SE_NODBIT_OSCU, Swe4r::SE_NODBIT_OSCU | Swe4r::SE_NODBIT_FOPOINT].product([0, Swe4r::SEFLG_HELCTR, Swe4r::SEFLG_TOPOCTR]) do |m, f|
+      xarr = Swe4r::swe_nod_aps_arr(tjd, planets, flag | f | Swe4r::SEFLG_SPEED, m).unpack('d*')
+      planets.each_with_index do |ipl, i|
+        next if ipl == Swe4r::SE_SUN && f == Swe4r::SEFLG_HELCTR
+        x = Swe4r::swe_nod_aps(tjd, ipl, flag | f | Swe4r::SEFLG_SPEED, m)
+        xt = Swe4r::swe_nod_aps_times([tjd].pack('d*'), ipl, flag | f | Swe4r::SEFLG_SPEED, m).unpack('d*')
+        assert_equal(xarr[24 * i, 24], xt)
+        24.times do |k|
+          if k % 6 < 3
+            assert_equal(x[k], xt[k])
+          else
+            assert_in_delta(x[k], xt[k], 1e-5)
+          end
+        end
+      end
+    end
+    # heliocentric nodes lie on the ecliptic, 180 degrees apart up to light-time
+    xh = Swe4r::swe_nod_aps_arr(tjd, [Swe4r::SE_MARS], flag | Swe4r::SEFLG_HELCTR, method).unpack('d*')
+    assert_in_delta(0, xh[1], 1e-9)
+    assert_in_delta(180, (xh[6] - xh[0]) % 360, 1e-5)
+    # invalid bodies get zeros
+    assert_equal([0.0] * 24, Swe4r::swe_nod_aps_arr(tjd, [99999], flag, method).unpack('d*'))
+  end
+
+  def test_orbital_elements_arr
+    planets = (Swe4r::SE_MERCURY..Swe4r::SE_PLUTO).to_a + [Swe4r::SE_EARTH]
+    tjd = 2460000.5
+    flag = Swe4r::SEFLG_MOSEPH
+    elements = Swe4r::swe_get_orbital_elements_arr(tjd, planets + [Swe4r::SE_SUN], flag).unpack('d*')
+    assert_equal(17 * (planets.size + 1), elements.size)
+    assert_equal([0.0] * 17, elements[-17, 17])
+    dists = Swe4r::swe_orbit_max_min_true_distance_arr(tjd, planets, flag).unpack('d*')
+    helio = Swe4r::swe_orbit_max_min_true_distance_arr(tjd, planets, flag | Swe4r::SEFLG_HELCTR).unpack('d*')
+    planets.each_with_index do |ipl, i|
+      el = elements[17 * i, 17]
+      assert_equal(el, Swe4r::swe_get_orbital_elements_arr(tjd, [ipl], flag).unpack('d*'))
+      assert_in_delta(el[0] * (1 - el[1]), el[15], 1e-12)
+      assert_in_delta(el[0] * (1 + el[1]), el[16], 1e-12)
+      dmax, dmin, dtrue = helio[3 * i, 3]
+      assert_in_delta(el[16], dmax, 1e-12)
+      assert_in_delta(el[15], dmin, 1e-12)
+      assert_operator(dtrue, :<=, dmax)
+      assert_operator(dtrue, :>=, dmin)
+      next if ipl == Swe4r::SE_EARTH
+      dmax, dmin, dtrue = dists[3 * i, 3]
+      assert_operator(dtrue, :<=, dmax)
+      assert_operator(dtrue, :>=, dmin)
+      assert_in_delta(el[16] + elements[-34], dmax, 0.05)
+    end
+  end
+
+  def test_swe_pheno_ut
+    tjd = 2460000.5
+    flag = Swe4r::SEFLG_MOSEPH
+    attr = Swe4r::swe_pheno_ut(tjd, Swe4r::SE_VENUS, flag)
+    assert_equal(6, attr.size)
+    assert_in_delta((1 + Math.cos(attr[0] * Math::PI / 180)) / 2, attr[1], 1e-12)
+    assert_operator(attr[4], :<, -3.5)
+    moon = Swe4r::swe_pheno_ut(tjd, Swe4r::SE_MOON, flag)
+    assert_in_delta(0.95, moon[5], 0.1)
+    assert_raises(RuntimeError) { Swe4r::swe_pheno_ut(tjd, -5, flag) }
+    bodies = (Swe4r::SE_SUN..Swe4r::SE_PLUTO).to_a + [-5]
+    [flag, flag | Swe4r::SEFLG_TRUEPOS, flag | Swe4r::SEFLG_J2000].each do |fl|
+      attrs = Swe4r::swe_pheno_ut_arr(tjd, bodies, fl).unpack('d*')
+      assert_equal([0.0] * 6, attrs[-6, 6])
+      bodies[0...-1].each_with_index do |ipl, i|
+        expected = Swe4r::swe_pheno_ut(tjd, ipl, fl)
+        # phase angles may differ by < 0.1", see swe_pheno_arr()
+        expected.zip(attrs[6 * i, 6]).each { |a, b| assert_in_delta(a, b, 3e-5) }
+      end
+    end
+  end
+
+  def test_swe_gauquelin_sector
+    flag = Swe4r::SEFLG_MOSEPH
+    lon, lat = 2.35, 48.85
+    rise = Swe4r::swe_rise_trans(2460000.5, Swe4r::SE_SUN, flag, Swe4r::SE_CALC_RISE | Swe4r::SE_BIT_DISC_CENTER | Swe4r::SE_BIT_NO_REFRACTION, lon, lat, 0, 0, 0)
+    sector = Swe4r::swe_gauquelin_sector(rise + 0.01, Swe4r::SE_SUN, flag, 2, lon, lat, 0, 0, 0)
+    assert_operator(sector, :>, 1)
+    assert_operator(sector, :<, 1.5)
+    assert_raises(RuntimeError) { Swe4r::swe_gauquelin_sector(rise, Swe4r::SE_SUN, flag, 6, lon, lat, 0, 0, 0) }
+    # Paris, Sydney, and Tromso, where some bodies are circumpolar
+    dates = [2447000.5, 2451234.7, 2460000.3]
+    places = [[lon, lat, 35], [151.2, -33.9, 0], [18.96, 69.65, 10]]
+    bodies = (Swe4r::SE_SUN..Swe4r::SE_PLUTO).to_a
+    [0, 3, 4].each do |imeth|
+      sectors = Swe4r::swe_gauquelin_sector_arr(dates.pack('d*'), places.flatten.pack('d*'), bodies, flag, imeth, 1013.25, 15, 2).unpack('d*')
+      assert_equal(dates.size * bodies.size, sectors.size)
+      dates.each_with_index do |tjd, i|
+        bodies.each_with_index do |ipl, j|
+          expected = begin
+            Swe4r::swe_gauquelin_sector(tjd, ipl, flag, imeth, *places[i], 1013.25, 15)
+          rescue RuntimeError
+            0.0
+          end
+          assert_equal(expected, sectors[i * bodies.size + j])
+        end
+      end
+    end
+    assert_raises(ArgumentError) { Swe4r::swe_gauquelin_sector_arr(dates.pack('d*'), [1.0].pack('d*'), bodies, flag, 0, 0, 0, 1) }
+  end
+
   def test_swe_cotrans
     a,b,c = Swe4r::swe_cotrans( 90, 99, -8, 1)
     assert_equal 221.9365465392914, a